@@ -0,0 +1,425 @@
+#include "Core.hpp"
+#include "ComLynxWire.hpp"
+#include "CPUState.hpp"
+#include "InputFile.hpp"
+#include "ImageROM.hpp"
+#include "ImageProperties.hpp"
+#include "ScriptDebuggerEscapes.hpp"
+#include "HeadlessSinks.hpp"
+#include "Log.hpp"
+#include <cstdio>
+
+namespace
+{
+
+//Lynx tick clock
+static constexpr double TICKS_PER_SECOND = 16000000.0;
+static constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325ull;
+
+void usage()
+{
+  std::fputs( "usage: felix-batch [-threads N] [-seed N] [-sps N] [-bootrom path] [-cpu interpreter|coroutine] [-suzy batched|per-access] [-o result.json] jobs.txt\n"
+    "  jobs.txt has one job per line: image ticks [input.txt]\n"
+    "  input.txt has one line per change of pressed keys: frame keys, keys are letters of UDLRAB12P or - for none\n", stderr );
+}
+
+uint64_t fnv1a( uint64_t hash, void const* data, size_t size )
+{
+  auto bytes = (uint8_t const*)data;
+  for ( size_t i = 0; i < size; ++i )
+  {
+    hash = ( hash ^ bytes[i] ) * 0x100000001b3ull;
+  }
+  return hash;
+}
+
+std::string escape( std::string_view s )
+{
+  std::string result;
+  for ( char c : s )
+  {
+    if ( c == '"' || c == '\\' )
+      result += '\\';
+    if ( c == '\n' )
+      result += "\\n";
+    else if ( (unsigned char)c >= 0x20 )
+      result += c;
+  }
+  return result;
+}
+
+struct Job
+{
+  std::filesystem::path image;
+  uint64_t ticks;
+  std::filesystem::path input;
+};
+
+struct JobResult
+{
+  uint64_t ticks;
+  uint64_t frames;
+  double wall;
+  uint64_t ramHash;
+  uint64_t frameHash;
+  uint64_t audioHash;
+  std::string log;
+  std::string error;
+};
+
+//hashes every completed frame
+struct FrameHashSink : public NullVideoSink
+{
+  void newFrame() override
+  {
+    hash = fnv1a( hash, frame.data(), sizeof( frame ) );
+    NullVideoSink::newFrame();
+  }
+
+  uint64_t hash = FNV_OFFSET;
+};
+
+//replays keys pressed from given frame on
+class ScriptInputSource : public IInputSource
+{
+public:
+  struct Event
+  {
+    uint64_t frame;
+    KeyInput keys;
+  };
+
+  ScriptInputSource( std::vector<Event> events, NullVideoSink const& videoSink ) : mEvents{ std::move( events ) }, mVideoSink{ videoSink }
+  {
+  }
+
+  KeyInput getInput( bool leftHand ) const override
+  {
+    auto it = std::ranges::upper_bound( mEvents, mVideoSink.frames, {}, &Event::frame );
+    return it == mEvents.begin() ? KeyInput{} : std::prev( it )->keys;
+  }
+
+  static std::vector<Event> load( std::filesystem::path const& path )
+  {
+    std::ifstream fin{ path };
+    if ( !fin )
+      throw std::runtime_error{ "Can't read " + path.string() };
+
+    std::vector<Event> events;
+    std::string line;
+    while ( std::getline( fin, line ) )
+    {
+      std::istringstream ss{ line };
+      Event event{};
+      std::string keys;
+      if ( !( ss >> event.frame >> keys ) || keys.starts_with( '#' ) )
+        continue;
+
+      for ( char c : keys )
+      {
+        switch ( std::toupper( c ) )
+        {
+        case 'U': event.keys.set( KeyInput::UP, true ); break;
+        case 'D': event.keys.set( KeyInput::DOWN, true ); break;
+        case 'L': event.keys.set( KeyInput::LEFT, true ); break;
+        case 'R': event.keys.set( KeyInput::RIGHT, true ); break;
+        case 'A': event.keys.set( KeyInput::OUTER, true ); break;
+        case 'B': event.keys.set( KeyInput::INNER, true ); break;
+        case '1': event.keys.set( KeyInput::OPTION1, true ); break;
+        case '2': event.keys.set( KeyInput::OPTION2, true ); break;
+        case 'P': event.keys.set( KeyInput::PAUSE, true ); break;
+        case '-': break;
+        default:
+          throw std::runtime_error{ "Bad keys '" + keys + "' in " + path.string() };
+        }
+      }
+      events.push_back( event );
+    }
+
+    std::ranges::stable_sort( events, {}, &Event::frame );
+    return events;
+  }
+
+private:
+  std::vector<Event> mEvents;
+  NullVideoSink const& mVideoSink;
+};
+
+//workers take jobs from the front of their own queue and steal from the back of the others' when it runs dry
+class WorkStealingPool
+{
+public:
+  WorkStealingPool( size_t workers ) : mQueues( workers )
+  {
+  }
+
+  void run( size_t jobs, std::function<void( size_t )> const& fn )
+  {
+    for ( size_t i = 0; i < jobs; ++i )
+    {
+      mQueues[i % mQueues.size()].jobs.push_back( i );
+    }
+
+    std::vector<std::thread> threads;
+    for ( size_t worker = 0; worker < mQueues.size(); ++worker )
+    {
+      threads.emplace_back( [this, worker, &fn]
+      {
+        while ( auto job = take( worker ) )
+        {
+          fn( *job );
+        }
+      } );
+    }
+
+    for ( auto& thread : threads )
+    {
+      thread.join();
+    }
+  }
+
+private:
+  struct Queue
+  {
+    std::mutex mutex;
+    std::deque<size_t> jobs;
+  };
+
+  std::optional<size_t> take( size_t worker )
+  {
+    {
+      auto& own = mQueues[worker];
+      std::scoped_lock lock{ own.mutex };
+      if ( !own.jobs.empty() )
+      {
+        size_t job = own.jobs.front();
+        own.jobs.pop_front();
+        return job;
+      }
+    }
+
+    //no new jobs are added while running, so all queues found empty means done
+    for ( size_t i = 1; i < mQueues.size(); ++i )
+    {
+      auto& victim = mQueues[( worker + i ) % mQueues.size()];
+      std::scoped_lock lock{ victim.mutex };
+      if ( !victim.jobs.empty() )
+      {
+        size_t job = victim.jobs.back();
+        victim.jobs.pop_back();
+        return job;
+      }
+    }
+
+    return std::nullopt;
+  }
+
+  std::vector<Queue> mQueues;
+};
+
+std::vector<Job> loadJobs( std::filesystem::path const& path )
+{
+  std::ifstream fin{ path };
+  if ( !fin )
+    throw std::runtime_error{ "Can't read " + path.string() };
+
+  //paths are relative to the job list
+  auto base = std::filesystem::absolute( path ).parent_path();
+  std::vector<Job> jobs;
+  std::string line;
+  while ( std::getline( fin, line ) )
+  {
+    std::istringstream ss{ line };
+    std::string image;
+    Job job{};
+    if ( !( ss >> image ) || image.starts_with( '#' ) )
+      continue;
+    if ( !( ss >> job.ticks ) )
+      throw std::runtime_error{ "Missing tick budget for " + image };
+
+    job.image = base / image;
+    std::string input;
+    if ( ss >> input )
+      job.input = base / input;
+    jobs.push_back( std::move( job ) );
+  }
+  return jobs;
+}
+
+JobResult runJob( Job const& job, std::shared_ptr<ImageROM const> const& bootROM, uint32_t seed, int sps, CPUBackend cpuBackend, SuzyBackend suzyBackend )
+{
+  JobResult result{};
+
+  //log of each core is kept with its job instead of interleaving on the output
+  Log::ThreadSink sink{ [&]( Log::LogLevel, std::string const& message )
+  {
+    result.log += message;
+  } };
+
+  try
+  {
+    std::shared_ptr<ImageProperties> imageProperties;
+    InputFile inputFile{ job.image, imageProperties };
+    if ( !inputFile.valid() )
+      throw std::runtime_error{ "Unrecognized image " + job.image.string() };
+
+    auto videoSink = std::make_shared<FrameHashSink>();
+    std::shared_ptr<IInputSource> inputSource;
+    if ( job.input.empty() )
+      inputSource = std::make_shared<NullInputSource>();
+    else
+      inputSource = std::make_shared<ScriptInputSource>( ScriptInputSource::load( job.input ), *videoSink );
+
+    auto core = std::make_unique<Core>( *imageProperties, std::make_shared<ComLynxWire>(), videoSink, std::move( inputSource ), inputFile,
+      bootROM, std::make_shared<ScriptDebuggerEscapes>(), cpuBackend, suzyBackend );
+    //the same power on registers for every run of the job
+    core->debugState() = CPUState::reset( seed );
+
+    //roughly a frame worth of samples per call
+    std::vector<AudioSample> samples( sps / 75 + 1 );
+    result.audioHash = FNV_OFFSET;
+
+    auto start = std::chrono::steady_clock::now();
+    while ( core->tick() < job.ticks )
+    {
+      core->advanceAudio( sps, samples, RunMode::RUN );
+      result.audioHash = fnv1a( result.audioHash, samples.data(), samples.size() * sizeof( AudioSample ) );
+    }
+    result.wall = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+
+    result.ticks = core->tick();
+    result.frames = videoSink->frames;
+    result.ramHash = fnv1a( FNV_OFFSET, core->debugRAM(), 65536 );
+    result.frameHash = videoSink->hash;
+  }
+  catch ( std::exception const& ex )
+  {
+    result.error = ex.what();
+  }
+
+  return result;
+}
+
+void writeJSON( FILE* out, size_t threads, double wall, std::vector<Job> const& jobs, std::vector<JobResult> const& results )
+{
+  std::fprintf( out, "{\n  \"threads\": %zu,\n  \"wall\": %.6f,\n  \"jobs\": [\n", threads, wall );
+  for ( size_t i = 0; i < results.size(); ++i )
+  {
+    auto const& job = jobs[i];
+    auto const& r = results[i];
+
+    std::fprintf( out, "    {\n" );
+    std::fprintf( out, "      \"image\": \"%s\",\n", escape( job.image.string() ).c_str() );
+    std::fprintf( out, "      \"input\": \"%s\",\n", escape( job.input.string() ).c_str() );
+    if ( !r.error.empty() )
+      std::fprintf( out, "      \"error\": \"%s\",\n", escape( r.error ).c_str() );
+    std::fprintf( out, "      \"ticks\": %llu,\n", (unsigned long long)r.ticks );
+    std::fprintf( out, "      \"frames\": %llu,\n", (unsigned long long)r.frames );
+    std::fprintf( out, "      \"wall\": %.6f,\n", r.wall );
+    std::fprintf( out, "      \"ram\": \"%016llx\",\n", (unsigned long long)r.ramHash );
+    std::fprintf( out, "      \"video\": \"%016llx\",\n", (unsigned long long)r.frameHash );
+    std::fprintf( out, "      \"audio\": \"%016llx\",\n", (unsigned long long)r.audioHash );
+    std::fprintf( out, "      \"log\": \"%s\"\n", escape( r.log ).c_str() );
+    std::fprintf( out, "    }%s\n", i + 1 < results.size() ? "," : "" );
+  }
+  std::fprintf( out, "  ]\n}\n" );
+}
+
+}
+
+int main( int argc, char const* argv[] )
+{
+  size_t threads = std::max( 1u, std::thread::hardware_concurrency() );
+  uint32_t seed = 0;
+  int sps = 48000;
+  std::filesystem::path bootROMPath;
+  std::string_view cpu = "interpreter";
+  std::string_view suzy = "batched";
+  std::filesystem::path outPath;
+  std::filesystem::path jobsPath;
+
+  for ( int i = 1; i < argc; ++i )
+  {
+    std::string_view arg{ argv[i] };
+    if ( arg == "-threads" && i + 1 < argc )
+      threads = std::strtoull( argv[++i], nullptr, 10 );
+    else if ( arg == "-seed" && i + 1 < argc )
+      seed = (uint32_t)std::strtoul( argv[++i], nullptr, 10 );
+    else if ( arg == "-sps" && i + 1 < argc )
+      sps = std::atoi( argv[++i] );
+    else if ( arg == "-bootrom" && i + 1 < argc )
+      bootROMPath = argv[++i];
+    else if ( arg == "-cpu" && i + 1 < argc )
+      cpu = argv[++i];
+    else if ( arg == "-suzy" && i + 1 < argc )
+      suzy = argv[++i];
+    else if ( arg == "-o" && i + 1 < argc )
+      outPath = argv[++i];
+    else if ( !arg.starts_with( "-" ) && jobsPath.empty() )
+      jobsPath = arg;
+    else
+    {
+      usage();
+      return 1;
+    }
+  }
+
+  if ( jobsPath.empty() || threads == 0 || sps <= 0 || cpu != "interpreter" && cpu != "coroutine" || suzy != "batched" && suzy != "per-access" )
+  {
+    usage();
+    return 1;
+  }
+
+  CPUBackend cpuBackend = cpu == "interpreter" ? CPUBackend::INTERPRETER : CPUBackend::COROUTINE;
+  SuzyBackend suzyBackend = suzy == "batched" ? SuzyBackend::BATCHED : SuzyBackend::PER_ACCESS;
+
+  try
+  {
+    auto jobs = loadJobs( jobsPath );
+
+    std::shared_ptr<ImageROM const> bootROM;
+    if ( !bootROMPath.empty() )
+      bootROM = ImageROM::create( bootROMPath );
+
+    std::vector<JobResult> results( jobs.size() );
+    threads = std::min( threads, std::max<size_t>( 1, jobs.size() ) );
+    WorkStealingPool pool{ threads };
+
+    auto start = std::chrono::steady_clock::now();
+    pool.run( jobs.size(), [&]( size_t i )
+    {
+      results[i] = runJob( jobs[i], bootROM, seed, sps, cpuBackend, suzyBackend );
+    } );
+    std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+
+    FILE* out = stdout;
+    if ( !outPath.empty() )
+    {
+      out = std::fopen( outPath.string().c_str(), "w" );
+      if ( !out )
+        throw std::runtime_error{ "Can't open " + outPath.string() };
+    }
+
+    writeJSON( out, threads, wall.count(), jobs, results );
+
+    if ( out != stdout )
+      std::fclose( out );
+
+    uint64_t ticks = 0;
+    size_t failed = 0;
+    for ( auto const& r : results )
+    {
+      ticks += r.ticks;
+      failed += r.error.empty() ? 0 : 1;
+    }
+    std::fprintf( stderr, "%zu jobs on %zu threads in %.3f s, %.2fx realtime in total, %zu failed\n", jobs.size(), threads, wall.count(),
+      ticks / TICKS_PER_SECOND / wall.count(), failed );
+
+    return failed == 0 ? 0 : 2;
+  }
+  catch ( std::exception const& ex )
+  {
+    std::fprintf( stderr, "%s\n", ex.what() );
+    return 1;
+  }
+}
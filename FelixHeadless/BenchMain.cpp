@@ -0,0 +1,209 @@
+#include "Core.hpp"
+#include "ComLynxWire.hpp"
+#include "InputFile.hpp"
+#include "ImageProperties.hpp"
+#include "ScriptDebuggerEscapes.hpp"
+#include "Utility.hpp"
+#include "HeadlessSinks.hpp"
+#include "BenchWorkloads.hpp"
+#include "BenchQueue.hpp"
+#include <cstdio>
+
+namespace
+{
+
+static constexpr double TICKS_PER_SECOND = 16000000.0;
+
+struct Result
+{
+  std::string name;
+  uint64_t ticks;
+  uint64_t frames;
+  double wall;
+  Core::RunProfile profile;
+};
+
+void usage()
+{
+  std::fputs( "usage: felix-bench [-ticks N] [-sps N] [-cpu interpreter|coroutine] [-suzy batched|per-access] [-tag name] [-o result.json] [image ...]\n"
+    "       felix-bench -queue [-ticks N]\n", stderr );
+}
+
+std::unique_ptr<Core> createCore( std::string const& name, std::vector<uint8_t> data, std::shared_ptr<NullVideoSink> videoSink, CPUBackend cpuBackend, SuzyBackend suzyBackend )
+{
+  std::shared_ptr<ImageProperties> imageProperties;
+  InputFile inputFile{ name, std::move( data ), imageProperties };
+  if ( !inputFile.valid() )
+    throw std::runtime_error{ "Unrecognized image " + name };
+
+  return std::make_unique<Core>( *imageProperties, std::make_shared<ComLynxWire>(), std::move( videoSink ), std::make_shared<NullInputSource>(),
+    inputFile, std::shared_ptr<ImageROM const>{}, std::make_shared<ScriptDebuggerEscapes>(), cpuBackend, suzyBackend );
+}
+
+//runs workload twice: plain run for throughput and profiled run for the time split
+Result runWorkload( std::string const& name, std::vector<uint8_t> const& data, uint64_t ticks, int sps, CPUBackend cpuBackend, SuzyBackend suzyBackend )
+{
+  using clock = std::chrono::steady_clock;
+
+  std::vector<AudioSample> samples( sps / 75 + 1 );
+  Result result{ name };
+
+  {
+    auto videoSink = std::make_shared<NullVideoSink>();
+    auto core = createCore( name, data, videoSink, cpuBackend, suzyBackend );
+    auto start = clock::now();
+    while ( core->tick() < ticks )
+    {
+      core->advanceAudio( sps, samples, RunMode::RUN );
+    }
+    result.wall = std::chrono::duration<double>( clock::now() - start ).count();
+    result.ticks = core->tick();
+    result.frames = videoSink->frames;
+  }
+
+  {
+    auto core = createCore( name, data, std::make_shared<NullVideoSink>(), cpuBackend, suzyBackend );
+    core->enableRunProfile( true );
+    while ( core->tick() < ticks )
+    {
+      core->advanceAudio( sps, samples, RunMode::RUN );
+    }
+    result.profile = core->runProfile();
+  }
+
+  return result;
+}
+
+std::string escape( std::string_view str )
+{
+  std::string result;
+  for ( char c : str )
+  {
+    if ( c == '"' || c == '\\' )
+      result += '\\';
+    result += c;
+  }
+  return result;
+}
+
+void writeJSON( FILE* out, std::string_view tag, std::string_view cpu, std::string_view suzy, uint64_t ticks, std::vector<Result> const& results )
+{
+  std::fprintf( out, "{\n  \"tag\": \"%s\",\n  \"cpu\": \"%s\",\n  \"suzy\": \"%s\",\n  \"ticks\": %llu,\n  \"workloads\": [\n", escape( tag ).c_str(), escape( cpu ).c_str(), escape( suzy ).c_str(), (unsigned long long)ticks );
+  for ( size_t i = 0; i < results.size(); ++i )
+  {
+    auto const& r = results[i];
+    double mhz = r.ticks / r.wall / 1000000.0;
+    double total = (double)( r.profile.cpu + r.profile.suzy + r.profile.sequenced ).count();
+    auto share = [&]( std::chrono::nanoseconds ns )
+    {
+      return total > 0 ? ns.count() / total : 0.0;
+    };
+
+    std::fprintf( out, "    {\n" );
+    std::fprintf( out, "      \"name\": \"%s\",\n", escape( r.name ).c_str() );
+    std::fprintf( out, "      \"ticks\": %llu,\n", (unsigned long long)r.ticks );
+    std::fprintf( out, "      \"frames\": %llu,\n", (unsigned long long)r.frames );
+    std::fprintf( out, "      \"wall\": %.6f,\n", r.wall );
+    std::fprintf( out, "      \"mhz\": %.3f,\n", mhz );
+    std::fprintf( out, "      \"realtime\": %.3f,\n", r.ticks / TICKS_PER_SECOND / r.wall );
+    std::fprintf( out, "      \"split\": { \"cpu\": %.4f, \"suzy\": %.4f, \"sequenced\": %.4f }\n", share( r.profile.cpu ), share( r.profile.suzy ), share( r.profile.sequenced ) );
+    std::fprintf( out, "    }%s\n", i + 1 < results.size() ? "," : "" );
+  }
+  std::fprintf( out, "  ]\n}\n" );
+}
+
+}
+
+int main( int argc, char const* argv[] )
+{
+  //five emulated seconds
+  uint64_t ticks = 80000000;
+  int sps = 48000;
+  std::string tag;
+  std::string_view cpu = "interpreter";
+  std::string_view suzy = "batched";
+  bool queue = false;
+  std::filesystem::path outPath;
+  std::vector<std::filesystem::path> images;
+
+  for ( int i = 1; i < argc; ++i )
+  {
+    std::string_view arg{ argv[i] };
+    if ( arg == "-ticks" && i + 1 < argc )
+      ticks = std::strtoull( argv[++i], nullptr, 10 );
+    else if ( arg == "-sps" && i + 1 < argc )
+      sps = std::atoi( argv[++i] );
+    else if ( arg == "-queue" )
+      queue = true;
+    else if ( arg == "-cpu" && i + 1 < argc )
+      cpu = argv[++i];
+    else if ( arg == "-suzy" && i + 1 < argc )
+      suzy = argv[++i];
+    else if ( arg == "-tag" && i + 1 < argc )
+      tag = argv[++i];
+    else if ( arg == "-o" && i + 1 < argc )
+      outPath = argv[++i];
+    else if ( !arg.starts_with( "-" ) )
+      images.push_back( arg );
+    else
+    {
+      usage();
+      return 1;
+    }
+  }
+
+  if ( sps <= 0 || cpu != "interpreter" && cpu != "coroutine" || suzy != "batched" && suzy != "per-access" )
+  {
+    usage();
+    return 1;
+  }
+
+  if ( queue )
+  {
+    auto result = queueBenchmark( ticks );
+    std::printf( "{\n  \"queue\": {\n    \"ticks\": %llu,\n    \"actions\": %llu,\n    \"heap_ns\": %.2f,\n    \"slots_ns\": %.2f,\n    \"identical\": %s\n  }\n}\n",
+      (unsigned long long)ticks, (unsigned long long)result.actions, result.heapNs, result.slotsNs, result.identical ? "true" : "false" );
+    return result.identical ? 0 : 2;
+  }
+
+  CPUBackend cpuBackend = cpu == "interpreter" ? CPUBackend::INTERPRETER : CPUBackend::COROUTINE;
+  SuzyBackend suzyBackend = suzy == "batched" ? SuzyBackend::BATCHED : SuzyBackend::PER_ACCESS;
+
+  try
+  {
+    std::vector<Result> results;
+
+    for ( auto const& workload : builtinWorkloads() )
+    {
+      results.push_back( runWorkload( workload.name, { workload.image.begin(), workload.image.end() }, ticks, sps, cpuBackend, suzyBackend ) );
+    }
+
+    for ( auto const& image : images )
+    {
+      auto data = readFile( image );
+      if ( data.empty() )
+        throw std::runtime_error{ "Can't read " + image.string() };
+      results.push_back( runWorkload( image.filename().string(), data, ticks, sps, cpuBackend, suzyBackend ) );
+    }
+
+    FILE* out = stdout;
+    if ( !outPath.empty() )
+    {
+      out = std::fopen( outPath.string().c_str(), "w" );
+      if ( !out )
+        throw std::runtime_error{ "Can't open " + outPath.string() };
+    }
+
+    writeJSON( out, tag, cpu, suzy, ticks, results );
+
+    if ( out != stdout )
+      std::fclose( out );
+
+    return 0;
+  }
+  catch ( std::exception const& ex )
+  {
+    std::fprintf( stderr, "%s\n", ex.what() );
+    return 1;
+  }
+}
@@ -0,0 +1,165 @@
+#include "BenchQueue.hpp"
+#include "ActionQueue.hpp"
+
+namespace
+{
+
+//ActionQueue as it used to be: binary heap with erased and stale entries left in place
+class HeapQueue
+{
+public:
+  void push( SequencedAction action )
+  {
+    mHeap.push_back( action );
+    std::push_heap( mHeap.begin(), mHeap.end() );
+  }
+
+  SequencedAction pop()
+  {
+    std::pop_heap( mHeap.begin(), mHeap.end() );
+    auto result = mHeap.back();
+    mHeap.pop_back();
+    return result;
+  }
+
+  uint64_t headTick() const
+  {
+    return mHeap.front().getTick();
+  }
+
+  bool empty() const
+  {
+    return mHeap.empty();
+  }
+
+private:
+  std::vector<SequencedAction> mHeap;
+};
+
+struct SimTimer
+{
+  Action action;
+  uint64_t period;
+  uint64_t expected;
+};
+
+static constexpr uint64_t WRITE_TICKS = 16000000 / 48000;
+static constexpr uint64_t DMA_ITERATIONS = 10;
+static constexpr uint64_t DMA_TICKS = 20;
+
+//Timers armed like Mikey::fireTimer does it: hblank timer 0 starting a display DMA chain and raising IRQ, four audio timers and UART timer 4.
+//A periodic batch end stands for the CPU, every 16th one reprograms an audio timer as a register write would do it, which leaves a stale fire in the heap.
+template<typename Queue>
+uint64_t simulate( Queue & queue, uint64_t ticks, uint64_t & actions )
+{
+  std::array<SimTimer, 6> timers = { {
+    { Action::FIRE_TIMER0, 159 * 16 },
+    { Action::FIRE_TIMER4, 2 * 16 * 13 },
+    { Action::FIRE_TIMER8, 6 * 16 },
+    { Action::FIRE_TIMER9, 7 * 16 * 2 },
+    { Action::FIRE_TIMERA, 9 * 16 * 2 },
+    { Action::FIRE_TIMERB, 12 * 16 * 4 },
+  } };
+
+  std::array<int, 13> timerIndex{};
+  for ( size_t i = 0; i < timers.size(); ++i )
+  {
+    timerIndex[(int)timers[i].action - (int)Action::FIRE_TIMER0] = (int)i;
+  }
+
+  for ( auto & timer : timers )
+  {
+    timer.expected = timer.period;
+    queue.push( { timer.action, timer.expected } );
+  }
+  queue.push( { Action::BATCH_END, WRITE_TICKS } );
+
+  uint64_t checksum = 0;
+  uint64_t writes = 0;
+  uint64_t dmaIteration = 0;
+  uint32_t random = 1;
+
+  while ( !queue.empty() && queue.headTick() < ticks )
+  {
+    auto seqAction = queue.pop();
+    uint64_t tick = seqAction.getTick();
+    auto action = seqAction.getAction();
+
+    switch ( action )
+    {
+    case Action::DISPLAY_DMA:
+      if ( ++dmaIteration < DMA_ITERATIONS )
+        queue.push( { Action::DISPLAY_DMA, tick + DMA_TICKS } );
+      break;
+    case Action::ASSERT_IRQ:
+      //interrupt handler acknowledging it
+      queue.push( { Action::DESERT_IRQ, tick + 200 } );
+      break;
+    case Action::DESERT_IRQ:
+      break;
+    case Action::BATCH_END:
+      queue.push( { Action::BATCH_END, tick + WRITE_TICKS } );
+      if ( ++writes % 16 == 0 )
+      {
+        random = random * 1664525 + 1013904223;
+        auto & timer = timers[2 + ( random >> 16 ) % 4];
+        timer.period = ( 1 + ( random >> 8 ) % 32 ) * 16;
+        timer.expected = tick + timer.period;
+        queue.push( { timer.action, timer.expected } );
+      }
+      break;
+    default:
+    {
+      auto timer = &timers[timerIndex[(int)action - (int)Action::FIRE_TIMER0]];
+      //stale fire of reprogrammed timer is ignored by TimerCore
+      if ( tick != timer->expected )
+        continue;
+      timer->expected = tick + timer->period;
+      queue.push( { action, timer->expected } );
+      if ( action == Action::FIRE_TIMER0 )
+      {
+        dmaIteration = 0;
+        queue.push( { Action::DISPLAY_DMA, tick + 100 } );
+        queue.push( { Action::ASSERT_IRQ, tick } );
+      }
+      break;
+    }
+    }
+
+    actions += 1;
+    checksum = checksum * 31 + seqAction.getTick() * 256 + (uint64_t)action;
+  }
+
+  return checksum;
+}
+
+template<typename Queue>
+double measure( uint64_t ticks, uint64_t & checksum, uint64_t & actions )
+{
+  using clock = std::chrono::steady_clock;
+
+  //best of few runs
+  double best = std::numeric_limits<double>::max();
+  for ( int i = 0; i < 5; ++i )
+  {
+    Queue queue{};
+    actions = 0;
+    auto start = clock::now();
+    checksum = simulate( queue, ticks, actions );
+    std::chrono::duration<double, std::nano> wall = clock::now() - start;
+    best = std::min( best, wall.count() / std::max<uint64_t>( 1, actions ) );
+  }
+  return best;
+}
+
+}
+
+QueueBenchResult queueBenchmark( uint64_t ticks )
+{
+  QueueBenchResult result{};
+  uint64_t heapChecksum, heapActions, slotsChecksum;
+  result.heapNs = measure<HeapQueue>( ticks, heapChecksum, heapActions );
+  result.slotsNs = measure<ActionQueue>( ticks, slotsChecksum, result.actions );
+  result.identical = heapChecksum == slotsChecksum && heapActions == result.actions;
+  return result;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+struct QueueBenchResult
+{
+  uint64_t actions;
+  //wall time per executed action
+  double heapNs;
+  double slotsNs;
+  bool identical;
+};
+
+//replays the action queue traffic of free running Mikey timers on ActionQueue and on the binary heap it replaced
+QueueBenchResult queueBenchmark( uint64_t ticks );
@@ -0,0 +1,194 @@
+#include "BenchWorkloads.hpp"
+
+namespace
+{
+
+//Workloads are hand assembled BS93 images loaded at $0200.
+//Display and timers are set up by BS93 loader (initMikeyRegisters).
+
+//tight CPU loop with indexed RAM accesses and a subroutine call
+static constexpr std::array<uint8_t, 43> gCpuLoop = {
+  0x80, 0x08, 0x02, 0x00, 0x00, 0x2b, 0x42, 0x53, 0x39, 0x33, //BS93 header
+  0xa2, 0x00,             //0200 start: LDX #$00
+  0xbd, 0x00, 0x10,       //0202 loop: LDA $1000,X
+  0x18,                   //0205 CLC
+  0x69, 0x03,             //0206 ADC #$03
+  0x9d, 0x00, 0x10,       //0208 STA $1000,X
+  0x45, 0x80,             //020b EOR $80
+  0x85, 0x80,             //020d STA $80
+  0x20, 0x19, 0x02,       //020f JSR sub
+  0xe8,                   //0212 INX
+  0xd0, 0xed,             //0213 BNE loop
+  0xe6, 0x81,             //0215 INC $81
+  0x80, 0xe7,             //0217 BRA start
+  0xa0, 0x04,             //0219 sub: LDY #$04
+  0x26, 0x82,             //021b sloop: ROL $82
+  0x88,                   //021d DEY
+  0xd0, 0xfb,             //021e BNE sloop
+  0x60,                   //0220 RTS
+};
+
+//five 4bpp literal sprites, background one covering whole screen, with collisions, redrawn back to back
+static constexpr std::array<uint8_t, 354> gSpriteScene = {
+  0x80, 0x08, 0x02, 0x00, 0x01, 0x62, 0x42, 0x53, 0x39, 0x33, //BS93 header
+  0xa9, 0x01,             //0200 LDA #$01
+  0x8d, 0x90, 0xfc,       //0202 STA $FC90 ;SUZYBUSEN
+  0x9c, 0x08, 0xfc,       //0205 STZ $FC08
+  0xa9, 0x20,             //0208 LDA #$20
+  0x8d, 0x09, 0xfc,       //020a STA $FC09 ;VIDBAS = $2000
+  0x9c, 0x0a, 0xfc,       //020d STZ $FC0A
+  0xa9, 0x60,             //0210 LDA #$60
+  0x8d, 0x0b, 0xfc,       //0212 STA $FC0B ;COLLBAS = $6000
+  0x9c, 0x04, 0xfc,       //0215 STZ $FC04
+  0x9c, 0x05, 0xfc,       //0218 STZ $FC05
+  0x9c, 0x06, 0xfc,       //021b STZ $FC06
+  0x9c, 0x07, 0xfc,       //021e STZ $FC07 ;HOFF = VOFF = 0
+  0xa9, 0x17,             //0221 LDA #$17
+  0x8d, 0x24, 0xfc,       //0223 STA $FC24
+  0x9c, 0x25, 0xfc,       //0226 STZ $FC25 ;COLLOFF = 23
+  0x9c, 0x92, 0xfc,       //0229 STZ $FC92 ;SPRSYS
+  0xa9, 0x4f,             //022c frame: LDA #<scb0
+  0x8d, 0x10, 0xfc,       //022e STA $FC10
+  0xa9, 0x02,             //0231 LDA #>scb0
+  0x8d, 0x11, 0xfc,       //0233 STA $FC11 ;SCBNEXT
+  0xa9, 0x01,             //0236 LDA #$01
+  0x8d, 0x91, 0xfc,       //0238 STA $FC91 ;SPRGO
+  0x9c, 0x91, 0xfd,       //023b STZ $FD91 ;CPUSLEEP
+  0x9c, 0x90, 0xfd,       //023e STZ $FD90 ;SDONEACK
+  0xee, 0x6e, 0x02,       //0241 INC scb1+7
+  0xce, 0x88, 0x02,       //0244 DEC scb2+9
+  0xee, 0x9e, 0x02,       //0247 INC scb3+7
+  0xee, 0xb8, 0x02,       //024a INC scb4+9
+  0x80, 0xdd,             //024d BRA frame
+  //024f scb0
+  0xc0, 0x10, 0x00, 0x67, 0x02, 0xc7, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x07,
+  0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef, 0x00,
+  //0267 scb1
+  0xc4, 0x10, 0x00, 0x7f, 0x02, 0xc7, 0x02, 0x14, 0x00, 0x0a, 0x00, 0x00, 0x03, 0x00, 0x03,
+  0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef, 0x00,
+  //027f scb2
+  0xc4, 0x10, 0x00, 0x97, 0x02, 0xc7, 0x02, 0x50, 0x00, 0x28, 0x00, 0x00, 0x03, 0x00, 0x03,
+  0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef, 0x00,
+  //0297 scb3
+  0xc7, 0x10, 0x00, 0xaf, 0x02, 0xc7, 0x02, 0x28, 0x00, 0x14, 0x00, 0x00, 0x02, 0x00, 0x04,
+  0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef, 0x00,
+  //02af scb4
+  0xc6, 0x10, 0x00, 0x00, 0x00, 0xc7, 0x02, 0x64, 0x00, 0x32, 0x00, 0x00, 0x04, 0x00, 0x02,
+  0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef, 0x00,
+  //02c7 data
+  0x09, 0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef,
+  0x09, 0x12, 0x34, 0x56, 0x78, 0x9a, 0xbc, 0xde, 0xf0,
+  0x09, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef, 0x01,
+  0x09, 0x34, 0x56, 0x78, 0x9a, 0xbc, 0xde, 0xf0, 0x12,
+  0x09, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef, 0x01, 0x23,
+  0x09, 0x56, 0x78, 0x9a, 0xbc, 0xde, 0xf0, 0x12, 0x34,
+  0x09, 0x67, 0x89, 0xab, 0xcd, 0xef, 0x01, 0x23, 0x45,
+  0x09, 0x78, 0x9a, 0xbc, 0xde, 0xf0, 0x12, 0x34, 0x56,
+  0x09, 0x89, 0xab, 0xcd, 0xef, 0x01, 0x23, 0x45, 0x67,
+  0x09, 0x9a, 0xbc, 0xde, 0xf0, 0x12, 0x34, 0x56, 0x78,
+  0x09, 0xab, 0xcd, 0xef, 0x01, 0x23, 0x45, 0x67, 0x89,
+  0x09, 0xbc, 0xde, 0xf0, 0x12, 0x34, 0x56, 0x78, 0x9a,
+  0x09, 0xcd, 0xef, 0x01, 0x23, 0x45, 0x67, 0x89, 0xab,
+  0x09, 0xde, 0xf0, 0x12, 0x34, 0x56, 0x78, 0x9a, 0xbc,
+  0x09, 0xef, 0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd,
+  0x09, 0xf0, 0x12, 0x34, 0x56, 0x78, 0x9a, 0xbc, 0xde,
+  0x00,                   //0357 .byte $00
+};
+
+//four LFSR audio channels clocked at 1us and timer 1 interrupt every 64us
+static constexpr std::array<uint8_t, 103> gAudioTune = {
+  0x80, 0x08, 0x02, 0x00, 0x00, 0x67, 0x42, 0x53, 0x39, 0x33, //BS93 header
+  0x78,                   //0200 SEI
+  0xa9, 0x53,             //0201 LDA #<isr
+  0x8d, 0xfe, 0xff,       //0203 STA $FFFE
+  0xa9, 0x02,             //0206 LDA #>isr
+  0x8d, 0xff, 0xff,       //0208 STA $FFFF ;IRQ vector
+  0xa2, 0x00,             //020b LDX #$00
+  0xa9, 0x30,             //020d chan: LDA #$30
+  0x9d, 0x20, 0xfd,       //020f STA $FD20,X ;VOLCNTRL
+  0xa9, 0xb5,             //0212 LDA #$b5
+  0x9d, 0x21, 0xfd,       //0214 STA $FD21,X ;FEEDBACK
+  0x9e, 0x22, 0xfd,       //0217 STZ $FD22,X ;OUTPUT
+  0xa9, 0x01,             //021a LDA #$01
+  0x9d, 0x23, 0xfd,       //021c STA $FD23,X ;SHIFT
+  0x8a,                   //021f TXA
+  0x4a,                   //0220 LSR
+  0x69, 0x05,             //0221 ADC #$05
+  0x9d, 0x24, 0xfd,       //0223 STA $FD24,X ;BACKUP
+  0xa9, 0x18,             //0226 LDA #$18
+  0x9d, 0x25, 0xfd,       //0228 STA $FD25,X ;CONTROL: reload, count, 1us
+  0x9e, 0x27, 0xfd,       //022b STZ $FD27,X ;OTHER
+  0x8a,                   //022e TXA
+  0x18,                   //022f CLC
+  0x69, 0x08,             //0230 ADC #$08
+  0xaa,                   //0232 TAX
+  0xe0, 0x20,             //0233 CPX #$20
+  0xd0, 0xd6,             //0235 BNE chan
+  0xa9, 0x38,             //0237 LDA #$38
+  0x8d, 0x3d, 0xfd,       //0239 STA $FD3D ;channel 3 integrate mode
+  0xa9, 0x1f,             //023c LDA #$1f
+  0x8d, 0x04, 0xfd,       //023e STA $FD04 ;TIM1BKUP
+  0xa9, 0x99,             //0241 LDA #$99
+  0x8d, 0x05, 0xfd,       //0243 STA $FD05 ;TIM1CTLA: irq, reload, count, 2us
+  0x58,                   //0246 CLI
+  0xee, 0x20, 0xfd,       //0247 loop: INC $FD20 ;modulate channel 0 volume
+  0xa5, 0x80,             //024a LDA $80
+  0x8d, 0x28, 0xfd,       //024c STA $FD28 ;channel 1 volume
+  0xe6, 0x80,             //024f INC $80
+  0x80, 0xf4,             //0251 BRA loop
+  0x48,                   //0253 isr: PHA
+  0xa9, 0x02,             //0254 LDA #$02
+  0x8d, 0x80, 0xfd,       //0256 STA $FD80 ;INTRST timer 1
+  0xe6, 0x81,             //0259 INC $81
+  0x68,                   //025b PLA
+  0x40,                   //025c RTI
+};
+
+//audio 3 runs alone for a while, then timer 0 is linked to it and its count is polled
+static constexpr std::array<uint8_t, 80> gAudioLink = {
+  0x80, 0x08, 0x02, 0x00, 0x00, 0x50, 0x42, 0x53, 0x39, 0x33, //BS93 header
+  0xa9, 0x30,             //0200 LDA #$30
+  0x8d, 0x38, 0xfd,       //0202 STA $FD38 ;channel 3 VOLCNTRL
+  0xa9, 0xb5,             //0205 LDA #$b5
+  0x8d, 0x39, 0xfd,       //0207 STA $FD39 ;FEEDBACK
+  0xa9, 0x01,             //020a LDA #$01
+  0x8d, 0x3b, 0xfd,       //020c STA $FD3B ;SHIFT
+  0xa9, 0x03,             //020f LDA #$03
+  0x8d, 0x3c, 0xfd,       //0211 STA $FD3C ;BACKUP: 4us
+  0xa9, 0x18,             //0214 LDA #$18
+  0x8d, 0x3d, 0xfd,       //0216 STA $FD3D ;CONTROL: reload, count, 1us
+  0xa2, 0x00,             //0219 LDX #$00
+  0xad, 0x02, 0xfd,       //021b wait: LDA $FD02 ;TIM0CNT while audio 3 borrows into nothing
+  0x9d, 0x00, 0x10,       //021e STA $1000,X
+  0xa0, 0x00,             //0221 LDY #$00
+  0x88,                   //0223 delay: DEY
+  0xd0, 0xfd,             //0224 BNE delay
+  0xe8,                   //0226 INX
+  0xd0, 0xf2,             //0227 BNE wait
+  0xa9, 0x27,             //0229 LDA #$27
+  0x8d, 0x00, 0xfd,       //022b STA $FD00 ;TIM0BKUP: 160us lines
+  0xa9, 0x1f,             //022e LDA #$1f
+  0x8d, 0x01, 0xfd,       //0230 STA $FD01 ;TIM0CTLA: reload, count, linked to audio 3
+  0xad, 0x02, 0xfd,       //0233 poll: LDA $FD02 ;TIM0CNT
+  0x9d, 0x00, 0x11,       //0236 STA $1100,X
+  0xad, 0x03, 0xfd,       //0239 LDA $FD03 ;TIM0CTLB
+  0x9d, 0x00, 0x12,       //023c STA $1200,X
+  0xe8,                   //023f INX
+  0xd0, 0xf1,             //0240 BNE poll
+  0xe6, 0x81,             //0242 INC $81
+  0x80, 0xed,             //0244 BRA poll
+};
+
+static constexpr std::array<BenchWorkload, 4> gWorkloads = { {
+  { "cpu-loop", gCpuLoop },
+  { "sprite-scene", gSpriteScene },
+  { "audio-tune", gAudioTune },
+  { "audio-link", gAudioLink },
+} };
+
+}
+
+std::span<BenchWorkload const> builtinWorkloads()
+{
+  return gWorkloads;
+}
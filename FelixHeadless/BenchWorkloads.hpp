@@ -0,0 +1,9 @@
+#pragma once
+
+struct BenchWorkload
+{
+  char const* name;
+  std::span<uint8_t const> image;
+};
+
+std::span<BenchWorkload const> builtinWorkloads();
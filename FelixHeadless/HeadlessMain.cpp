@@ -0,0 +1,637 @@
+#include "Core.hpp"
+#include "ComLynxWire.hpp"
+#include "ComLynxSocket.hpp"
+#include "CPUState.hpp"
+#include "InputFile.hpp"
+#include "ImageROM.hpp"
+#include "ImageProperties.hpp"
+#include "ScriptDebuggerEscapes.hpp"
+#include "HeadlessSinks.hpp"
+#include "BenchWorkloads.hpp"
+#include "RewindBuffer.hpp"
+#include "AudioRing.hpp"
+#include "CPU.hpp"
+#include "CodeProfiler.hpp"
+#include "SymbolSource.hpp"
+#include <cstdio>
+
+namespace
+{
+
+//Lynx tick clock
+static constexpr double TICKS_PER_SECOND = 16000000.0;
+static constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325ull;
+
+void usage()
+{
+  std::fputs( "usage: felix-headless [-frames N] [-bootrom path] [-sps N] [-cpu interpreter|coroutine] [-cpu-check N] [-suzy batched|per-access] [-suzy-check N] [-lazy-check N] [-video rgba|indexed] [-audio step|blep] [-turbo interval] [-turbo-check N] [-ring-check N] [-state-check N] [-rewind-check budgetKB] [-log trace.txt] [-trace trace.bin] [-profile name] [-labels file.lab] [-comlynx socket] [-comlynx-host socket nodes] [-comlynx-latency ticks] [-comlynx-check N] [-comlynx-consoles N] image.(lnx|lyx|o)\n", stderr );
+}
+
+uint64_t fnv1a( uint64_t hash, void const* data, size_t size )
+{
+  auto bytes = (uint8_t const*)data;
+  for ( size_t i = 0; i < size; ++i )
+  {
+    hash = ( hash ^ bytes[i] ) * 0x100000001b3ull;
+  }
+  return hash;
+}
+
+//runs until the frame counter reaches given value and returns a hash of everything the machine produced on the way
+uint64_t runFrames( Core & core, NullVideoSink & videoSink, std::span<AudioSample> samples, int sps, uint64_t frames )
+{
+  uint64_t hash = FNV_OFFSET;
+  while ( videoSink.frames < frames )
+  {
+    core.advanceAudio( sps, samples, RunMode::RUN );
+    hash = fnv1a( hash, samples.data(), samples.size_bytes() );
+  }
+  hash = fnv1a( hash, core.debugRAM(), 65536 );
+  videoSink.expand();
+  return fnv1a( hash, videoSink.frame.data(), sizeof( videoSink.frame ) );
+}
+
+//saves state, runs some frames, restores the state and checks that the same frames are produced again
+int stateCheck( Core & core, NullVideoSink & videoSink, std::span<AudioSample> samples, int sps, uint64_t frames )
+{
+  using clock = std::chrono::steady_clock;
+
+  while ( !core.canSaveState() )
+  {
+    core.advanceAudio( sps, samples, RunMode::RUN );
+  }
+
+  std::vector<uint8_t> state( core.stateSize() );
+  auto saveStart = clock::now();
+  bool saved = core.saveState( state );
+  std::chrono::duration<double, std::micro> saveTime = clock::now() - saveStart;
+  if ( !saved )
+  {
+    std::fputs( "state: save failed\n", stderr );
+    return 2;
+  }
+
+  uint64_t savedFrames = videoSink.frames;
+  uint64_t expected = runFrames( core, videoSink, samples, sps, savedFrames + frames );
+
+  auto loadStart = clock::now();
+  bool loaded = core.loadState( state );
+  std::chrono::duration<double, std::micro> loadTime = clock::now() - loadStart;
+  if ( !loaded )
+  {
+    std::fputs( "state: load failed\n", stderr );
+    return 2;
+  }
+
+  videoSink.frames = savedFrames;
+  uint64_t replayed = runFrames( core, videoSink, samples, sps, savedFrames + frames );
+
+  std::printf( "state: %zu bytes, save %.1f us, load %.1f us\n", state.size(), saveTime.count(), loadTime.count() );
+  std::printf( "state replay of %llu frames: %s\n", (unsigned long long)frames, expected == replayed ? "identical" : "MISMATCH" );
+  return expected == replayed ? 0 : 2;
+}
+
+//starts reference and fast backend from the same state and checks that they produce the same frames, samples, memory and tick count
+int backendCheck( char const* unit, char const* referenceName, Core & reference, NullVideoSink & referenceSink, char const* fastName, Core & fast, NullVideoSink & fastSink,
+  std::span<AudioSample> samples, int sps, uint64_t frames )
+{
+  std::vector<uint8_t> state( reference.stateSize() );
+  if ( !reference.saveState( state ) || !fast.loadState( state ) )
+  {
+    std::fprintf( stderr, "%s: state transfer failed\n", unit );
+    return 2;
+  }
+
+  using clock = std::chrono::steady_clock;
+  auto start = clock::now();
+  uint64_t expected = runFrames( reference, referenceSink, samples, sps, frames );
+  std::chrono::duration<double> referenceWall = clock::now() - start;
+  start = clock::now();
+  uint64_t actual = runFrames( fast, fastSink, samples, sps, frames );
+  std::chrono::duration<double> fastWall = clock::now() - start;
+
+  bool identical = expected == actual && reference.tick() == fast.tick();
+  std::printf( "%s backends: %s %.3f s, %s %.3f s (%.2fx)\n", unit, referenceName, referenceWall.count(), fastName, fastWall.count(), referenceWall / fastWall );
+  std::printf( "%s backends over %llu frames: %s\n", unit, (unsigned long long)frames, identical ? "identical" : "MISMATCH" );
+  return identical ? 0 : 2;
+}
+
+//the same as runFrames, but emulation runs in its own thread producing samples into a ring drained by this thread
+uint64_t runFramesThreaded( Core & core, NullVideoSink & videoSink, std::span<AudioSample> samples, int sps, uint64_t frames, AudioRing & ring )
+{
+  std::atomic_bool done{};
+  std::thread emulation{ [&]
+  {
+    while ( videoSink.frames < frames )
+    {
+      core.advanceAudio( sps, samples, RunMode::RUN );
+      for ( size_t pushed = 0; pushed < samples.size(); )
+      {
+        if ( size_t count = ring.push( samples.subspan( pushed ) ) )
+          pushed += count;
+        else
+          std::this_thread::yield();
+      }
+    }
+    done.store( true );
+  } };
+
+  uint64_t hash = FNV_OFFSET;
+  std::vector<AudioSample> drained( ring.capacity() );
+  for ( ;; )
+  {
+    //done has to be read before the ring is found empty for the last time
+    bool finished = done.load();
+    if ( size_t count = ring.pop( drained ) )
+      hash = fnv1a( hash, drained.data(), count * sizeof( AudioSample ) );
+    else if ( finished )
+      break;
+    else
+      std::this_thread::yield();
+  }
+  emulation.join();
+
+  hash = fnv1a( hash, core.debugRAM(), 65536 );
+  videoSink.expand();
+  return fnv1a( hash, videoSink.frame.data(), sizeof( videoSink.frame ) );
+}
+
+//runs frames directly and then again from the same state on an emulation thread feeding an audio ring
+int ringCheck( Core & core, NullVideoSink & videoSink, std::span<AudioSample> samples, int sps, uint64_t frames )
+{
+  while ( !core.canSaveState() )
+  {
+    core.advanceAudio( sps, samples, RunMode::RUN );
+  }
+
+  std::vector<uint8_t> state( core.stateSize() );
+  if ( !core.saveState( state ) )
+  {
+    std::fputs( "ring: save failed\n", stderr );
+    return 2;
+  }
+
+  using clock = std::chrono::steady_clock;
+  uint64_t savedFrames = videoSink.frames;
+  auto start = clock::now();
+  uint64_t expected = runFrames( core, videoSink, samples, sps, savedFrames + frames );
+  std::chrono::duration<double> directWall = clock::now() - start;
+
+  core.loadState( state );
+  videoSink.frames = savedFrames;
+  //a quarter of the samples of one call fit into the ring, so both threads have to wait for each other
+  AudioRing ring{ samples.size() / 4 };
+  start = clock::now();
+  uint64_t threaded = runFramesThreaded( core, videoSink, samples, sps, savedFrames + frames, ring );
+  std::chrono::duration<double> threadedWall = clock::now() - start;
+
+  std::printf( "ring: direct %.3f s, emulation thread %.3f s\n", directWall.count(), threadedWall.count() );
+  std::printf( "ring over %llu frames: %s\n", (unsigned long long)frames, expected == threaded ? "identical" : "MISMATCH" );
+  return expected == threaded ? 0 : 2;
+}
+
+//runs frames normally and then again from the same state in turbo mode, both have to end at the same tick with the same memory
+//and produce the same output after switching back to normal mode
+int turboCheck( Core & core, NullVideoSink & videoSink, std::span<AudioSample> samples, int sps, uint64_t frames, uint32_t interval )
+{
+  while ( !core.canSaveState() )
+  {
+    core.advanceAudio( sps, samples, RunMode::RUN );
+  }
+
+  std::vector<uint8_t> state( core.stateSize() );
+  if ( !core.saveState( state ) )
+  {
+    std::fputs( "turbo: save failed\n", stderr );
+    return 2;
+  }
+
+  using clock = std::chrono::steady_clock;
+  uint64_t savedFrames = videoSink.frames;
+  struct Pass
+  {
+    std::chrono::duration<double> wall;
+    uint64_t startTick;
+    uint64_t tick;
+    uint64_t ram;
+    uint64_t after;
+  };
+
+  auto run = [&]( uint32_t turbo )
+  {
+    Pass pass;
+    core.loadState( state );
+    videoSink.frames = savedFrames;
+    core.enableTurbo( turbo );
+    pass.startTick = core.tick();
+    auto start = clock::now();
+    while ( videoSink.frames < savedFrames + frames )
+    {
+      core.advanceAudio( sps, samples, RunMode::RUN );
+    }
+    pass.wall = clock::now() - start;
+    pass.tick = core.tick();
+    pass.ram = fnv1a( FNV_OFFSET, core.debugRAM(), 65536 );
+    core.enableTurbo( 0 );
+    //band limited audio starts from the plain output level after turbo, the first batch is left out
+    core.advanceAudio( sps, samples, RunMode::RUN );
+    pass.after = runFrames( core, videoSink, samples, sps, videoSink.frames + 2 );
+    return pass;
+  };
+
+  Pass normal = run( 0 );
+  Pass turbo = run( interval );
+
+  bool identical = normal.tick == turbo.tick && normal.ram == turbo.ram && normal.after == turbo.after;
+  double emulated = ( turbo.tick - turbo.startTick ) / TICKS_PER_SECOND;
+  std::printf( "turbo: normal %.3f s, turbo %.3f s (%.2fx), %.2fx realtime\n", normal.wall.count(), turbo.wall.count(), normal.wall / turbo.wall,
+    emulated / turbo.wall.count() );
+  std::printf( "turbo over %llu frames: %s\n", (unsigned long long)frames, identical ? "identical" : "MISMATCH" );
+  return identical ? 0 : 2;
+}
+
+//runs consoles linked through loopback ComLynx each on its own thread once taking turns and once in parallel,
+//lockstep has to make the output independent of how the threads are scheduled
+int comLynxCheck( std::function<std::unique_ptr<Core>( std::shared_ptr<NullVideoSink> )> const& createCore, int sps, uint64_t frames, uint64_t latency, int consoles )
+{
+  using clock = std::chrono::steady_clock;
+
+  auto pass = [&]( bool serial, std::chrono::duration<double> & wall )
+  {
+    auto links = ComLynxLoopback::create( consoles, latency, serial );
+    std::vector<uint64_t> hashes( consoles );
+    std::vector<std::thread> threads;
+    auto start = clock::now();
+    for ( size_t i = 0; i < links.size(); ++i )
+    {
+      threads.emplace_back( [&, i]
+      {
+        auto videoSink = std::make_shared<NullVideoSink>();
+        auto core = createCore( videoSink );
+        core->debugState() = CPUState::reset( (uint32_t)i );
+        core->linkComLynx( links[i] );
+        std::vector<AudioSample> samples( sps / 75 + 1 );
+        hashes[i] = runFrames( *core, *videoSink, samples, sps, frames );
+        //lets the other nodes run on alone
+        core->linkComLynx( nullptr );
+        links[i].reset();
+      } );
+    }
+    for ( auto& thread : threads )
+    {
+      thread.join();
+    }
+    wall = clock::now() - start;
+    return hashes;
+  };
+
+  std::chrono::duration<double> serialWall, parallelWall;
+  auto serial = pass( true, serialWall );
+  auto parallel = pass( false, parallelWall );
+
+  for ( size_t i = 0; i < parallel.size(); ++i )
+  {
+    std::printf( "comlynx console %zu: serial %016llx, parallel %016llx\n", i, (unsigned long long)serial[i], (unsigned long long)parallel[i] );
+  }
+  std::printf( "comlynx %d consoles: serial %.3f s, parallel %.3f s (%.2fx)\n", consoles, serialWall.count(), parallelWall.count(), serialWall.count() / parallelWall.count() );
+  std::printf( "comlynx over %llu frames: %s\n", (unsigned long long)frames, serial == parallel ? "identical" : "MISMATCH" );
+  return serial == parallel ? 0 : 2;
+}
+
+//captures a state on every frame like Core does for rewind and checks that all kept states come back in reverse order
+int rewindCheck( Core & core, NullVideoSink & videoSink, std::span<AudioSample> samples, int sps, uint64_t frames, size_t budget )
+{
+  using clock = std::chrono::steady_clock;
+
+  RewindBuffer rewindBuffer{ budget };
+  std::vector<uint64_t> hashes;
+  clock::duration captureTime{};
+  clock::duration maxCaptureTime{};
+  uint64_t lastFrame = videoSink.frames;
+  uint64_t endFrame = videoSink.frames + frames;
+
+  uint64_t startTick = core.tick();
+  while ( videoSink.frames < endFrame )
+  {
+    core.advanceAudio( sps, samples, RunMode::RUN );
+    if ( videoSink.frames != lastFrame && core.canSaveState() )
+    {
+      lastFrame = videoSink.frames;
+      auto captureStart = clock::now();
+      auto state = rewindBuffer.stage( core.stateSize() );
+      core.saveState( state );
+      auto duration = clock::now() - captureStart;
+      hashes.push_back( fnv1a( FNV_OFFSET, state.data(), state.size() ) );
+      captureStart = clock::now();
+      rewindBuffer.push();
+      duration += clock::now() - captureStart;
+      captureTime += duration;
+      maxCaptureTime = std::max( maxCaptureTime, duration );
+    }
+  }
+  std::chrono::duration<double> emulated{ ( core.tick() - startTick ) / TICKS_PER_SECOND };
+
+  if ( hashes.empty() )
+  {
+    std::fputs( "rewind: no state captured\n", stderr );
+    return 2;
+  }
+
+  size_t depth = rewindBuffer.size();
+  bool identical = true;
+  std::span<uint8_t const> state;
+  for ( size_t i = 0; i < depth; ++i )
+  {
+    state = rewindBuffer.pop();
+    identical &= fnv1a( FNV_OFFSET, state.data(), state.size() ) == hashes[hashes.size() - 1 - i];
+  }
+  identical &= core.loadState( state );
+
+  //the same through Core, each rewind drops two states
+  core.enableRewind( budget );
+  runFrames( core, videoSink, samples, sps, videoSink.frames + 30 );
+  size_t coreDepth = core.rewindDepth();
+  identical &= coreDepth >= 4 && core.rewind() && core.rewind() && core.rewindDepth() == coreDepth - 4;
+
+  using us = std::chrono::duration<double, std::micro>;
+  std::printf( "rewind: %zu of %zu states kept in %zu KB\n", depth, hashes.size(), budget / 1024 );
+  std::printf( "rewind capture: avg %.1f us, max %.1f us, %.2f%% of emulated time\n", us( captureTime ).count() / std::max<size_t>( 1, hashes.size() ),
+    us( maxCaptureTime ).count(), 100.0 * captureTime / emulated );
+  std::printf( "rewind replay of %zu states: %s\n", depth, identical ? "identical" : "MISMATCH" );
+  return identical ? 0 : 2;
+}
+
+}
+
+int main( int argc, char const* argv[] )
+{
+  std::filesystem::path imagePath;
+  std::filesystem::path bootROMPath;
+  std::filesystem::path logPath;
+  std::filesystem::path tracePath;
+  std::filesystem::path profilePath;
+  std::filesystem::path labelsPath;
+  uint64_t frames = 600;
+  uint64_t stateCheckFrames = 0;
+  uint64_t cpuCheckFrames = 0;
+  uint64_t suzyCheckFrames = 0;
+  uint64_t lazyCheckFrames = 0;
+  uint64_t ringCheckFrames = 0;
+  uint64_t turboCheckFrames = 0;
+  uint32_t turbo = 0;
+  size_t rewindBudget = 0;
+  std::filesystem::path comLynxPath;
+  int comLynxNodes = 0;
+  uint64_t comLynxLatency = ComLynxLink::DEFAULT_LATENCY;
+  uint64_t comLynxCheckFrames = 0;
+  int comLynxConsoles = 2;
+  int sps = 48000;
+  std::string_view cpu = "interpreter";
+  std::string_view suzy = "batched";
+  std::string_view video = "rgba";
+  std::string_view audio = "step";
+
+  for ( int i = 1; i < argc; ++i )
+  {
+    std::string_view arg{ argv[i] };
+    if ( arg == "-frames" && i + 1 < argc )
+      frames = std::strtoull( argv[++i], nullptr, 10 );
+    else if ( arg == "-bootrom" && i + 1 < argc )
+      bootROMPath = argv[++i];
+    else if ( arg == "-sps" && i + 1 < argc )
+      sps = std::atoi( argv[++i] );
+    else if ( arg == "-cpu" && i + 1 < argc )
+      cpu = argv[++i];
+    else if ( arg == "-cpu-check" && i + 1 < argc )
+      cpuCheckFrames = std::strtoull( argv[++i], nullptr, 10 );
+    else if ( arg == "-suzy" && i + 1 < argc )
+      suzy = argv[++i];
+    else if ( arg == "-video" && i + 1 < argc )
+      video = argv[++i];
+    else if ( arg == "-audio" && i + 1 < argc )
+      audio = argv[++i];
+    else if ( arg == "-turbo" && i + 1 < argc )
+      turbo = (uint32_t)std::strtoul( argv[++i], nullptr, 10 );
+    else if ( arg == "-turbo-check" && i + 1 < argc )
+      turboCheckFrames = std::strtoull( argv[++i], nullptr, 10 );
+    else if ( arg == "-suzy-check" && i + 1 < argc )
+      suzyCheckFrames = std::strtoull( argv[++i], nullptr, 10 );
+    else if ( arg == "-lazy-check" && i + 1 < argc )
+      lazyCheckFrames = std::strtoull( argv[++i], nullptr, 10 );
+    else if ( arg == "-ring-check" && i + 1 < argc )
+      ringCheckFrames = std::strtoull( argv[++i], nullptr, 10 );
+    else if ( arg == "-state-check" && i + 1 < argc )
+      stateCheckFrames = std::strtoull( argv[++i], nullptr, 10 );
+    else if ( arg == "-rewind-check" && i + 1 < argc )
+      rewindBudget = std::strtoull( argv[++i], nullptr, 10 ) * 1024;
+    else if ( arg == "-log" && i + 1 < argc )
+      logPath = argv[++i];
+    else if ( arg == "-trace" && i + 1 < argc )
+      tracePath = argv[++i];
+    else if ( arg == "-profile" && i + 1 < argc )
+      profilePath = argv[++i];
+    else if ( arg == "-labels" && i + 1 < argc )
+      labelsPath = argv[++i];
+    else if ( arg == "-comlynx" && i + 1 < argc )
+      comLynxPath = argv[++i];
+    else if ( arg == "-comlynx-host" && i + 2 < argc )
+    {
+      comLynxPath = argv[++i];
+      comLynxNodes = std::atoi( argv[++i] );
+    }
+    else if ( arg == "-comlynx-latency" && i + 1 < argc )
+      comLynxLatency = std::strtoull( argv[++i], nullptr, 10 );
+    else if ( arg == "-comlynx-check" && i + 1 < argc )
+      comLynxCheckFrames = std::strtoull( argv[++i], nullptr, 10 );
+    else if ( arg == "-comlynx-consoles" && i + 1 < argc )
+      comLynxConsoles = std::atoi( argv[++i] );
+    else if ( !arg.starts_with( "-" ) && imagePath.empty() )
+      imagePath = arg;
+    else
+    {
+      usage();
+      return 1;
+    }
+  }
+
+  if ( imagePath.empty() || sps <= 0 || cpu != "interpreter" && cpu != "coroutine" || suzy != "batched" && suzy != "per-access" || video != "rgba" && video != "indexed" || audio != "step" && audio != "blep" || comLynxNodes < 0 || comLynxNodes > 255 || comLynxLatency < 2 || comLynxConsoles < 2 || comLynxConsoles > 8 )
+  {
+    usage();
+    return 1;
+  }
+
+  CPUBackend cpuBackend = cpu == "interpreter" ? CPUBackend::INTERPRETER : CPUBackend::COROUTINE;
+  SuzyBackend suzyBackend = suzy == "batched" ? SuzyBackend::BATCHED : SuzyBackend::PER_ACCESS;
+
+  try
+  {
+    std::shared_ptr<ImageProperties> imageProperties;
+    InputFile inputFile{ std::filesystem::absolute( imagePath ), imageProperties };
+    if ( !inputFile.valid() )
+    {
+      std::fprintf( stderr, "Unrecognized image file %s\n", imagePath.string().c_str() );
+      return 1;
+    }
+
+    std::shared_ptr<ImageROM const> bootROM;
+    if ( !bootROMPath.empty() )
+      bootROM = ImageROM::create( bootROMPath );
+
+    auto createImageCore = [&]( ImageProperties const& properties, InputFile const& input, std::shared_ptr<NullVideoSink> videoSink, CPUBackend cpuBackend, SuzyBackend suzyBackend )
+    {
+      auto core = std::make_unique<Core>( properties, std::make_shared<ComLynxWire>(), std::move( videoSink ), std::make_shared<NullInputSource>(), input,
+        bootROM, std::make_shared<ScriptDebuggerEscapes>(), cpuBackend, suzyBackend );
+      core->enableBandLimitedAudio( audio == "blep" );
+      return core;
+    };
+
+    auto createCore = [&]( std::shared_ptr<NullVideoSink> videoSink, CPUBackend cpuBackend, SuzyBackend suzyBackend )
+    {
+      return createImageCore( *imageProperties, inputFile, std::move( videoSink ), cpuBackend, suzyBackend );
+    };
+
+    //roughly a frame worth of samples per call
+    std::vector<AudioSample> samples( sps / 75 + 1 );
+
+    if ( cpuCheckFrames > 0 )
+    {
+      auto coroutineSink = std::make_shared<NullVideoSink>();
+      auto interpreterSink = std::make_shared<NullVideoSink>();
+      auto coroutine = createCore( coroutineSink, CPUBackend::COROUTINE, suzyBackend );
+      auto interpreter = createCore( interpreterSink, CPUBackend::INTERPRETER, suzyBackend );
+      if ( int result = backendCheck( "cpu", "coroutine", *coroutine, *coroutineSink, "interpreter", *interpreter, *interpreterSink, samples, sps, cpuCheckFrames ) )
+        return result;
+    }
+
+    if ( suzyCheckFrames > 0 )
+    {
+      auto perAccessSink = std::make_shared<NullVideoSink>();
+      auto batchedSink = std::make_shared<NullVideoSink>();
+      auto perAccess = createCore( perAccessSink, cpuBackend, SuzyBackend::PER_ACCESS );
+      auto batched = createCore( batchedSink, cpuBackend, SuzyBackend::BATCHED );
+      if ( int result = backendCheck( "suzy", "per-access", *perAccess, *perAccessSink, "batched", *batched, *batchedSink, samples, sps, suzyCheckFrames ) )
+        return result;
+    }
+
+    if ( lazyCheckFrames > 0 )
+    {
+      auto check = [&]( std::string const& unit, ImageProperties const& properties, InputFile const& input )
+      {
+        auto queuedSink = std::make_shared<NullVideoSink>();
+        auto lazySink = std::make_shared<NullVideoSink>();
+        auto queued = createImageCore( properties, input, queuedSink, cpuBackend, suzyBackend );
+        auto lazy = createImageCore( properties, input, lazySink, cpuBackend, suzyBackend );
+        queued->enableLazyAudio( false );
+        return backendCheck( unit.c_str(), "queued", *queued, *queuedSink, "lazy", *lazy, *lazySink, samples, sps, lazyCheckFrames );
+      };
+
+      if ( int result = check( "audio", *imageProperties, inputFile ) )
+        return result;
+
+      //built-in workloads cover what an arbitrary image may not, like linking a timer to a channel that has already gone lazy
+      for ( auto const& workload : builtinWorkloads() )
+      {
+        std::shared_ptr<ImageProperties> properties;
+        InputFile input{ workload.name, { workload.image.begin(), workload.image.end() }, properties };
+        if ( int result = check( std::string{ "audio " } + workload.name, *properties, input ) )
+          return result;
+      }
+    }
+
+    if ( comLynxCheckFrames > 0 )
+    {
+      auto create = [&]( std::shared_ptr<NullVideoSink> videoSink )
+      {
+        return createCore( std::move( videoSink ), cpuBackend, suzyBackend );
+      };
+      if ( int result = comLynxCheck( create, sps, comLynxCheckFrames, comLynxLatency, comLynxConsoles ) )
+        return result;
+    }
+
+    auto videoSink = std::make_shared<NullVideoSink>( video == "indexed" );
+    auto corePtr = createCore( videoSink, cpuBackend, suzyBackend );
+    Core & core = *corePtr;
+    core.enableTurbo( turbo );
+    if ( !logPath.empty() )
+    {
+      core.setLog( logPath );
+      core.debugCPU().enableTrace();
+    }
+    if ( !tracePath.empty() )
+      core.recordTrace( tracePath );
+    if ( !profilePath.empty() )
+      core.enableCodeProfile( true );
+
+    //relays messages until all nodes are done
+    std::unique_ptr<ComLynxHub> comLynxHub;
+    if ( comLynxNodes > 0 )
+      comLynxHub = std::make_unique<ComLynxHub>( comLynxPath, comLynxNodes, comLynxLatency );
+    if ( !comLynxPath.empty() )
+      core.linkComLynx( std::make_shared<ComLynxSocket>( comLynxPath ) );
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t hash = runFrames( core, *videoSink, samples, sps, frames );
+    std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+    //only the main run is traced
+    core.debugCPU().disableTrace();
+    core.recordTrace( {} );
+    core.enableCodeProfile( false );
+    core.linkComLynx( nullptr );
+
+    double ticks = (double)core.tick();
+    std::printf( "frames: %llu\n", (unsigned long long)videoSink->frames );
+    std::printf( "ticks: %llu\n", (unsigned long long)core.tick() );
+    std::printf( "emulated: %.3f s\n", ticks / TICKS_PER_SECOND );
+    std::printf( "wall: %.3f s\n", wall.count() );
+    std::printf( "cycles/s: %.0f (%.2fx realtime)\n", ticks / wall.count(), ticks / TICKS_PER_SECOND / wall.count() );
+    //identical for all CPU and Suzy backends and both video sinks unless palette is changed in the middle of a row
+    std::printf( "hash: %016llx\n", (unsigned long long)hash );
+    if ( videoSink->indexed )
+      std::printf( "video: %.0f bytes per frame\n", ( videoSink->frames * sizeof( videoSink->packed ) + videoSink->paletteUpdates * sizeof( videoSink->palette ) ) / (double)std::max<uint64_t>( 1, videoSink->frames ) );
+
+    if ( auto profile = core.codeProfile() )
+    {
+      SymbolSource symbols{ labelsPath };
+      std::ofstream report{ std::filesystem::path{ profilePath } += ".txt" };
+      profile->writeReport( report, *core.getTraceHelper(), &symbols );
+      std::ofstream folded{ std::filesystem::path{ profilePath } += ".folded" };
+      profile->writeFolded( folded, *core.getTraceHelper(), &symbols );
+
+      uint64_t count = 0, ticks = 0;
+      for ( auto const& entry : profile->pcs() )
+      {
+        count += entry.count;
+        ticks += entry.ticks;
+      }
+      std::printf( "profile: %llu instructions, %llu ticks\n", (unsigned long long)count, (unsigned long long)ticks );
+    }
+
+    if ( stateCheckFrames > 0 )
+    {
+      if ( int result = stateCheck( core, *videoSink, samples, sps, stateCheckFrames ) )
+        return result;
+    }
+
+    if ( turboCheckFrames > 0 )
+    {
+      if ( int result = turboCheck( core, *videoSink, samples, sps, turboCheckFrames, turbo > 0 ? turbo : 8 ) )
+        return result;
+    }
+
+    if ( ringCheckFrames > 0 )
+    {
+      if ( int result = ringCheck( core, *videoSink, samples, sps, ringCheckFrames ) )
+        return result;
+    }
+
+    if ( rewindBudget > 0 )
+      return rewindCheck( core, *videoSink, samples, sps, frames, rewindBudget );
+
+    return 0;
+  }
+  catch ( std::exception const& ex )
+  {
+    std::fprintf( stderr, "%s\n", ex.what() );
+    return 1;
+  }
+}
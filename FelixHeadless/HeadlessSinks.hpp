@@ -0,0 +1,85 @@
+#pragma once
+
+#include "IVideoSink.hpp"
+#include "IInputSource.hpp"
+
+//video sink that only keeps the last frame and counts frames
+struct NullVideoSink : public IVideoSink
+{
+  //indexed sink takes packed rows with palette snapshots and expands them to pixels only in expand
+  NullVideoSink( bool indexed = false ) : indexed{ indexed }
+  {
+  }
+
+  void newFrame() override
+  {
+    frames += 1;
+  }
+
+  void skipFrame() override
+  {
+    frames += 1;
+  }
+
+  Doublet* getRow( int row ) override
+  {
+    return indexed ? nullptr : frame.data() + row * ROW_BYTES;
+  }
+
+  uint8_t* getPackedRow( int row ) override
+  {
+    if ( !indexed )
+      return nullptr;
+
+    rowPalettes[row] = palette;
+    return packed.data() + row * ROW_BYTES;
+  }
+
+  void newPalette( std::span<uint8_t const, 32> newPalette ) override
+  {
+    std::ranges::copy( newPalette, palette.begin() );
+    paletteUpdates += 1;
+  }
+
+  //brings frame up to date with packed rows
+  void expand()
+  {
+    if ( !indexed )
+      return;
+
+    for ( int row = 0; row < SCREEN_HEIGHT; ++row )
+    {
+      std::array<Pixel, 16> pens;
+      for ( size_t i = 0; i < pens.size(); ++i )
+      {
+        uint8_t g = rowPalettes[row][i];
+        uint8_t br = rowPalettes[row][16 + i];
+        pens[i].b = ( br >> 4 ) | ( br & 0xf0 );
+        pens[i].g = ( g << 4 ) | g;
+        pens[i].r = ( br << 4 ) | ( br & 0x0f );
+        pens[i].x = 0;
+      }
+      for ( size_t i = row * ROW_BYTES; i < ( row + 1 ) * ROW_BYTES; ++i )
+      {
+        frame[i] = { pens[packed[i] >> 4], pens[packed[i] & 0x0f] };
+      }
+    }
+  }
+
+  bool indexed;
+  std::array<Doublet, ROW_BYTES * SCREEN_HEIGHT> frame{};
+  std::array<uint8_t, ROW_BYTES * SCREEN_HEIGHT> packed{};
+  std::array<uint8_t, 32> palette{};
+  std::array<std::array<uint8_t, 32>, SCREEN_HEIGHT> rowPalettes{};
+  uint64_t frames{};
+  uint64_t paletteUpdates{};
+};
+
+class NullInputSource : public IInputSource
+{
+public:
+  KeyInput getInput( bool leftHand ) const override
+  {
+    return {};
+  }
+};
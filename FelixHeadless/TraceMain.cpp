@@ -0,0 +1,94 @@
+#include "CPU.hpp"
+#include "TraceHelper.hpp"
+#include "TraceRecorder.hpp"
+#include "SymbolSource.hpp"
+#include <cstdio>
+
+namespace
+{
+
+void usage()
+{
+  std::fputs( "usage: felix-trace [-labels file.lab] [-ticks] [-from tick] [-to tick] trace.bin\n", stderr );
+}
+
+}
+
+int main( int argc, char const* argv[] )
+{
+  std::filesystem::path tracePath;
+  std::filesystem::path labelsPath;
+  bool printTicks = false;
+  uint64_t from = 0;
+  uint64_t to = std::numeric_limits<uint64_t>::max();
+
+  for ( int i = 1; i < argc; ++i )
+  {
+    std::string_view arg{ argv[i] };
+    if ( arg == "-labels" && i + 1 < argc )
+      labelsPath = argv[++i];
+    else if ( arg == "-ticks" )
+      printTicks = true;
+    else if ( arg == "-from" && i + 1 < argc )
+      from = std::strtoull( argv[++i], nullptr, 10 );
+    else if ( arg == "-to" && i + 1 < argc )
+      to = std::strtoull( argv[++i], nullptr, 10 );
+    else if ( !arg.starts_with( "-" ) && tracePath.empty() )
+      tracePath = arg;
+    else
+    {
+      usage();
+      return 1;
+    }
+  }
+
+  if ( tracePath.empty() )
+  {
+    usage();
+    return 1;
+  }
+
+  std::ifstream fin{ tracePath, std::ios::binary };
+  TraceRecorder::Header header{};
+  fin.read( (char*)&header, sizeof header );
+  if ( !fin || header.magic != TraceRecorder::MAGIC || header.version != TraceRecorder::VERSION || header.recordSize != sizeof( TraceRecord ) )
+  {
+    std::fprintf( stderr, "%s is not a Felix binary trace\n", tracePath.string().c_str() );
+    return 1;
+  }
+
+  //hardware register names are always there, program labels only when asked for
+  auto traceHelper = std::make_unique<TraceHelper>();
+  if ( !labelsPath.empty() )
+  {
+    SymbolSource symbols{ labelsPath };
+    for ( auto const& symbol : symbols.symbols() )
+    {
+      traceHelper->updateLabel( symbol.value, symbol.name.c_str() );
+    }
+  }
+
+  std::vector<TraceRecord> records( TraceRecorder::CHUNK_RECORDS );
+  std::array<char, 1024> line;
+  for ( ;; )
+  {
+    fin.read( (char*)records.data(), records.size() * sizeof( TraceRecord ) );
+    size_t count = (size_t)fin.gcount() / sizeof( TraceRecord );
+    if ( count == 0 )
+      break;
+
+    for ( auto const& record : std::span{ records }.first( count ) )
+    {
+      if ( record.tick < from || record.tick > to )
+        continue;
+
+      size_t size = CPU::formatTrace( line.data(), record.before(), record.after(), *traceHelper, nullptr );
+      if ( printTicks )
+        std::printf( "%12llu ", (unsigned long long)record.tick );
+      std::fwrite( line.data(), 1, size, stdout );
+      std::fputc( '\n', stdout );
+    }
+  }
+
+  return 0;
+}
@@ -5,7 +5,6 @@
 #include "WinImgui11.hpp"
 #include "Manager.hpp"
 #include "VideoSink.hpp"
-#define STB_IMAGE_WRITE_IMPLEMENTATION
 #include "stb_image_write.h"
 
 #define V_THROW(x) { HRESULT hr_ = (x); if( FAILED( hr_ ) ) { throw std::runtime_error{ "DXError" }; } }
@@ -249,6 +248,11 @@ bool DX11Renderer::resizeOutput()
 
 void DX11Renderer::updateSourceFromNextFrame()
 {
+  //source keeps previous frame if there is no new one
+  auto frame = mVideoSink->takeFrame();
+  if ( !frame )
+    return;
+
   D3D11_MAPPED_SUBRESOURCE d3dmap;
   gImmediateContext->Map( mSource.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &d3dmap );
 
@@ -258,7 +262,7 @@ void DX11Renderer::updateSourceFromNextFrame()
     uint32_t stride;
   } dst{ ( Doublet*)d3dmap.pData, d3dmap.RowPitch / (uint32_t)sizeof( Doublet ) };
 
-  Doublet const* src = mVideoSink->frame.data();
+  Doublet const* src = frame->data();
 
   for ( int i = 0; i < SCREEN_HEIGHT; ++i )
   {
@@ -481,7 +485,7 @@ void DX11Renderer::saveFrame( std::filesystem::path const& path )
   std::vector<uint32_t> buf;
   buf.reserve( 160 * 102 );
 
-  for ( auto d : mVideoSink->frame )
+  for ( auto d : mVideoSink->lastFrame() )
   {
     buf.push_back( d.left.toRGBA() );
     buf.push_back( d.right.toRGBA() );
@@ -17,12 +17,14 @@
 #include "ImageProperties.hpp"
 #include "LuaProxies.hpp"
 #include "CPU.hpp"
-#include "DebugRAM.hpp"
 #include "Renderer.hpp"
 #include "IInputSource.hpp"
 #include "ISystemDriver.hpp"
 #include "VGMWriter.hpp"
 #include "TraceHelper.hpp"
+#include "CodeProfiler.hpp"
+#include "AudioRing.hpp"
+#include "Utility.hpp"
 
 
 Manager::Manager() : mUI{ *this },
@@ -32,9 +34,10 @@ mDebugger{},
 mProcessThreads{},
 mJoinThreads{},
 mThreadsWaiting{},
+mRewind{},
+mTurbo{},
 mRenderThread{},
-mAudioThread{},
-mRenderingTime{},
+mEmulationThread{},
 mScriptDebuggerEscapes{},
 mImageProperties{},
 mRenderer{},
@@ -50,9 +53,7 @@ mDebugWindows{}
     {
       if ( mProcessThreads.load() )
       {
-        auto renderingTime = mRenderer->render( mUI );
-        std::scoped_lock<std::mutex> l{ mMutex };
-        mRenderingTime = renderingTime;
+        mRenderer->render( mUI );
       }
       else
       {
@@ -67,33 +68,95 @@ mDebugWindows{}
     }
   } };
 
-  mAudioThread = std::thread{ [this]
+  mEmulationThread = std::thread{ [this]
   {
     try
     {
+      using clock = std::chrono::steady_clock;
+
+      //emulation is paced by the wall clock in small chunks independent of the device period,
+      //the rate control absorbs the drift between the wall clock and the device clock
+      auto & ring = mAudioOut->ring();
+      int sps = mAudioOut->sampleRate();
+      int latency = std::clamp( gConfigProvider.sysConfig()->audio.latency, 10, 250 );
+      AudioRateControl rateControl{ sps, (size_t)sps * latency / 1000 };
+      std::vector<AudioSample> chunk( sps * CHUNK_MS / 1000 );
+      std::chrono::duration<double> sinceRewind{};
+      clock::time_point lastUpdate{};
+      bool paused{};
+      clock::time_point paceStart{};
+      std::chrono::duration<double> produced{};
+
       while ( !mJoinThreads.load() )
       {
         if ( mProcessThreads.load() )
         {
-          int64_t renderingTime;
+          if ( paceStart == clock::time_point{} )
+          {
+            paceStart = clock::now();
+            produced = {};
+          }
+
+          //fast forward runs unpaced and lets the audio device underrun
+          bool turbo = mTurbo.load();
+          if ( mInstance )
+            mInstance->enableTurbo( turbo ? TURBO_DRAW_INTERVAL : 0 );
+
+          auto ahead = produced - ( clock::now() - paceStart );
+          if ( turbo )
+          {
+            paceStart = clock::time_point{};
+          }
+          else if ( ahead > std::chrono::milliseconds( 1 ) )
+          {
+            std::this_thread::sleep_for( ahead );
+          }
+          else if ( ahead < -std::chrono::milliseconds( 100 ) )
           {
-            std::scoped_lock<std::mutex> l{ mMutex };
-            renderingTime = mRenderingTime;
+            //fell behind, no point catching up
+            paceStart = clock::time_point{};
+            continue;
           }
-          if ( mAudioOut->wait() )
+
+          int chunkSPS = rateControl.sps( ring.size() );
+          auto runMode = mDebugger.mRunMode.load();
+          if ( mRewind.load() && mInstance && runMode == RunMode::RUN && sinceRewind >= std::chrono::milliseconds( REWIND_PERIOD_MS ) )
           {
-            auto runMode = mDebugger.mRunMode.load();
-            auto cpuBreakType = mAudioOut->fillBuffer( mInstance, renderingTime, runMode );
-            if ( cpuBreakType != CpuBreakType::NEXT )
-            {
-              mDebugger.mRunMode.store( RunMode::PAUSE );
-            }
+            //steps back one captured frame per rewind period, then runs forward from there
+            mInstance->rewind();
+            sinceRewind = {};
+          }
+
+          auto cpuBreakType = CpuBreakType::NEXT;
+          if ( mInstance )
+            cpuBreakType = mInstance->advanceAudio( chunkSPS, chunk, runMode );
+          else
+            std::ranges::fill( chunk, AudioSample{} );
+
+          if ( cpuBreakType != CpuBreakType::NEXT )
+          {
+            mDebugger.mRunMode.store( RunMode::PAUSE );
+          }
+
+          //whatever doesn't fit is dropped, which happens only if the device stopped
+          if ( !turbo )
+            ring.push( chunk );
+          produced += std::chrono::duration<double>( (double)chunk.size() / chunkSPS );
+          sinceRewind += std::chrono::duration<double>( (double)chunk.size() / chunkSPS );
+
+          //UI follows at the rate of the audio device period, also in fast forward, and a break shows up immediately
+          auto now = clock::now();
+          if ( now - lastUpdate >= std::chrono::milliseconds( UPDATE_PERIOD_MS ) || paused != ( mDebugger.mRunMode.load() != RunMode::RUN ) )
+          {
+            paused = mDebugger.mRunMode.load() != RunMode::RUN;
+            mSystemDriver->setPaused( paused );
+            updateDebugWindows();
+            lastUpdate = now;
           }
-          mSystemDriver->setPaused( mDebugger.mRunMode.load() != RunMode::RUN );
-          updateDebugWindows();
         }
         else
         {
+          paceStart = clock::time_point{};
           mThreadsWaiting.fetch_add( 1 );
           do
           {
@@ -286,6 +349,38 @@ void Manager::processLua( std::filesystem::path const& path )
     }
   };
 
+  mLua["profileOn"] = [this] ()
+  {
+    if ( mInstance )
+    {
+      mInstance->enableCodeProfile( true );
+    }
+  };
+
+  mLua["profileOff"] = [this] ()
+  {
+    if ( mInstance )
+    {
+      mInstance->enableCodeProfile( false );
+    }
+  };
+
+  //writes name.txt report and name.folded stacks for flamegraph
+  mLua["profileSave"] = [this, luaPath]( std::string name )
+  {
+    if ( auto profile = mInstance ? mInstance->codeProfile() : nullptr )
+    {
+      std::filesystem::path path{ name };
+      if ( !path.is_absolute() )
+        path = luaPath.parent_path() / path;
+
+      std::ofstream report{ std::filesystem::path{ path } += ".txt" };
+      profile->writeReport( report, *mInstance->getTraceHelper(), mSymbols.get() );
+      std::ofstream folded{ std::filesystem::path{ path } += ".folded" };
+      profile->writeFolded( folded, *mInstance->getTraceHelper(), mSymbols.get() );
+    }
+  };
+
   mLua.set_function( "setLabel", [this] ( uint16_t addr, std::string label )
   {
     if ( mInstance )
@@ -343,6 +438,20 @@ void Manager::processLua( std::filesystem::path const& path )
       mLogPath = luaPath.parent_path() / path;
     }
   }
+
+  //binary trace of the whole session to be rendered by felix-trace
+  if ( sol::optional<std::string> opt = mLua["traceFile"] )
+  {
+    std::filesystem::path path{ *opt };
+    if ( path.is_absolute() )
+    {
+      mTracePath = path;
+    }
+    else
+    {
+      mTracePath = luaPath.parent_path() / path;
+    }
+  }
 }
 
 std::optional<InputFile> Manager::computeInputFile()
@@ -351,7 +460,8 @@ std::optional<InputFile> Manager::computeInputFile()
 
   std::filesystem::path path = std::filesystem::absolute( mArg );
 
-  InputFile file{ path, mImageProperties };
+  //a mapped file can't be overwritten on Windows, reading a copy lets the image be rebuilt while it is running
+  InputFile file{ path, readFile( path ), mImageProperties };
   if ( !file.valid() )
     return {};
 
@@ -392,6 +502,11 @@ void Manager::machineReset()
 
     if ( !mLogPath.empty() )
       mInstance->setLog( mLogPath );
+    if ( !mTracePath.empty() )
+      mInstance->recordTrace( mTracePath );
+
+    mInstance->enableRewind( (size_t)std::max( 0, gConfigProvider.sysConfig()->rewind.budget ) << 20 );
+    mInstance->enableBandLimitedAudio( gConfigProvider.sysConfig()->audio.bandLimited );
   }
   else
   {
@@ -416,9 +531,9 @@ void Manager::updateRotation()
 void Manager::stopThreads()
 {
   mJoinThreads.store( true );
-  if ( mAudioThread.joinable() )
-    mAudioThread.join();
-  mAudioThread = {};
+  if ( mEmulationThread.joinable() )
+    mEmulationThread.join();
+  mEmulationThread = {};
   if ( mRenderThread.joinable() )
     mRenderThread.join();
   mRenderThread = {};
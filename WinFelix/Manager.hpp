@@ -48,7 +48,15 @@ private:
   void updateDebugWindows();
   
   static std::shared_ptr<ImageROM const> getOptionalBootROM();
+
 private:
+  //emulation granularity, independent of audio device period
+  static constexpr int CHUNK_MS = 2;
+  static constexpr int REWIND_PERIOD_MS = 10;
+  static constexpr int UPDATE_PERIOD_MS = 10;
+  //frames drawn in fast forward
+  static constexpr uint32_t TURBO_DRAW_INTERVAL = 8;
+
 
   friend struct RamProxy;
   friend struct RomProxy;
@@ -82,9 +90,14 @@ private:
   std::atomic_bool mProcessThreads;
   std::atomic_bool mJoinThreads;
   std::atomic_int mThreadsWaiting;
+  //rewind key is held
+  std::atomic_bool mRewind;
+  //fast forward key is held
+  std::atomic_bool mTurbo;
   HMODULE mEncoderMod;
   std::thread mRenderThread;
-  std::thread mAudioThread;
+  //runs the emulation and feeds audio ring of mAudioOut
+  std::thread mEmulationThread;
   std::shared_ptr<ISystemDriver> mSystemDriver;
   std::shared_ptr<IRenderer> mRenderer;
   std::shared_ptr<WinAudioOut> mAudioOut;
@@ -95,6 +108,5 @@ private:
   std::shared_ptr<ImageProperties> mImageProperties;
   std::filesystem::path mArg;
   std::filesystem::path mLogPath;
-  std::mutex mMutex;
-  int64_t mRenderingTime;
+  std::filesystem::path mTracePath;
 };
@@ -82,6 +82,11 @@ void SysConfig::serialize( std::filesystem::path path )
   fout << "};\n";
   fout << "audio = {\n";
   fout << "\tmute = " << ( audio.mute ? "true;\n" : "false;\n" );
+  fout << "\tlatency = " << audio.latency << ";\n";
+  fout << "\tbandLimited = " << ( audio.bandLimited ? "true;\n" : "false;\n" );
+  fout << "};\n";
+  fout << "rewind = {\n";
+  fout << "\tbudget = " << rewind.budget << ";\n";
   fout << "};\n";
 }
 
@@ -137,4 +142,7 @@ SysConfig::SysConfig( sol::state const& lua )
     }
   }
   audio.mute = lua["audio"]["mute"].get_or( audio.mute );
+  audio.latency = lua["audio"]["latency"].get_or( audio.latency );
+  audio.bandLimited = lua["audio"]["bandLimited"].get_or( audio.bandLimited );
+  rewind.budget = lua["rewind"]["budget"].get_or( rewind.budget );
 }
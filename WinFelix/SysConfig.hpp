@@ -68,7 +68,16 @@ struct SysConfig
   struct Audio
   {
     bool mute{};
+    //milliseconds of audio the emulation thread keeps ahead of the device
+    int latency = 40;
+    //band limited synthesis of output steps, one sample of extra latency
+    bool bandLimited{};
   } audio;
+  struct Rewind
+  {
+    //size of rewind buffer in megabytes, 0 disables rewind
+    int budget = 32;
+  } rewind;
 
   SysConfig();
   SysConfig( sol::state const& lua );
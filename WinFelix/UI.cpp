@@ -96,6 +96,9 @@ bool UI::mainMenu( ImGuiIO& io )
     resetIssued = true;
   }
 
+  mManager.mRewind.store( !io.WantTextInput && ImGui::IsKeyDown( ImGuiKey_Backspace ) );
+  mManager.mTurbo.store( !io.WantTextInput && ImGui::IsKeyDown( ImGuiKey_Tab ) );
+
   if ( ImGui::IsKeyPressed( ImGuiKey_F4 ) )
   {
     debugMode = !debugMode;
@@ -1,16 +1,48 @@
 #include "VideoSink.hpp"
 
-VideoSink::VideoSink() : frame{}
+VideoSink::VideoSink() : mFrames{}, mDrawn{ 0 }, mPublished{ 1 }, mTaken{ 2 }, mFrameSequence{}, mDroppedFrames{}
 {
-  std::ranges::fill( frame, Doublet{} );
+  for ( auto & frame : mFrames )
+  {
+    std::ranges::fill( frame, Doublet{} );
+  }
 }
 
 void VideoSink::newFrame()
 {
+  uint32_t previous = mPublished.exchange( mDrawn | FRESH, std::memory_order_acq_rel );
+  mDrawn = previous & INDEX_MASK;
+  if ( ( previous & FRESH ) != 0 )
+    mDroppedFrames.fetch_add( 1, std::memory_order_relaxed );
+  mFrameSequence.fetch_add( 1, std::memory_order_relaxed );
 }
 
 Doublet* VideoSink::getRow( int row )
 {
   assert( row >= 0 && row < SCREEN_HEIGHT );
-  return frame.data() + row * ROW_BYTES;
+  return mFrames[mDrawn].data() + row * ROW_BYTES;
+}
+
+VideoSink::Frame const* VideoSink::takeFrame()
+{
+  if ( ( mPublished.load( std::memory_order_relaxed ) & FRESH ) == 0 )
+    return nullptr;
+
+  mTaken = mPublished.exchange( mTaken, std::memory_order_acq_rel ) & INDEX_MASK;
+  return &mFrames[mTaken];
+}
+
+VideoSink::Frame const& VideoSink::lastFrame() const
+{
+  return mFrames[mTaken];
+}
+
+uint64_t VideoSink::frameSequence() const
+{
+  return mFrameSequence.load( std::memory_order_relaxed );
+}
+
+uint64_t VideoSink::droppedFrames() const
+{
+  return mDroppedFrames.load( std::memory_order_relaxed );
 }
@@ -1,12 +1,38 @@
 #pragma once
 #include "IVideoSink.hpp"
 
+//Triple buffered frame handoff. Emulation thread draws into its own buffer and publishes it on newFrame,
+//render thread takes the newest published frame. Neither side waits for the other.
 struct VideoSink : public IVideoSink
 {
+  using Frame = std::array<Doublet, ROW_BYTES * SCREEN_HEIGHT>;
+
   VideoSink();
   void newFrame() override;
   Doublet* getRow( int row ) override;
 
-  std::array<Doublet, ROW_BYTES * SCREEN_HEIGHT> frame;
-};
+  //Render thread. Newest complete frame or nullptr if nothing was published since previous call
+  Frame const* takeFrame();
+  //Render thread. Frame returned by the last successful takeFrame
+  Frame const& lastFrame() const;
+
+  //number of published frames
+  uint64_t frameSequence() const;
+  //frames that were replaced by a newer one before render thread took them
+  uint64_t droppedFrames() const;
 
+private:
+  static constexpr uint32_t INDEX_MASK = 3;
+  //published buffer hasn't been taken yet
+  static constexpr uint32_t FRESH = 4;
+
+  std::array<Frame, 3> mFrames;
+  //buffer drawn by emulation thread
+  uint32_t mDrawn;
+  //buffer exchanged between threads with FRESH flag
+  std::atomic<uint32_t> mPublished;
+  //buffer read by render thread
+  uint32_t mTaken;
+  std::atomic<uint64_t> mFrameSequence;
+  std::atomic<uint64_t> mDroppedFrames;
+};
@@ -1,10 +1,9 @@
 #include "WinAudioOut.hpp"
-#include "Core.hpp"
 #include "Log.hpp"
 #include "ConfigProvider.hpp"
 #include "SysConfig.hpp"
 
-WinAudioOut::WinAudioOut() : mWav{}, mNormalizer{ 1.0f / 32768.0f }, mMutex{}
+WinAudioOut::WinAudioOut() : mWav{}, mNormalizer{ 1.0f / 32768.0f }, mMutex{}, mRing{}, mUnderruns{}, mStop{}, mThread{}
 {
   CoInitializeEx( NULL, COINIT_MULTITHREADED );
 
@@ -68,16 +67,34 @@ WinAudioOut::WinAudioOut() : mWav{}, mNormalizer{ 1.0f / 32768.0f }, mMutex{}
 
   mTimeToSamples = (double)frequency / (double)(l.QuadPart * mMixFormat->nBlockAlign);
 
-  mSamplesDelta = mSamplesDeltaDelta = 0;
-
+  mSamplesDelta = mSamplesDeltaDelta = 0;
+
+  //half a second is well above any latency the emulation thread aims for
+  mRing = std::make_unique<AudioRing>( mMixFormat->nSamplesPerSec / 2 );
+
   mAudioClient->Start();
-
+
   auto sysConfig = gConfigProvider.sysConfig();
   mute( sysConfig->audio.mute );
+
+  mThread = std::thread{ [this]
+  {
+    CoInitializeEx( NULL, COINIT_MULTITHREADED );
+    while ( !mStop.load() )
+    {
+      if ( WaitForSingleObject( mEvent, 100 ) == WAIT_OBJECT_0 )
+        drain();
+    }
+    CoUninitialize();
+  } };
 }
 
 WinAudioOut::~WinAudioOut()
 {
+  mStop.store( true );
+  if ( mThread.joinable() )
+    mThread.join();
+
   mAudioClient->Stop();
 
   if ( mEvent )
@@ -151,51 +168,56 @@ bool WinAudioOut::mute() const
   return mNormalizer == 0;
 }
 
-bool WinAudioOut::wait()
-{
-  DWORD retval = WaitForSingleObject( mEvent, 100 );
-  return retval == WAIT_OBJECT_0;
-}
-
-CpuBreakType WinAudioOut::fillBuffer( std::shared_ptr<Core> instance, int64_t renderingTimeQPC, RunMode runMode )
-{
+int WinAudioOut::sampleRate() const
+{
+  return (int)mMixFormat->nSamplesPerSec;
+}
+
+AudioRing & WinAudioOut::ring()
+{
+  return *mRing;
+}
+
+uint64_t WinAudioOut::underruns() const
+{
+  return mUnderruns.load( std::memory_order_relaxed );
+}
+
+void WinAudioOut::drain()
+{
   HRESULT hr;
   uint32_t padding{};
   hr = mAudioClient->GetCurrentPadding( &padding );
+  if ( FAILED( hr ) )
+    return;
   uint32_t framesAvailable = mBufferSize - padding;
 
-  if ( framesAvailable > 0 )
-  {
-    if ( !instance )
-      return CpuBreakType::NEXT;
-
-    auto cpuBreakType = instance->advanceAudio( mMixFormat->nSamplesPerSec, std::span<AudioSample>{ mSamplesBuffer.data(), framesAvailable }, runMode );
-
-    BYTE *pData;
-    hr = mRenderClient->GetBuffer( framesAvailable, &pData );
-    if ( FAILED( hr ) )
-      return CpuBreakType::NEXT;
-    float* pfData = reinterpret_cast<float*>( pData );
-    for ( uint32_t i = 0; i < framesAvailable; ++i )
-    {
-      pfData[i * mMixFormat->nChannels + 0] = mSamplesBuffer[i].left * mNormalizer;
-      pfData[i * mMixFormat->nChannels + 1] = mSamplesBuffer[i].right * mNormalizer;
-    }
-
-    {
-      std::unique_lock lock{ mMutex };
-      if ( mWav )
-        wav_write( mWav, pfData, framesAvailable );
-    }
-
-    hr = mRenderClient->ReleaseBuffer( framesAvailable, 0 );
-
-    return cpuBreakType;
-  }
-
-  return CpuBreakType::NEXT;
-}
+  if ( framesAvailable == 0 )
+    return;
 
+  size_t count = mRing->pop( std::span<AudioSample>{ mSamplesBuffer.data(), framesAvailable } );
+  if ( count < framesAvailable )
+  {
+    std::fill( mSamplesBuffer.begin() + count, mSamplesBuffer.begin() + framesAvailable, AudioSample{} );
+    mUnderruns.fetch_add( framesAvailable - count, std::memory_order_relaxed );
+  }
 
+  BYTE *pData;
+  hr = mRenderClient->GetBuffer( framesAvailable, &pData );
+  if ( FAILED( hr ) )
+    return;
+  float* pfData = reinterpret_cast<float*>( pData );
+  for ( uint32_t i = 0; i < framesAvailable; ++i )
+  {
+    pfData[i * mMixFormat->nChannels + 0] = mSamplesBuffer[i].left * mNormalizer;
+    pfData[i * mMixFormat->nChannels + 1] = mSamplesBuffer[i].right * mNormalizer;
+  }
 
+  {
+    std::unique_lock lock{ mMutex };
+    if ( mWav )
+      wav_write( mWav, pfData, framesAvailable );
+  }
 
+  hr = mRenderClient->ReleaseBuffer( framesAvailable, 0 );
+}
@@ -1,10 +1,10 @@
 #pragma once
 
 #include "Utility.hpp"
+#include "AudioRing.hpp"
 #include "wav.h"
 
-class Core;
-
+//Plays samples from the ring in its own thread woken by the device, missing samples are played as silence
 class WinAudioOut
 {
 public:
@@ -12,13 +12,21 @@ public:
   WinAudioOut();
   ~WinAudioOut();
 
-  bool wait();
-  CpuBreakType fillBuffer( std::shared_ptr<Core> instance, int64_t renderingTime, RunMode runMode );
+  int sampleRate() const;
+  //filled by emulation thread
+  AudioRing & ring();
+  //samples played as silence because the ring was empty
+  uint64_t underruns() const;
+
   void setWavOut( std::filesystem::path path );
   bool isWavOut() const;
   void mute( bool value );
   bool mute() const;
 
+private:
+
+  void drain();
+
 private:
 
   ComPtr<IMMDevice> mDevice;
@@ -39,4 +47,9 @@ private:
   int32_t mSamplesDeltaDelta;
 
   float mNormalizer;
+
+  std::unique_ptr<AudioRing> mRing;
+  std::atomic<uint64_t> mUnderruns;
+  std::atomic_bool mStop;
+  std::thread mThread;
 };
@@ -1,4 +1,5 @@
 #include "ActionQueue.hpp"
+#include "StateStream.hpp"
 
 SequencedAction::SequencedAction() : mData{}
 {
@@ -28,50 +29,86 @@ SequencedAction::operator bool() const
   return mData != 0;
 }
 
-ActionQueue::ActionQueue() : mHeap{}
+ActionQueue::ActionQueue() : mTimers{}, mOthers{}, mHead{ EMPTY }
 {
+  mTimers.fill( EMPTY );
 }
 
-void ActionQueue::push( SequencedAction action )
+int ActionQueue::timerSlot( uint64_t data )
 {
-  mHeap.push_back( action );
-  std::push_heap( mHeap.begin(), mHeap.end() );
+  return (int)( data & ( TICK_PERIOD - 1 ) ) - (int)Action::FIRE_TIMER0;
 }
 
-SequencedAction ActionQueue::pop()
+void ActionQueue::push( SequencedAction action )
 {
-  if ( !mHeap.empty() )
-  {
-    std::pop_heap( mHeap.begin(), mHeap.end() );
+  uint64_t data = action.mData;
 
-    auto result = mHeap.back();
-    mHeap.pop_back();
-    return result;
+  if ( int slot = timerSlot( data ); slot >= 0 && slot < TIMERS )
+  {
+    uint64_t previous = std::exchange( mTimers[slot], data );
+    if ( previous == mHead && data > previous )
+      updateHead();
+    else
+      mHead = std::min( mHead, data );
+    return;
   }
-  else
+
+  //usually the earliest one, so searching from the back
+  auto it = mOthers.end();
+  while ( it != mOthers.begin() && *( it - 1 ) < data )
   {
-    return {};
+    --it;
   }
+  mOthers.insert( it, data );
+  mHead = std::min( mHead, data );
 }
 
-uint64_t ActionQueue::headTick() const
+SequencedAction ActionQueue::pop()
 {
-  assert( !empty() );
-  return mHeap.front().getTick();
+  SequencedAction result{};
+  if ( empty() )
+    return result;
+
+  result.mData = mHead;
+  if ( !mOthers.empty() && mOthers.back() == mHead )
+    mOthers.pop_back();
+  else
+    mTimers[timerSlot( mHead )] = EMPTY;
+
+  updateHead();
+  return result;
 }
 
 void ActionQueue::erase( Action action )
 {
-  for ( auto& e : mHeap )
+  if ( int slot = (int)action - (int)Action::FIRE_TIMER0; slot >= 0 && slot < TIMERS )
+  {
+    mTimers[slot] = EMPTY;
+  }
+  else
   {
-    if ( e.getAction() == action )
+    std::erase_if( mOthers, [=]( uint64_t data )
     {
-      e.clear();
-    }
+      return (Action)( data & ( TICK_PERIOD - 1 ) ) == action;
+    } );
   }
+
+  updateHead();
 }
 
-bool ActionQueue::empty() const
+void ActionQueue::updateHead()
 {
-  return mHeap.empty();
+  mHead = mOthers.empty() ? EMPTY : mOthers.back();
+  for ( uint64_t data : mTimers )
+  {
+    mHead = std::min( mHead, data );
+  }
+}
+
+void ActionQueue::serialize( StateStream & stream )
+{
+  stream( mTimers, mOthers );
+
+  if ( stream.loading() )
+    updateHead();
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+class StateStream;
+
 static constexpr uint64_t TICK_PERIOD_LOG = 8;
 static constexpr uint64_t TICK_PERIOD = 1 << TICK_PERIOD_LOG;
 
@@ -24,8 +26,8 @@ enum class Action
   ASSERT_RESET = 0x20,
   DESERT_IRQ = 0x11,
   DESERT_RESET = 0x21,
-  SAMPLE_AUDIO = 0x30,
   BATCH_END = 0x40,
+  COMLYNX_SYNC = 0x41,
   ACTIONS_END_
 };
 
@@ -50,23 +52,46 @@ public:
   }
 
 private:
+  friend class ActionQueue;
   uint64_t mData;
 };
 
+//Timer fires have a fixed slot each. Rescheduling a timer replaces its pending fire as TimerCore ignores fires at other than expected tick anyway.
+//Other actions can be pending more than once and are kept in a small array sorted by descending order of execution.
+//Earliest action of both is cached, so checking the head is O(1).
 class ActionQueue
 {
 public:
   ActionQueue();
 
-
   void push( SequencedAction action );
   SequencedAction pop();
-  uint64_t headTick() const;
+  //removes all pending occurences of the action
   void erase( Action action );
-  bool empty() const;
+
+  uint64_t headTick() const
+  {
+    assert( !empty() );
+    return mHead >> TICK_PERIOD_LOG;
+  }
+
+  bool empty() const
+  {
+    return mHead == EMPTY;
+  }
+
+  void serialize( StateStream & stream );
 
 private:
+  static constexpr uint64_t EMPTY = ~0ull;
+  static constexpr int TIMERS = (int)Action::FIRE_TIMERC - (int)Action::FIRE_TIMER0 + 1;
 
-  std::vector<SequencedAction> mHeap;
+  static int timerSlot( uint64_t data );
+  void updateHead();
+
+private:
+  std::array<uint64_t, TIMERS> mTimers;
+  std::vector<uint64_t> mOthers;
+  uint64_t mHead;
 };
 
@@ -1,6 +1,7 @@
 #include "AudioChannel.hpp"
 #include "TimerCore.hpp"
 #include "Utility.hpp"
+#include "StateStream.hpp"
 
 AudioChannel::AudioChannel( TimerCore& timer ) : mTimer{ timer }, mChangeCycle{}, mShiftRegisterBackup{}, mShiftRegister{}, mTapSelector{}, mParity{ ~0u }, mEnableIntegrate{}, mVolume{}, mOutput{}, mOldOutput{}
 {
@@ -109,8 +110,9 @@ float AudioChannel::sample( uint64_t tick ) const
   return mOutput; // std::lerp( mOldOutput, mOutput, sampleHelper( (uint32_t)( tick - mChangeCycle ) ) );
 }
 
-void AudioChannel::trigger( uint64_t tick )
+bool AudioChannel::trigger( uint64_t tick )
 {
+  float const output = mOutput;
   uint32_t xorGate = mTapSelector & mShiftRegister;
   uint32_t parity = std::popcount( xorGate ) & 1 ^ 1;
   mShiftRegister = ( mShiftRegister << 1 ) | parity;
@@ -136,4 +138,10 @@ void AudioChannel::trigger( uint64_t tick )
     mParity = parity;
   }
 
+  return mOutput != output;
+}
+
+void AudioChannel::serialize( StateStream & stream )
+{
+  stream( mChangeCycle, mShiftRegisterBackup, mShiftRegister, mTapSelector, mParity, mEnableIntegrate, mEven, mVolume, mOutput, mOldOutput );
 }
@@ -3,6 +3,7 @@
 #include "ActionQueue.hpp"
 
 class TimerCore;
+class StateStream;
 
 class AudioChannel
 {
@@ -29,7 +30,10 @@ public:
 
   float sample( uint64_t tick ) const;
 
-  void trigger( uint64_t tick );
+  //returns true if the output has changed
+  bool trigger( uint64_t tick );
+
+  void serialize( StateStream & stream );
 
 private:
   static float sampleHelper( uint32_t diff );
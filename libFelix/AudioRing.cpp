@@ -0,0 +1,63 @@
+#include "AudioRing.hpp"
+
+AudioRing::AudioRing( size_t capacity ) : mBuffer( std::bit_ceil( std::max<size_t>( capacity, 2 ) ) ), mMask{ mBuffer.size() - 1 }, mWrite{}, mRead{}
+{
+}
+
+size_t AudioRing::capacity() const
+{
+  return mBuffer.size();
+}
+
+size_t AudioRing::size() const
+{
+  return mWrite.load( std::memory_order_acquire ) - mRead.load( std::memory_order_acquire );
+}
+
+size_t AudioRing::push( std::span<AudioSample const> samples )
+{
+  size_t write = mWrite.load( std::memory_order_relaxed );
+  size_t count = std::min( samples.size(), mBuffer.size() - ( write - mRead.load( std::memory_order_acquire ) ) );
+
+  //at most two contiguous parts
+  size_t first = std::min( count, mBuffer.size() - ( write & mMask ) );
+  std::copy_n( samples.data(), first, mBuffer.data() + ( write & mMask ) );
+  std::copy_n( samples.data() + first, count - first, mBuffer.data() );
+
+  mWrite.store( write + count, std::memory_order_release );
+  return count;
+}
+
+size_t AudioRing::pop( std::span<AudioSample> samples )
+{
+  size_t read = mRead.load( std::memory_order_relaxed );
+  size_t count = std::min( samples.size(), mWrite.load( std::memory_order_acquire ) - read );
+
+  size_t first = std::min( count, mBuffer.size() - ( read & mMask ) );
+  std::copy_n( mBuffer.data() + ( read & mMask ), first, samples.data() );
+  std::copy_n( mBuffer.data(), count - first, samples.data() + first );
+
+  mRead.store( read + count, std::memory_order_release );
+  return count;
+}
+
+AudioRateControl::AudioRateControl( int sps, size_t target, double maxDeviation ) : mSPS{ sps }, mTarget{ std::max<size_t>( target, 1 ) }, mMaxDeviation{ maxDeviation }
+{
+}
+
+int AudioRateControl::nominal() const
+{
+  return mSPS;
+}
+
+size_t AudioRateControl::target() const
+{
+  return mTarget;
+}
+
+int AudioRateControl::sps( size_t fill ) const
+{
+  //more samples queued than wanted means fewer should be produced per emulated second
+  double error = std::clamp( ( (double)fill - (double)mTarget ) / (double)mTarget, -1.0, 1.0 );
+  return (int)std::lround( mSPS * ( 1.0 - mMaxDeviation * error ) );
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Utility.hpp"
+
+//Ring of audio samples for one producer thread and one consumer thread, neither of them locks or waits
+class AudioRing
+{
+public:
+  //capacity is rounded up to a power of two
+  explicit AudioRing( size_t capacity );
+
+  size_t capacity() const;
+  //samples ready for the consumer
+  size_t size() const;
+
+  //producer side, returns number of samples stored
+  size_t push( std::span<AudioSample const> samples );
+  //consumer side, returns number of samples taken
+  size_t pop( std::span<AudioSample> samples );
+
+private:
+  std::vector<AudioSample> mBuffer;
+  size_t mMask;
+  //free running positions, each written by one side only
+  alignas( 64 ) std::atomic<size_t> mWrite;
+  alignas( 64 ) std::atomic<size_t> mRead;
+};
+
+//Emulation paced by the wall clock and audio consumed by a device clock slowly drift apart.
+//Samples per second of emulated time are steered up to maxDeviation off the nominal rate so that the ring holds about target samples.
+class AudioRateControl
+{
+public:
+  AudioRateControl( int sps, size_t target, double maxDeviation = 0.005 );
+
+  int nominal() const;
+  size_t target() const;
+  //rate to produce next samples with given ring fill
+  int sps( size_t fill ) const;
+
+private:
+  int mSPS;
+  size_t mTarget;
+  double mMaxDeviation;
+};
@@ -1,7 +1,9 @@
 #include "CPU.hpp"
 #include "Opcodes.hpp"
 #include "TraceHelper.hpp"
-#include "DebugRAM.hpp"
+#include "TraceRecorder.hpp"
+#include "CodeProfiler.hpp"
+#include "StateStream.hpp"
 #include <stdarg.h>
 
 namespace
@@ -227,16 +229,49 @@ void CPU::setLog( std::filesystem::path const & path )
   mFtrace = std::ofstream{ path };
 }
 
+void CPU::setTraceRecorder( std::shared_ptr<TraceRecorder> recorder )
+{
+  mRecorder = std::move( recorder );
+  setGlobalTrace();
+}
+
+void CPU::setProfiler( std::shared_ptr<CodeProfiler> profiler )
+{
+  mProfiler = std::move( profiler );
+  setGlobalTrace();
+}
+
+bool CPU::instructionBoundary() const
+{
+  return !mStarted || mReq.type == Request::Type::FETCH_OPCODE;
+}
+
+void CPU::serialize( StateStream & stream )
+{
+  assert( stream.loading() || instructionBoundary() );
+
+  bool opcodeFetched = mStarted || mResumeAfterFetch;
+  stream( mState, mRes.interrupt, mRes.value, opcodeFetched );
+
+  if ( stream.loading() )
+  {
+    mPreviousState = mState;
+    mReq.type = Request::Type::FETCH_OPCODE;
+    mStarted = false;
+    mResumeAfterFetch = opcodeFetched;
+    mEx = execute();
+  }
+}
+
 CPUState & CPU::state()
 {
   return mState;
 }
 
-CPU::CPU( std::shared_ptr<TraceHelper> traceHelper ) : mState{ CPUState::reset() }, mEx{ execute() }, mReq{}, mRes{ mState }, mTrace{}, mTraceNextCount{}, mGlobalTrace{}, mFtrace{}, mTraceHelper{ std::move( traceHelper ) }, off{},
+CPU::CPU( std::shared_ptr<TraceHelper> traceHelper ) : mState{ CPUState::reset() }, mEx{ execute() }, mReq{}, mRes{ mState }, mTrace{}, mTraceNextCount{}, mGlobalTrace{}, mFtrace{}, mTraceHelper{ std::move( traceHelper ) }, mRecorder{}, mProfiler{},
+  mStarted{}, mResumeAfterFetch{},
   mPostponedStepOut{}, mStackBreakCondition{ 0xffff }, mBreakOnBrk{ false }
 {
-  static constexpr char prototype[] = "PC:ffff A:ff X:ff Y:ff S:1ff P=NVDIZC ";
-  memcpy( &buf[0], prototype, sizeof prototype );
 }
 
 CPU::~CPU()
@@ -322,6 +357,12 @@ CPU::Execute::Execute( handle c ) : coro{ c }
 {
 }
 
+CPU::Execute & CPU::Execute::operator=( Execute && other )
+{
+  std::swap( coro, other.coro );
+  return *this;
+}
+
 CPU::Execute::~Execute()
 {
   if ( coro )
@@ -333,9 +374,30 @@ CPU::Execute::~Execute()
 CPU::Execute CPU::execute()
 {
   auto& state = mState;
-  mPreviousState = state;
+  mStarted = true;
 
-  trace1();
+  if ( std::exchange( mResumeAfterFetch, false ) )
+  {
+    //continuing from a saved state in the middle of the opcode fetch tail of the loop below
+    state.interrupt = mRes.interrupt;
+    state.op = (Opcode)mRes.value;
+    mPreviousState = state;
+    trace1();
+    state.pc += 1;
+
+    while ( isHiccup() )
+    {
+      co_await fetchOpcode( state.pc );
+      mPreviousState = state;
+      trace1();
+      state.pc += 1;
+    }
+  }
+  else
+  {
+    mPreviousState = state;
+    trace1();
+  }
 
 
 
@@ -351,1772 +413,13 @@ CPU::Execute CPU::execute()
 
     state.eal = co_await fetchOperand( state.pc );
 
-    switch ( state.op )
-    {
-    case Opcode::RZP_AND:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      state.setnz( state.a &= state.m1 );
-      break;
-    case Opcode::RZP_BIT:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      state.bit( state.m1 );
-      break;
-    case Opcode::RZP_CMP:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      state.cmp( state.m1 );
-      break;
-    case Opcode::RZP_CPX:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      state.cpx( state.m1 );
-      break;
-    case Opcode::RZP_CPY:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      state.cpy( state.m1 );
-      break;
-    case Opcode::RZP_EOR:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      state.setnz( state.a ^= state.m1 );
-      break;
-    case Opcode::RZP_LDA:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      state.setnz( state.a = state.m1 );
-      break;
-    case Opcode::RZP_LDX:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      state.setnz( state.x = state.m1 );
-      break;
-    case Opcode::RZP_LDY:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      state.setnz( state.y = state.m1 );
-      break;
-    case Opcode::RZP_ORA:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      state.setnz( state.a |= state.m1 );
-      break;
-    case Opcode::RZP_ADC:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      state.adc( state.m1 );
-      if ( state.d )
-      {
-        co_await read( state.ea );
-      }
-      break;
-    case Opcode::RZP_SBC:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      state.sbc( state.m1 );
-      if ( state.d )
-      {
-        co_await read( state.ea );
-      }
-      break;
-    case Opcode::WZP_STA:
-      ++state.pc;
-      co_await write( state.ea, state.a );
-      break;
-    case Opcode::WZP_STX:
-      ++state.pc;
-      co_await write( state.ea, state.x );
-      break;
-    case Opcode::WZP_STY:
-      ++state.pc;
-      co_await write( state.ea, state.y );
-      break;
-    case Opcode::WZP_STZ:
-      ++state.pc;
-      co_await write( state.ea, 0x00 );
-      break;
-    case Opcode::MZP_ASL:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      co_await read( state.ea );
-      state.m2 = state.asl( state.m1 );
-      co_await write( state.ea, state.m2 );
-      break;
-    case Opcode::MZP_DEC:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      co_await read( state.ea );
-      state.m2 = state.dec( state.m1 );
-      co_await write( state.ea, state.m2 );
-      break;
-    case Opcode::MZP_INC:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      co_await read( state.ea );
-      state.m2 = state.inc( state.m1 );
-      co_await write( state.ea, state.m2 );
-      break;
-    case Opcode::MZP_LSR:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      co_await read( state.ea );
-      state.m2 = state.lsr( state.m1 );
-      co_await write( state.ea, state.m2 );
-      break;
-    case Opcode::MZP_ROL:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      co_await read( state.ea );
-      state.m2 = state.rol( state.m1 );
-      co_await write( state.ea, state.m2 );
-      break;
-    case Opcode::MZP_ROR:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      co_await read( state.ea );
-      state.m2 = state.ror( state.m1 );
-      co_await write( state.ea, state.m2 );
-      break;
-    case Opcode::MZP_TRB:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      co_await read( state.ea );
-      state.setz( state.m1 & state.a );
-      state.m2 = state.m1 & ~state.a;
-      co_await write( state.ea, state.m2 );
-      break;
-    case Opcode::MZP_TSB:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      co_await read( state.ea );
-      state.setz( state.m1 & state.a );
-      state.m2 = state.m1 | state.a;
-      co_await write( state.ea, state.m2 );
-      break;
-    case Opcode::MZP_RMB0:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      co_await read( state.ea );
-      state.m2 = state.m1 & ~0x01;
-      co_await write( state.ea, state.m2 );
-      break;
-    case Opcode::MZP_RMB1:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      co_await read( state.ea );
-      state.m2 = state.m1 & ~0x02;
-      co_await write( state.ea, state.m2 );
-      break;
-    case Opcode::MZP_RMB2:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      co_await read( state.ea );
-      state.m2 = state.m1 & ~0x04;
-      co_await write( state.ea, state.m2 );
-      break;
-    case Opcode::MZP_RMB3:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      co_await read( state.ea );
-      state.m2 = state.m1 & ~0x08;
-      co_await write( state.ea, state.m2 );
-      break;
-    case Opcode::MZP_RMB4:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      co_await read( state.ea );
-      state.m2 = state.m1 & ~0x10;
-      co_await write( state.ea, state.m2 );
-      break;
-    case Opcode::MZP_RMB5:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      co_await read( state.ea );
-      state.m2 = state.m1 & ~0x20;
-      co_await write( state.ea, state.m2 );
-      break;
-    case Opcode::MZP_RMB6:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      co_await read( state.ea );
-      state.m2 = state.m1 & ~0x40;
-      co_await write( state.ea, state.m2 );
-      break;
-    case Opcode::MZP_RMB7:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      co_await read( state.ea );
-      state.m2 = state.m1 & ~0x80;
-      co_await write( state.ea, state.m2 );
-      break;
-    case Opcode::MZP_SMB0:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      co_await read( state.ea );
-      state.m2 = state.m1 | 0x01;
-      co_await write( state.ea, state.m2 );
-      break;
-    case Opcode::MZP_SMB1:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      co_await read( state.ea );
-      state.m2 = state.m1 | 0x02;
-      co_await write( state.ea, state.m2 );
-      break;
-    case Opcode::MZP_SMB2:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      co_await read( state.ea );
-      state.m2 = state.m1 | 0x04;
-      co_await write( state.ea, state.m2 );
-      break;
-    case Opcode::MZP_SMB3:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      co_await read( state.ea );
-      state.m2 = state.m1 | 0x08;
-      co_await write( state.ea, state.m2 );
-      break;
-    case Opcode::MZP_SMB4:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      co_await read( state.ea );
-      state.m2 = state.m1 | 0x10;
-      co_await write( state.ea, state.m2 );
-      break;
-    case Opcode::MZP_SMB5:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      co_await read( state.ea );
-      state.m2 = state.m1 | 0x20;
-      co_await write( state.ea, state.m2 );
-      break;
-    case Opcode::MZP_SMB6:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      co_await read( state.ea );
-      state.m2 = state.m1 | 0x40;
-      co_await write( state.ea, state.m2 );
-      break;
-    case Opcode::MZP_SMB7:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      co_await read( state.ea );
-      state.m2 = state.m1 | 0x80;
-      co_await write( state.ea, state.m2 );
-      break;
-    case Opcode::RZX_AND:
-      co_await read( ++state.pc );
-      state.tl = state.eal + state.x;
-      state.m1 = co_await read( state.t );
-      state.setnz( state.a &= state.m1 );
-      break;
-    case Opcode::RZX_BIT:
-      co_await read( ++state.pc );
-      state.tl = state.eal + state.x;
-      state.m1 = co_await read( state.t );
-      state.bit( state.m1 );
-      break;
-    case Opcode::RZX_CMP:
-      co_await read( ++state.pc );
-      state.tl = state.eal + state.x;
-      state.m1 = co_await read( state.t );
-      state.cmp( state.m1 );
-      break;
-    case Opcode::RZX_EOR:
-      co_await read( ++state.pc );
-      state.tl = state.eal + state.x;
-      state.m1 = co_await read( state.t );
-      state.setnz( state.a ^= state.m1 );
-      break;
-    case Opcode::RZX_LDA:
-      co_await read( ++state.pc );
-      state.tl = state.eal + state.x;
-      state.m1 = co_await read( state.t );
-      state.setnz( state.a = state.m1 );
-      break;
-    case Opcode::RZX_LDY:
-      co_await read( ++state.pc );
-      state.tl = state.eal + state.x;
-      state.m1 = co_await read( state.t );
-      state.setnz( state.y = state.m1 );
-      break;
-    case Opcode::RZX_ORA:
-      co_await read( ++state.pc );
-      state.tl = state.eal + state.x;
-      state.m1 = co_await read( state.t );
-      state.setnz( state.a |= state.m1 );
-      break;
-    case Opcode::RZX_ADC:
-      co_await read( ++state.pc );
-      state.tl = state.eal + state.x;
-      state.m1 = co_await read( state.t );
-      state.adc( state.m1 );
-      if ( state.d )
-      {
-        co_await read( state.t );
-      }
-      break;
-    case Opcode::RZX_SBC:
-      co_await read( ++state.pc );
-      state.tl = state.eal + state.x;
-      state.m1 = co_await read( state.t );
-      state.sbc( state.m1 );
-      if ( state.d )
-      {
-        co_await read( state.t );
-      }
-      break;
-    case Opcode::RZY_LDX:
-      co_await read( ++state.pc );
-      state.tl = state.eal + state.y;
-      state.m1 = co_await read( state.t );
-      state.setnz( state.x = state.m1 );
-      break;
-    case Opcode::WZX_STA:
-      co_await read( ++state.pc );
-      state.tl = state.eal + state.x;
-      co_await write( state.t, state.a );
-      break;
-    case Opcode::WZX_STY:
-      co_await read( ++state.pc );
-      state.tl = state.eal + state.x;
-      co_await write( state.t, state.y );
-      break;
-    case Opcode::WZX_STZ:
-      co_await read( ++state.pc );
-      state.tl = state.eal + state.x;
-      co_await write( state.t, 0x00 );
-      break;
-    case Opcode::WZY_STX:
-      co_await read( ++state.pc );
-      state.tl = state.eal + state.y;
-      co_await write( state.t, state.x );
-      break;
-    case Opcode::MZX_ASL:
-      co_await read( state.pc++ );
-      state.tl = state.eal + state.x;
-      state.m1 = co_await read( state.t );
-      co_await read( state.t );
-      state.m2 = state.asl( state.m1 );
-      co_await write( state.t, state.m2 );
-      break;
-    case Opcode::MZX_DEC:
-      co_await read( state.pc++ );
-      state.tl = state.eal + state.x;
-      state.m1 = co_await read( state.t );
-      co_await read( state.t );
-      state.m2 = state.dec( state.m1 );
-      co_await write( state.t, state.m2 );
-      break;
-    case Opcode::MZX_INC:
-      co_await read( state.pc++ );
-      state.tl = state.eal + state.x;
-      state.m1 = co_await read( state.t );
-      co_await read( state.t );
-      state.m2 = state.inc( state.m1 );
-      co_await write( state.t, state.m2 );
-      break;
-    case Opcode::MZX_LSR:
-      co_await read( state.pc++ );
-      state.tl = state.eal + state.x;
-      state.m1 = co_await read( state.t );
-      co_await read( state.t );
-      state.m2 = state.lsr( state.m1 );
-      co_await write( state.t, state.m2 );
-      break;
-    case Opcode::MZX_ROL:
-      co_await read( state.pc++ );
-      state.tl = state.eal + state.x;
-      state.m1 = co_await read( state.t );
-      co_await read( state.t );
-      state.m2 = state.rol( state.m1 );
-      co_await write( state.t, state.m2 );
-      break;
-    case Opcode::MZX_ROR:
-      co_await read( state.pc++ );
-      state.tl = state.eal + state.x;
-      state.m1 = co_await read( state.t );
-      co_await read( state.t );
-      state.m2 = state.ror( state.m1 );
-      co_await write( state.t, state.m2 );
-      break;
-    case Opcode::RIN_AND:
-      ++state.pc;
-      state.fa = state.ea;
-      state.tl = co_await read( state.ea++ );
-      state.th = co_await read( state.ea );
-      state.m1 = co_await read( state.t );
-      state.setnz( state.a &= state.m1 );
-      break;
-    case Opcode::RIN_CMP:
-      ++state.pc;
-      state.fa = state.ea;
-      state.tl = co_await read( state.ea++ );
-      state.th = co_await read( state.ea );
-      state.m1 = co_await read( state.t );
-      state.cmp( state.m1 );
-      break;
-    case Opcode::RIN_EOR:
-      ++state.pc;
-      state.fa = state.ea;
-      state.tl = co_await read( state.ea++ );
-      state.th = co_await read( state.ea );
-      state.m1 = co_await read( state.t );
-      state.setnz( state.a ^= state.m1 );
-      break;
-    case Opcode::RIN_LDA:
-      ++state.pc;
-      state.fa = state.ea;
-      state.tl = co_await read( state.ea++ );
-      state.th = co_await read( state.ea );
-      state.m1 = co_await read( state.t );
-      state.setnz( state.a = state.m1 );
-      break;
-    case Opcode::RIN_ORA:
-      ++state.pc;
-      state.fa = state.ea;
-      state.tl = co_await read( state.ea++ );
-      state.th = co_await read( state.ea );
-      state.m1 = co_await read( state.t );
-      state.setnz( state.a |= state.m1 );
-      break;
-    case Opcode::RIN_ADC:
-      ++state.pc;
-      state.fa = state.ea;
-      state.tl = co_await read( state.ea++ );
-      state.th = co_await read( state.ea );
-      state.m1 = co_await read( state.t );
-      state.adc( state.m1 );
-      if ( state.d )
-      {
-        co_await read( state.t );
-      }
-      break;
-    case Opcode::RIN_SBC:
-      ++state.pc;
-      state.fa = state.ea;
-      state.tl = co_await read( state.ea++ );
-      state.th = co_await read( state.ea );
-      state.m1 = co_await read( state.t );
-      state.sbc( state.m1 );
-      if ( state.d )
-      {
-        co_await read( state.t );
-      }
-      break;
-    case Opcode::WIN_STA:
-      ++state.pc;
-      state.fa = state.ea;
-      state.tl = co_await read( state.ea++ );
-      state.th = co_await read( state.ea );
-      co_await write( state.t, state.a );
-      break;
-    case Opcode::RIX_AND:
-      co_await read( ++state.pc );
-      state.fa = state.ea;
-      state.eal += state.x;
-      state.tl = co_await read( state.ea++ );
-      state.th = co_await read( state.ea );
-      state.m1 = co_await read( state.t );
-      state.setnz( state.a &= state.m1 );
-      break;
-    case Opcode::RIX_CMP:
-      co_await read( ++state.pc );
-      state.fa = state.ea;
-      state.eal += state.x;
-      state.tl = co_await read( state.ea++ );
-      state.th = co_await read( state.ea );
-      state.m1 = co_await read( state.t );
-      state.cmp( state.m1 );
-      break;
-    case Opcode::RIX_EOR:
-      co_await read( ++state.pc );
-      state.fa = state.ea;
-      state.eal += state.x;
-      state.tl = co_await read( state.ea++ );
-      state.th = co_await read( state.ea );
-      state.m1 = co_await read( state.t );
-      state.setnz( state.a ^= state.m1 );
-      break;
-    case Opcode::RIX_LDA:
-      co_await read( ++state.pc );
-      state.fa = state.ea;
-      state.eal += state.x;
-      state.tl = co_await read( state.ea++ );
-      state.th = co_await read( state.ea );
-      state.m1 = co_await read( state.t );
-      state.setnz( state.a = state.m1 );
-      break;
-    case Opcode::RIX_ORA:
-      co_await read( ++state.pc );
-      state.fa = state.ea;
-      state.eal += state.x;
-      state.tl = co_await read( state.ea++ );
-      state.th = co_await read( state.ea );
-      state.m1 = co_await read( state.t );
-      state.setnz( state.a |= state.m1 );
-      break;
-    case Opcode::RIX_ADC:
-      co_await read( ++state.pc );
-      state.fa = state.ea;
-      state.eal += state.x;
-      state.tl = co_await read( state.ea++ );
-      state.th = co_await read( state.ea );
-      state.m1 = co_await read( state.t );
-      state.adc( state.m1 );
-      if ( state.d )
-      {
-        co_await read( state.t );
-      }
-      break;
-    case Opcode::RIX_SBC:
-      co_await read( ++state.pc );
-      state.fa = state.ea;
-      state.eal += state.x;
-      state.tl = co_await read( state.ea++ );
-      state.th = co_await read( state.ea );
-      state.m1 = co_await read( state.t );
-      state.sbc( state.m1 );
-      if ( state.d )
-      {
-        co_await read( state.t );
-      }
-      break;
-    case Opcode::WIX_STA:
-      co_await read( ++state.pc );
-      state.fa = state.ea;
-      state.eal += state.x;
-      state.tl = co_await read( state.ea++ );
-      state.th = co_await read( state.ea );
-      co_await write( state.t, state.a );
-      break;
-    case Opcode::RIY_AND:
-      co_await read( ++state.pc );
-      state.fa = state.ea;
-      state.tl = co_await read( state.ea++ );
-      state.th = co_await read( state.ea );
-      state.ea = state.t;
-      state.ea += state.y;
-      if ( state.eah != state.th )
-      {
-        state.tl += state.y;
-        co_await read( state.t );
-      }
-      state.m1 = co_await read( state.ea );
-      state.setnz( state.a &= state.m1 );
-      break;
-    case Opcode::RIY_CMP:
-      co_await read( ++state.pc );
-      state.fa = state.ea;
-      state.tl = co_await read( state.ea++ );
-      state.th = co_await read( state.ea );
-      state.ea = state.t;
-      state.ea += state.y;
-      if ( state.eah != state.th )
-      {
-        state.tl += state.y;
-        co_await read( state.t );
-      }
-      state.m1 = co_await read( state.ea );
-      state.cmp( state.m1 );
-      break;
-    case Opcode::RIY_EOR:
-      co_await read( ++state.pc );
-      state.fa = state.ea;
-      state.tl = co_await read( state.ea++ );
-      state.th = co_await read( state.ea );
-      state.ea = state.t;
-      state.ea += state.y;
-      if ( state.eah != state.th )
-      {
-        state.tl += state.y;
-        co_await read( state.t );
-      }
-      state.m1 = co_await read( state.ea );
-      state.setnz( state.a ^= state.m1 );
-      break;
-    case Opcode::RIY_LDA:
-      co_await read( ++state.pc );
-      state.fa = state.ea;
-      state.tl = co_await read( state.ea++ );
-      state.th = co_await read( state.ea );
-      state.ea = state.t;
-      state.ea += state.y;
-      if ( state.eah != state.th )
-      {
-        state.tl += state.y;
-        co_await read( state.t );
-      }
-      state.m1 = co_await read( state.ea );
-      state.setnz( state.a = state.m1 );
-      break;
-    case Opcode::RIY_ORA:
-      co_await read( ++state.pc );
-      state.fa = state.ea;
-      state.tl = co_await read( state.ea++ );
-      state.th = co_await read( state.ea );
-      state.ea = state.t;
-      state.ea += state.y;
-      if ( state.eah != state.th )
-      {
-        state.tl += state.y;
-        co_await read( state.t );
-      }
-      state.m1 = co_await read( state.ea );
-      state.setnz( state.a |= state.m1 );
-      break;
-    case Opcode::RIY_ADC:
-      co_await read( ++state.pc );
-      state.fa = state.ea;
-      state.tl = co_await read( state.ea++ );
-      state.th = co_await read( state.ea );
-      state.ea = state.t;
-      state.ea += state.y;
-      if ( state.eah != state.th )
-      {
-        state.tl += state.y;
-        co_await read( state.t );
-      }
-      state.m1 = co_await read( state.ea );
-      state.adc( state.m1 );
-      if ( state.d )
-      {
-        co_await read( state.t );
-      }
-      break;
-    case Opcode::RIY_SBC:
-      co_await read( ++state.pc );
-      state.fa = state.ea;
-      state.tl = co_await read( state.ea++ );
-      state.th = co_await read( state.ea );
-      state.ea = state.t;
-      state.ea += state.y;
-      if ( state.eah != state.th )
-      {
-        state.tl += state.y;
-        co_await read( state.t );
-      }
-      state.m1 = co_await read( state.ea );
-      state.sbc( state.m1 );
-      if ( state.d )
-      {
-        co_await read( state.t );
-      }
-      break;
-    case Opcode::WIY_STA:
-      co_await read( ++state.pc );
-      state.fa = state.ea;
-      state.tl = co_await read( state.ea++ );
-      state.th = co_await read( state.ea );
-      state.ea = state.t;
-      state.ea += state.y;
-      state.tl += state.y;
-      co_await read( state.t );
-      co_await write( state.ea, state.a );
-      break;
-    case Opcode::RAB_AND:
-      ++state.pc;
-      state.eah = co_await fetchOperand( state.pc++ );
-      state.m1 = co_await read( state.ea );
-      state.setnz( state.a &= state.m1 );
-      break;
-    case Opcode::RAB_BIT:
-      ++state.pc;
-      state.eah = co_await fetchOperand( state.pc++ );
-      state.m1 = co_await read( state.ea );
-      state.bit( state.m1 );
-      break;
-    case Opcode::RAB_CMP:
-      ++state.pc;
-      state.eah = co_await fetchOperand( state.pc++ );
-      state.m1 = co_await read( state.ea );
-      state.cmp( state.m1 );
-      break;
-    case Opcode::RAB_CPX:
-      ++state.pc;
-      state.eah = co_await fetchOperand( state.pc++ );
-      state.m1 = co_await read( state.ea );
-      state.cpx( state.m1 );
-      break;
-    case Opcode::RAB_CPY:
-      ++state.pc;
-      state.eah = co_await fetchOperand( state.pc++ );
-      state.m1 = co_await read( state.ea );
-      state.cpy( state.m1 );
-      break;
-    case Opcode::RAB_EOR:
-      ++state.pc;
-      state.eah = co_await fetchOperand( state.pc++ );
-      state.m1 = co_await read( state.ea );
-      state.setnz( state.a ^= state.m1 );
-      break;
-    case Opcode::RAB_LDA:
-      ++state.pc;
-      state.eah = co_await fetchOperand( state.pc++ );
-      state.m1 = co_await read( state.ea );
-      state.setnz( state.a = state.m1 );
-      break;
-    case Opcode::RAB_LDX:
-      ++state.pc;
-      state.eah = co_await fetchOperand( state.pc++ );
-      state.m1 = co_await read( state.ea );
-      state.setnz( state.x = state.m1 );
-      break;
-    case Opcode::RAB_LDY:
-      ++state.pc;
-      state.eah = co_await fetchOperand( state.pc++ );
-      state.m1 = co_await read( state.ea );
-      state.setnz( state.y = state.m1 );
-      break;
-    case Opcode::RAB_ORA:
-      ++state.pc;
-      state.eah = co_await fetchOperand( state.pc++ );
-      state.m1 = co_await read( state.ea );
-      state.setnz( state.a |= state.m1 );
-      break;
-    case Opcode::RAB_ADC:
-      ++state.pc;
-      state.eah = co_await fetchOperand( state.pc++ );
-      state.m1 = co_await read( state.ea );
-      state.adc( state.m1 );
-      if ( state.d )
-      {
-        co_await read( state.ea );
-      }
-      break;
-    case Opcode::RAB_SBC:
-      ++state.pc;
-      state.eah = co_await fetchOperand( state.pc++ );
-      state.m1 = co_await read( state.ea );
-      state.sbc( state.m1 );
-      if ( state.d )
-      {
-        co_await read( state.ea );
-      }
-      break;
-    case Opcode::WAB_STA:
-      ++state.pc;
-      state.eah = co_await fetchOperand( state.pc++ );
-      co_await write( state.ea, state.a );
-      break;
-    case Opcode::WAB_STX:
-      ++state.pc;
-      state.eah = co_await fetchOperand( state.pc++ );
-      co_await write( state.ea, state.x );
-      break;
-    case Opcode::WAB_STY:
-      ++state.pc;
-      state.eah = co_await fetchOperand( state.pc++ );
-      co_await write( state.ea, state.y );
-      break;
-    case Opcode::WAB_STZ:
-      ++state.pc;
-      state.eah = co_await fetchOperand( state.pc++ );
-      co_await write( state.ea, 0x00 );
-      break;
-    case Opcode::MAB_ASL:
-      ++state.pc;
-      state.eah = co_await fetchOperand( state.pc++ );
-      state.m1 = co_await read( state.ea );
-      co_await read( state.ea );
-      state.m2 = state.asl( state.m1 );
-      co_await write( state.ea, state.m2 );
-      break;
-    case Opcode::MAB_DEC:
-      ++state.pc;
-      state.eah = co_await fetchOperand( state.pc++ );
-      state.m1 = co_await read( state.ea );
-      co_await read( state.ea );
-      state.m2 = state.dec( state.m1 );
-      co_await write( state.ea, state.m2 );
-      break;
-    case Opcode::MAB_INC:
-      ++state.pc;
-      state.eah = co_await fetchOperand( state.pc++ );
-      state.m1 = co_await read( state.ea );
-      co_await read( state.ea );
-      state.m2 = state.inc( state.m1 );
-      co_await write( state.ea, state.m2 );
-      break;
-    case Opcode::MAB_LSR:
-      ++state.pc;
-      state.eah = co_await fetchOperand( state.pc++ );
-      state.m1 = co_await read( state.ea );
-      co_await read( state.ea );
-      state.m2 = state.lsr( state.m1 );
-      co_await write( state.ea, state.m2 );
-      break;
-    case Opcode::MAB_ROL:
-      ++state.pc;
-      state.eah = co_await fetchOperand( state.pc++ );
-      state.m1 = co_await read( state.ea );
-      co_await read( state.ea );
-      state.m2 = state.rol( state.m1 );
-      co_await write( state.ea, state.m2 );
-      break;
-    case Opcode::MAB_ROR:
-      ++state.pc;
-      state.eah = co_await fetchOperand( state.pc++ );
-      state.m1 = co_await read( state.ea );
-      co_await read( state.ea );
-      state.m2 = state.ror( state.m1 );
-      co_await write( state.ea, state.m2 );
-      break;
-    case Opcode::MAB_TRB:
-      ++state.pc;
-      state.eah = co_await fetchOperand( state.pc++ );
-      state.m1 = co_await read( state.ea );
-      co_await read( state.ea );
-      state.setz( state.m1 & state.a );
-      state.m2 = state.m1 & ~state.a;
-      co_await write( state.ea, state.m2 );
-      break;
-    case Opcode::MAB_TSB:
-      ++state.pc;
-      state.eah = co_await fetchOperand( state.pc++ );
-      state.m1 = co_await read( state.ea );
-      co_await read( state.ea );
-      state.setz( state.m1 & state.a );
-      state.m2 = state.m1 | state.a;
-      co_await write( state.ea, state.m2 );
-      break;
-    case Opcode::RAX_AND:
-      state.eah = co_await fetchOperand( state.pc + 1 );
-      state.fa = state.ea + state.x;
-      if ( state.eah != state.fah )
-      {
-        co_await read( state.pc + 1 );
-      }
-      state.m1 = co_await read( state.fa );
-      state.setnz( state.a &= state.m1 );
-      state.pc += 2;
-      break;
-    case Opcode::RAX_BIT:
-      state.eah = co_await fetchOperand( state.pc + 1 );
-      state.fa = state.ea + state.x;
-      if ( state.eah != state.fah )
-      {
-        co_await read( state.pc + 1 );
-      }
-      state.m1 = co_await read( state.fa );
-      state.bit( state.m1 );
-      state.pc += 2;
-      break;
-    case Opcode::RAX_CMP:
-      state.eah = co_await fetchOperand( state.pc + 1 );
-      state.fa = state.ea + state.x;
-      if ( state.eah != state.fah )
-      {
-        co_await read( state.pc + 1 );
-      }
-      state.m1 = co_await read( state.fa );
-      state.cmp( state.m1 );
-      state.pc += 2;
-      break;
-    case Opcode::RAX_EOR:
-      state.eah = co_await fetchOperand( state.pc + 1 );
-      state.fa = state.ea + state.x;
-      if ( state.eah != state.fah )
-      {
-        co_await read( state.pc + 1 );
-      }
-      state.m1 = co_await read( state.fa );
-      state.setnz( state.a ^= state.m1 );
-      state.pc += 2;
-      break;
-    case Opcode::RAX_LDA:
-      state.eah = co_await fetchOperand( state.pc + 1 );
-      state.fa = state.ea + state.x;
-      if ( state.eah != state.fah )
-      {
-        co_await read( state.pc + 1 );
-      }
-      state.m1 = co_await read( state.fa );
-      state.setnz( state.a = state.m1 );
-      state.pc += 2;
-      break;
-    case Opcode::RAX_LDY:
-      state.eah = co_await fetchOperand( state.pc + 1 );
-      state.fa = state.ea + state.x;
-      if ( state.eah != state.fah )
-      {
-        co_await read( state.pc + 1 );
-      }
-      state.m1 = co_await read( state.fa );
-      state.setnz( state.y = state.m1 );
-      state.pc += 2;
-      break;
-    case Opcode::RAX_ORA:
-      state.eah = co_await fetchOperand( state.pc + 1 );
-      state.fa = state.ea + state.x;
-      if ( state.eah != state.fah )
-      {
-        co_await read( state.pc + 1 );
-      }
-      state.m1 = co_await read( state.fa );
-      state.setnz( state.a |= state.m1 );
-      state.pc += 2;
-      break;
-    case Opcode::RAX_ADC:
-      state.eah = co_await fetchOperand( state.pc + 1 );
-      state.fa = state.ea + state.x;
-      if ( state.eah != state.fah )
-      {
-        co_await read( state.pc + 1 );
-      }
-      state.m1 = co_await read( state.fa );
-      state.adc( state.m1 );
-      if ( state.d )
-      {
-        co_await read( state.fa );
-      }
-      state.pc += 2;
-      break;
-    case Opcode::RAX_SBC:
-      state.eah = co_await fetchOperand( state.pc + 1 );
-      state.fa = state.ea + state.x;
-      if ( state.eah != state.fah )
-      {
-        co_await read( state.pc + 1 );
-      }
-      state.m1 = co_await read( state.fa );
-      state.sbc( state.m1 );
-      if ( state.d )
-      {
-        co_await read( state.fa );
-      }
-      state.pc += 2;
-      break;
-    case Opcode::RAY_AND:
-      state.eah = co_await fetchOperand( state.pc + 1 );
-      state.fa = state.ea + state.y;
-      if ( state.eah != state.fah )
-      {
-        co_await read( state.pc + 1 );
-      }
-      state.m1 = co_await read( state.fa );
-      state.setnz( state.a &= state.m1 );
-      state.pc += 2;
-      break;
-    case Opcode::RAY_CMP:
-      state.eah = co_await fetchOperand( state.pc + 1 );
-      state.fa = state.ea + state.y;
-      if ( state.eah != state.fah )
-      {
-        co_await read( state.pc + 1 );
-      }
-      state.m1 = co_await read( state.fa );
-      state.cmp( state.m1 );
-      state.pc += 2;
-      break;
-    case Opcode::RAY_EOR:
-      state.eah = co_await fetchOperand( state.pc + 1 );
-      state.fa = state.ea + state.y;
-      if ( state.eah != state.fah )
-      {
-        co_await read( state.pc + 1 );
-      }
-      state.m1 = co_await read( state.fa );
-      state.setnz( state.a ^= state.m1 );
-      state.pc += 2;
-      break;
-    case Opcode::RAY_LDA:
-      state.eah = co_await fetchOperand( state.pc + 1 );
-      state.fa = state.ea + state.y;
-      if ( state.eah != state.fah )
-      {
-        co_await read( state.pc + 1 );
-      }
-      state.m1 = co_await read( state.fa );
-      state.setnz( state.a = state.m1 );
-      state.pc += 2;
-      break;
-    case Opcode::RAY_LDX:
-      state.eah = co_await fetchOperand( state.pc + 1 );
-      state.fa = state.ea + state.y;
-      if ( state.eah != state.fah )
-      {
-        co_await read( state.pc + 1 );
-      }
-      state.m1 = co_await read( state.fa );
-      state.setnz( state.x = state.m1 );
-      state.pc += 2;
-      break;
-    case Opcode::RAY_ORA:
-      state.eah = co_await fetchOperand( state.pc + 1 );
-      state.fa = state.ea + state.y;
-      if ( state.eah != state.fah )
-      {
-        co_await read( state.pc + 1 );
-      }
-      state.m1 = co_await read( state.fa );
-      state.setnz( state.a |= state.m1 );
-      state.pc += 2;
-      break;
-    case Opcode::RAY_ADC:
-      state.eah = co_await fetchOperand( state.pc + 1 );
-      state.fa = state.ea + state.y;
-      if ( state.eah != state.fah )
-      {
-        co_await read( state.pc + 1 );
-      }
-      state.m1 = co_await read( state.fa );
-      state.adc( state.m1 );
-      if ( state.d )
-      {
-        co_await read( state.ea );
-      }
-      state.pc += 2;
-      break;
-    case Opcode::RAY_SBC:
-      state.eah = co_await fetchOperand( state.pc + 1 );
-      state.fa = state.ea + state.y;
-      if ( state.eah != state.fah )
-      {
-        co_await read( state.pc + 1 );
-      }
-      state.m1 = co_await read( state.fa );
-      state.sbc( state.m1 );
-      if ( state.d )
-      {
-        co_await read( state.ea );
-      }
-      state.pc += 2;
-      break;
-    case Opcode::WAX_STA:
-      state.eah = co_await fetchOperand( state.pc + 1 );
-      state.fa = state.ea + state.x;
-      co_await read( state.pc + 1 );
-      co_await write( state.fa, state.a );
-      state.pc += 2;
-      break;
-    case Opcode::WAX_STZ:
-      state.eah = co_await fetchOperand( state.pc + 1 );
-      state.fa = state.ea + state.x;
-      co_await read( state.pc + 1 );
-      co_await write( state.fa, 0x00 );
-      state.pc += 2;
-      break;
-    case Opcode::WAY_STA:
-      state.eah = co_await fetchOperand( state.pc + 1 );
-      state.fa = state.ea + state.y;
-      co_await read( state.pc + 1 );
-      co_await write( state.fa, state.a );
-      state.pc += 2;
-      break;
-    case Opcode::MAX_ASL:
-      state.eah = co_await fetchOperand( state.pc + 1 );
-      state.fa = state.ea + state.x;
-      if ( state.eah != state.fah )
-      {
-        co_await read( state.pc + 1 );
-      }
-      state.m1 = co_await read( state.fa );
-      co_await read( state.fa );
-      state.m2 = state.asl( state.m1 );
-      co_await write( state.fa, state.m2 );
-      state.pc += 2;
-      break;
-    case Opcode::MAX_DEC:
-      state.eah = co_await fetchOperand( state.pc + 1 );
-      state.fa = state.ea + state.x;
-      if ( state.eah != state.fah )
-      {
-        co_await read( state.pc + 1 );
-      }
-      state.m1 = co_await read( state.fa );
-      co_await read( state.fa );
-      state.m2 = state.dec( state.m1 );
-      co_await write( state.fa, state.m2 );
-      state.pc += 2;
-      break;
-    case Opcode::MAX_INC:
-      state.eah = co_await fetchOperand( state.pc + 1 );
-      state.fa = state.ea + state.x;
-      if ( state.eah != state.fah )
-      {
-        co_await read( state.pc + 1 );
-      }
-      state.m1 = co_await read( state.fa );
-      co_await read( state.fa );
-      state.m2 = state.inc( state.m1 );
-      co_await write( state.fa, state.m2 );
-      state.pc += 2;
-      break;
-    case Opcode::MAX_LSR:
-      state.eah = co_await fetchOperand( state.pc + 1 );
-      state.fa = state.ea + state.x;
-      if ( state.eah != state.fah )
-      {
-        co_await read( state.pc + 1 );
-      }
-      state.m1 = co_await read( state.fa );
-      co_await read( state.fa );
-      state.m2 = state.lsr( state.m1 );
-      co_await write( state.fa, state.m2 );
-      state.pc += 2;
-      break;
-    case Opcode::MAX_ROL:
-      state.eah = co_await fetchOperand( state.pc + 1 );
-      state.fa = state.ea + state.x;
-      if ( state.eah != state.fah )
-      {
-        co_await read( state.pc + 1 );
-      }
-      state.m1 = co_await read( state.fa );
-      co_await read( state.fa );
-      state.m2 = state.rol( state.m1 );
-      co_await write( state.fa, state.m2 );
-      state.pc += 2;
-      break;
-    case Opcode::MAX_ROR:
-      state.eah = co_await fetchOperand( state.pc + 1 );
-      state.fa = state.ea + state.x;
-      if ( state.eah != state.fah )
-      {
-        co_await read( state.pc + 1 );
-      }
-      state.m1 = co_await read( state.fa );
-      co_await read( state.fa );
-      state.m2 = state.ror( state.m1 );
-      co_await write( state.fa, state.m2 );
-      state.pc += 2;
-      break;
-    case Opcode::JMA_JMP:
-      ++state.pc;
-      state.eah = co_await fetchOperand( state.pc++ );
-      state.pc = state.ea;
-      break;
-    case Opcode::JSA_JSR:
-      ++state.pc;
-      co_await read( state.s );
-      co_await write( state.s, state.pch );
-      state.sl--;
-      co_await write( state.s, state.pcl );
-      state.sl--;
-      state.eah = co_await fetchOperand( state.pc++ );
-      state.pc = state.ea;
-      if ( mReq.cpuBreakType == CpuBreakType::STEP_OVER )
-      {
-        mReq.cpuBreakType = CpuBreakType::NONE;
-        mStackBreakCondition = state.s;
-      }
-      break;
-    case Opcode::JMX_JMP:
-      ++state.pc;
-      state.eah = co_await fetchOperand( state.pc++ );
-      co_await read( state.pc );
-      state.fa = state.t = state.ea;
-      state.eal += state.x;
-      co_await read( state.ea );
-      state.t += state.x;
-      state.eal = co_await read( state.t++ );
-      state.eah = co_await read( state.t );
-      state.pc = state.ea;
-      break;
-    case Opcode::JMI_JMP:
-      ++state.pc;
-      state.eah = co_await fetchOperand( state.pc++ );
-      state.fa = state.tl = co_await read( state.ea );
-      state.eal++;
-      co_await read( state.ea );
-      state.eah += state.eal == 0 ? 1 : 0;
-      state.th = co_await read( state.ea );
-      state.pc = state.t;
-      break;
-    case Opcode::IMP_ASL:
-      state.a = state.asl( state.a );
-      break;
-    case Opcode::IMP_CLC:
-      state.c.clear();
-      break;
-    case Opcode::IMP_CLD:
-      state.d.clear();
-      break;
-    case Opcode::IMP_CLI:
-      state.i.clear();
-      break;
-    case Opcode::IMP_CLV:
-      state.v.clear();
-      break;
-    case Opcode::IMP_DEC:
-      state.a = state.dec( state.a );
-      break;
-    case Opcode::IMP_DEX:
-      state.x = state.dec( state.x );
-      break;
-    case Opcode::IMP_DEY:
-      state.y = state.dec( state.y );
-      break;
-    case Opcode::IMP_INC:
-      state.a = state.inc( state.a );
-      break;
-    case Opcode::IMP_INX:
-      state.x = state.inc( state.x );
-      break;
-    case Opcode::IMP_INY:
-      state.y = state.inc( state.y );
-      break;
-    case Opcode::IMP_LSR:
-      state.a = state.lsr( state.a );
-      break;
-    case Opcode::IMP_NOP:
-      break;
-    case Opcode::IMP_ROL:
-      state.a = state.rol( state.a );
-      break;
-    case Opcode::IMP_ROR:
-      state.a = state.ror( state.a );
-      break;
-    case Opcode::IMP_SEC:
-      state.c.set();
-      break;
-    case Opcode::IMP_SED:
-      state.d.set();
-      break;
-    case Opcode::IMP_SEI:
-      state.i.set();
-      break;
-    case Opcode::IMP_TAX:
-      state.setnz( state.x = state.a );
-      break;
-    case Opcode::IMP_TAY:
-      state.setnz( state.y = state.a );
-      break;
-    case Opcode::IMP_TSX:
-      state.setnz( state.x = state.sl );
-      break;
-    case Opcode::IMP_TXA:
-      state.setnz( state.a = state.x );
-      break;
-    case Opcode::IMP_TXS:
-      state.sl = state.x;
-      break;
-    case Opcode::IMP_TYA:
-      state.setnz( state.a = state.y );
-      break;
-    case Opcode::IMM_AND:
-      ++state.pc;
-      state.setnz( state.a &= state.eal );
-      break;
-    case Opcode::IMM_BIT:
-      ++state.pc;
-      state.setz( state.a & state.eal );
-      break;
-    case Opcode::IMM_CMP:
-      ++state.pc;
-      state.cmp( state.eal );
-      break;
-    case Opcode::IMM_CPX:
-      ++state.pc;
-      state.cpx( state.eal );
-      break;
-    case Opcode::IMM_CPY:
-      ++state.pc;
-      state.cpy( state.eal );
-      break;
-    case Opcode::IMM_EOR:
-      ++state.pc;
-      state.setnz( state.a ^= state.eal );
-      break;
-    case Opcode::IMM_LDA:
-      ++state.pc;
-      state.setnz( state.a = state.eal );
-      break;
-    case Opcode::IMM_LDX:
-      ++state.pc;
-      state.setnz( state.x = state.eal );
-      break;
-    case Opcode::IMM_LDY:
-      ++state.pc;
-      state.setnz( state.y = state.eal );
-      break;
-    case Opcode::IMM_ORA:
-      ++state.pc;
-      state.setnz( state.a |= state.eal );
-      break;
-    case Opcode::IMM_ADC:
-      ++state.pc;
-      state.adc( state.eal );
-      if ( state.d )
-      {
-        co_await read( state.pc );
-      }
-      break;
-    case Opcode::IMM_SBC:
-      ++state.pc;
-      state.sbc( state.eal );
-      if ( state.d )
-      {
-        co_await read( state.pc );
-      }
-      break;
-    case Opcode::BRL_BCC:
-      ++state.pc;
-      state.t = state.pc + ( int8_t )state.eal;
-      if ( !state.c )
-      {
-        co_await read( state.pc );
-        if ( state.th != state.pch )
-        {
-          co_await read( state.pc );
-        }
-        state.pc = state.t;
-      }
-      break;
-    case Opcode::BRL_BCS:
-      ++state.pc;
-      state.t = state.pc + ( int8_t )state.eal;
-      if ( state.c )
-      {
-        co_await read( state.pc );
-        if ( state.th != state.pch )
-        {
-          co_await read( state.pc );
-        }
-        state.pc = state.t;
-      }
-      break;
-    case Opcode::BRL_BEQ:
-      ++state.pc;
-      state.t = state.pc + ( int8_t )state.eal;
-      if ( state.z )
-      {
-        co_await read( state.pc );
-        if ( state.th != state.pch )
-        {
-          co_await read( state.pc );
-        }
-        state.pc = state.t;
-      }
-      break;
-    case Opcode::BRL_BMI:
-      ++state.pc;
-      state.t = state.pc + ( int8_t )state.eal;
-      if ( state.n )
-      {
-        co_await read( state.pc );
-        if ( state.th != state.pch )
-        {
-          co_await read( state.pc );
-        }
-        state.pc = state.t;
-      }
-      break;
-    case Opcode::BRL_BNE:
-      ++state.pc;
-      state.t = state.pc + ( int8_t )state.eal;
-      if ( !state.z )
-      {
-        co_await read( state.pc );
-        if ( state.th != state.pch )
-        {
-          co_await read( state.pc );
-        }
-        state.pc = state.t;
-      }
-      break;
-    case Opcode::BRL_BPL:
-      ++state.pc;
-      state.t = state.pc + ( int8_t )state.eal;
-      if ( !state.n )
-      {
-        co_await read( state.pc );
-        if ( state.th != state.pch )
-        {
-          co_await read( state.pc );
-        }
-        state.pc = state.t;
-      }
-      break;
-    case Opcode::BRL_BRA:
-      co_await read( ++state.pc );
-      state.t = state.pc + ( int8_t )state.eal;
-      if ( state.th != state.pch )
-      {
-        co_await read( state.pc );
-      }
-      state.pc = state.t;
-      break;
-    case Opcode::BRL_BVC:
-      ++state.pc;
-      state.t = state.pc + ( int8_t )state.eal;
-      if ( !state.v )
-      {
-        co_await read( state.pc );
-        if ( state.th != state.pch )
-        {
-          co_await read( state.pc );
-        }
-        state.pc = state.t;
-      }
-      break;
-    case Opcode::BRL_BVS:
-      ++state.pc;
-      state.t = state.pc + ( int8_t )state.eal;
-      if ( state.v )
-      {
-        co_await read( state.pc );
-        if ( state.th != state.pch )
-        {
-          co_await read( state.pc );
-        }
-        state.pc = state.t;
-      }
-      break;
-    case Opcode::BZR_BBR0:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      state.tl = co_await fetchOperand( state.pc++ );
-      co_await read( state.ea );
-      state.t = state.pc + ( int8_t )state.tl;
-      if ( ( state.m1 & 0x01 ) == 0 )
-      {
-        state.pc = state.t;
-      }
-      break;
-    case Opcode::BZR_BBR1:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      state.tl = co_await fetchOperand( state.pc++ );
-      co_await read( state.ea );
-      state.t = state.pc + ( int8_t )state.tl;
-      if ( ( state.m1 & 0x02 ) == 0 )
-      {
-        state.pc = state.t;
-      }
-      break;
-    case Opcode::BZR_BBR2:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      state.tl = co_await fetchOperand( state.pc++ );
-      co_await read( state.ea );
-      state.t = state.pc + ( int8_t )state.tl;
-      if ( ( state.m1 & 0x04 ) == 0 )
-      {
-        state.pc = state.t;
-      }
-      break;
-    case Opcode::BZR_BBR3:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      state.tl = co_await fetchOperand( state.pc++ );
-      co_await read( state.ea );
-      state.t = state.pc + ( int8_t )state.tl;
-      if ( ( state.m1 & 0x08 ) == 0 )
-      {
-        state.pc = state.t;
-      }
-      break;
-    case Opcode::BZR_BBR4:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      state.tl = co_await fetchOperand( state.pc++ );
-      co_await read( state.ea );
-      state.t = state.pc + ( int8_t )state.tl;
-      if ( ( state.m1 & 0x10 ) == 0 )
-      {
-        state.pc = state.t;
-      }
-      break;
-    case Opcode::BZR_BBR5:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      state.tl = co_await fetchOperand( state.pc++ );
-      co_await read( state.ea );
-      state.t = state.pc + ( int8_t )state.tl;
-      if ( ( state.m1 & 0x20 ) == 0 )
-      {
-        state.pc = state.t;
-      }
-      break;
-    case Opcode::BZR_BBR6:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      state.tl = co_await fetchOperand( state.pc++ );
-      co_await read( state.ea );
-      state.t = state.pc + ( int8_t )state.tl;
-      if ( ( state.m1 & 0x40 ) == 0 )
-      {
-        state.pc = state.t;
-      }
-      break;
-    case Opcode::BZR_BBR7:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      state.tl = co_await fetchOperand( state.pc++ );
-      co_await read( state.ea );
-      state.t = state.pc + ( int8_t )state.tl;
-      if ( ( state.m1 & 0x80 ) == 0 )
-      {
-        state.pc = state.t;
-      }
-      break;
-    case Opcode::BZR_BBS0:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      state.tl = co_await fetchOperand( state.pc++ );
-      co_await read( state.ea );
-      state.t = state.pc + ( int8_t )state.tl;
-      if ( ( state.m1 & 0x01 ) != 0 )
-      {
-        state.pc = state.t;
-      }
-      break;
-    case Opcode::BZR_BBS1:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      state.tl = co_await fetchOperand( state.pc++ );
-      co_await read( state.ea );
-      state.t = state.pc + ( int8_t )state.tl;
-      if ( ( state.m1 & 0x02 ) != 0 )
-      {
-        state.pc = state.t;
-      }
-      break;
-    case Opcode::BZR_BBS2:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      state.tl = co_await fetchOperand( state.pc++ );
-      co_await read( state.ea );
-      state.t = state.pc + ( int8_t )state.tl;
-      if ( ( state.m1 & 0x04 ) != 0 )
-      {
-        state.pc = state.t;
-      }
-      break;
-    case Opcode::BZR_BBS3:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      state.tl = co_await fetchOperand( state.pc++ );
-      co_await read( state.ea );
-      state.t = state.pc + ( int8_t )state.tl;
-      if ( ( state.m1 & 0x08 ) != 0 )
-      {
-        state.pc = state.t;
-      }
-      break;
-    case Opcode::BZR_BBS4:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      state.tl = co_await fetchOperand( state.pc++ );
-      co_await read( state.ea );
-      state.t = state.pc + ( int8_t )state.tl;
-      if ( ( state.m1 & 0x10 ) != 0 )
-      {
-        state.pc = state.t;
-      }
-      break;
-    case Opcode::BZR_BBS5:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      state.tl = co_await fetchOperand( state.pc++ );
-      co_await read( state.ea );
-      state.t = state.pc + ( int8_t )state.tl;
-      if ( ( state.m1 & 0x20 ) != 0 )
-      {
-        state.pc = state.t;
-      }
-      break;
-    case Opcode::BZR_BBS6:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      state.tl = co_await fetchOperand( state.pc++ );
-      co_await read( state.ea );
-      state.t = state.pc + ( int8_t )state.tl;
-      if ( ( state.m1 & 0x40 ) != 0 )
-      {
-        state.pc = state.t;
-      }
-      break;
-    case Opcode::BZR_BBS7:
-      ++state.pc;
-      state.m1 = co_await read( state.ea );
-      state.tl = co_await fetchOperand( state.pc++ );
-      co_await read( state.ea );
-      state.t = state.pc + ( int8_t )state.tl;
-      if ( ( state.m1 & 0x80 ) != 0 )
-      {
-        state.pc = state.t;
-      }
-      break;
-    case Opcode::BRK_BRK:
-      if ( state.interrupt & CPUState::I_RESET )
-      {
-        co_await read( state.s );
-        state.sl--;
-        co_await read( state.s );
-        state.sl--;
-        co_await read( state.s );
-        state.sl--;
-        state.eal = co_await read( RESET_VECTOR );
-        state.eah = co_await read( RESET_VECTOR + 1 );
-      }
-      else
-      {
-        //on state.interrupt PC should point to interrupted instruction
-        if ( state.interrupt )
-        {
-          state.pc -= 1;
-        }
-        //on BRK PC should point past BRK argument
-        else
-        {
-          state.pc += 1;
-          //BRK is treated as NOP if mBreakOnBrk is true
-          if ( mBreakOnBrk )
-          {
-            mReq.cpuBreakType = CpuBreakType::BRK_INSTRUCTION;
-            break;
-          }
-          // "brk #$42" will be ignored
-          if (state.ea == 0x42)
-          {
-              mReq.cpuBreakType = CpuBreakType::NONE;
-              break;
-          }
-        }
-        co_await write( state.s, state.pch );
-        state.sl--;
-        co_await write( state.s, state.pcl );
-        state.sl--;
-        co_await write( state.s, state.getP() );
-        state.sl--;
-        if ( state.interrupt & CPUState::I_NMI )
-        {
-          state.eal = co_await read( NMI_VECTOR );
-          state.eah = co_await read( NMI_VECTOR + 1 );
-        }
-        else
-        {
-          state.eal = co_await read( IRQ_VECTOR );
-          state.eah = co_await read( IRQ_VECTOR + 1 );
-        }
-        state.i.set();
-      }
-      state.d.clear();
-      state.pc = state.ea;
-      if ( mReq.cpuBreakType == CpuBreakType::STEP_OVER )
-      {
-        mReq.cpuBreakType = CpuBreakType::NONE;
-        mStackBreakCondition = state.s;
-      }
-      break;
-    case Opcode::RTI_RTI:
-      ++state.pc;
-      ++state.sl;
-      state.setP( co_await read( state.s ) );
-      ++state.sl;
-      state.eal = co_await read( state.s );
-      ++state.sl;
-      state.eah = co_await read( state.s );
-      if ( mStackBreakCondition < state.s )
-      {
-        mReq.cpuBreakType = mPostponedStepOut ? CpuBreakType::STEP_OUT : CpuBreakType::STEP_OVER;
-        mPostponedStepOut = false;
-        mStackBreakCondition = 0xffff;
-      }
-      co_await read( state.pc );
-      state.pc = state.ea;
-      break;
-    case Opcode::RTS_RTS:
-      co_await read( ++state.pc );
-      ++state.sl;
-      state.eal = co_await read( state.s );
-      ++state.sl;
-      state.eah = co_await read( state.s );
-      if ( mStackBreakCondition < state.s )
-      {
-        mReq.cpuBreakType = mPostponedStepOut ? CpuBreakType::STEP_OUT : CpuBreakType::STEP_OVER;
-        mPostponedStepOut = false;
-        mStackBreakCondition = 0xffff;
-      }
-      co_await read( state.pc );
-      ++state.ea;
-      state.pc = state.ea;
-      break;
-    case Opcode::PHR_PHA:
-      co_await write( state.s, state.a );
-      state.sl--;
-      break;
-    case Opcode::PHR_PHP:
-      co_await write( state.s, state.getP() );
-      state.sl--;
-      break;
-    case Opcode::PHR_PHX:
-      co_await write( state.s, state.x );
-      state.sl--;
-      break;
-    case Opcode::PHR_PHY:
-      co_await write( state.s, state.y );
-      state.sl--;
-      break;
-    case Opcode::PLR_PLA:
-      co_await read( state.pc );
-      ++state.sl;
-      state.setnz( state.a = co_await read( state.s ) );
-      break;
-    case Opcode::PLR_PLP:
-      co_await read( state.pc );
-      ++state.sl;
-      state.setP( co_await read( state.s ) );
-      break;
-    case Opcode::PLR_PLX:
-      co_await read( state.pc );
-      ++state.sl;
-      state.setnz( state.x = co_await read( state.s ) );
-      break;
-    case Opcode::PLR_PLY:
-      co_await read( state.pc );
-      ++state.sl;
-      state.setnz( state.y = co_await read( state.s ) );
-      break;
-    case Opcode::UND_2_02:
-    case Opcode::UND_2_22:
-    case Opcode::UND_2_42:
-    case Opcode::UND_2_62:
-    case Opcode::UND_2_82:
-    case Opcode::UND_2_C2:
-    case Opcode::UND_2_E2:
-      ++state.pc;
-      break;
-    case Opcode::UND_3_44:
-      ++state.pc;
-      co_await read( state.ea );
-      break;
-    case Opcode::UND_4_54:
-    case Opcode::UND_4_d4:
-    case Opcode::UND_4_f4:
-      ++state.pc;
-      co_await read( state.pc );
-      state.tl = state.eal + state.x;
-      co_await read( state.ea );
-      break;
-    case Opcode::UND_4_dc:
-    case Opcode::UND_4_fc:
-      ++state.pc;
-      state.eah = co_await read( state.pc++ );
-      co_await read( state.ea );
-      break;
-    case Opcode::UND_8_5c:
-      //https://laughtonelectronics.com/Arcana/KimKlone/Kimklone_opcode_mapping.html
-      //state.op - code 5C consumes 3 bytes and 8 cycles but conforms to no known address mode; it remains interesting but useless.
-      //I tested the instruction "5C 1234h" ( stored little - endian as 5Ch 34h 12h ) as an example, and observed the following : 3 cycles fetching the instruction, 1 cycle reading FF34, then 4 cycles reading FFFF.
-      ++state.pc;
-      co_await read( state.pc++ );
-      state.eah = 0xff;
-      co_await read( state.ea );
-      co_await read( 0xffff );
-      co_await read( 0xffff );
-      co_await read( 0xffff );
-      co_await read( 0xffff );
-      break;
-    default:  //for UND_1_xx
-      break;
-    }
+#define CPU_FETCH_OPERAND( address ) co_await fetchOperand( address )
+#define CPU_READ( address ) co_await read( address )
+#define CPU_WRITE( address, value ) co_await write( address, value )
+#include "CPUInstructions.inl"
+#undef CPU_FETCH_OPERAND
+#undef CPU_READ
+#undef CPU_WRITE
 
     trace2();
 
@@ -2133,27 +436,11 @@ CPU::Execute CPU::execute()
 
 void CPU::trace1()
 {
-  if ( mGlobalTrace )
-  {
-    buf[3] = hexTab[mPreviousState.pch >> 4];
-    buf[4] = hexTab[mPreviousState.pch & 0x0f];
-    buf[5] = hexTab[mPreviousState.pcl >> 4];
-    buf[6] = hexTab[mPreviousState.pcl & 0x0f];
-
-    buf[10] = hexTab[mPreviousState.a >> 4];
-    buf[11] = hexTab[mPreviousState.a & 0x0f];
-    buf[15] = hexTab[mPreviousState.x >> 4];
-    buf[16] = hexTab[mPreviousState.x & 0x0f];
-    buf[20] = hexTab[mPreviousState.y >> 4];
-    buf[21] = hexTab[mPreviousState.y & 0x0f];
-
-    buf[26] = hexTab[mPreviousState.sl >> 4];
-    buf[27] = hexTab[mPreviousState.sl & 0x0f];
-
-    mPreviousState.printP( (char*)&buf[31] );
-
-    off = 38;
-  }
+  //text line is formatted at the end of the instruction from mPreviousState
+  if ( mRecorder )
+    mRecorder->begin();
+  if ( mProfiler )
+    mProfiler->begin( mPreviousState.pc );
 }
 
 void CPU::printStatus( std::span<uint8_t,3*14> text )
@@ -2198,7 +485,7 @@ void CPU::disassemblyFromPC( uint8_t const* ram, char* out, int columns, int row
   }
 }
 
-bool CPU::disasmOp( char * out, Opcode op, CPUState* state )
+bool CPU::disasmOp( char * out, Opcode op, CPUState const* state )
 {
   bool defined = true;
   out[4] = ' '; /* Hack for history */
@@ -3149,17 +1436,33 @@ uint8_t CPU::disasmOpr( uint8_t const* ram, char* out, int & pc )
   return pc - intialPC;
 }
 
-void CPU::trace2()
+size_t CPU::formatTrace( char* out, CPUState const& before, CPUState const& after, TraceHelper const& traceHelper, std::string_view const* comment )
 {
-  if ( !mGlobalTrace )
-    return;
+  static constexpr char prototype[] = "PC:ffff A:ff X:ff Y:ff S:1ff P=NVDIZC ";
+  memcpy( out, prototype, sizeof prototype - 1 );
 
-  disasmOp( buf.data() + off, mState.op, &mState );
-  off += 5;
+  out[3] = hexTab[before.pch >> 4];
+  out[4] = hexTab[before.pch & 0x0f];
+  out[5] = hexTab[before.pcl >> 4];
+  out[6] = hexTab[before.pcl & 0x0f];
 
-  auto comment = mTraceHelper->getTraceComment();
+  out[10] = hexTab[before.a >> 4];
+  out[11] = hexTab[before.a & 0x0f];
+  out[15] = hexTab[before.x >> 4];
+  out[16] = hexTab[before.x & 0x0f];
+  out[20] = hexTab[before.y >> 4];
+  out[21] = hexTab[before.y & 0x0f];
 
-  switch ( mState.op )
+  out[26] = hexTab[before.sl >> 4];
+  out[27] = hexTab[before.sl & 0x0f];
+
+  before.printP( out + 31 );
+
+  int64_t off = 38;
+  disasmOp( out + off, after.op, &after );
+  off += 5;
+
+  switch ( after.op )
   {
   case Opcode::UND_1_03:
   case Opcode::UND_1_13:
@@ -3206,7 +1509,7 @@ void CPU::trace2()
   case Opcode::RZP_ORA:
   case Opcode::RZP_ADC:
   case Opcode::RZP_SBC:
-    off += sprintf( buf.data() + off, "$%02x\t;$%02x", mState.eal, mState.m1 );
+    off += sprintf( out + off, "$%02x\t;$%02x", after.eal, after.m1 );
     break;
   case Opcode::MZP_ASL:
   case Opcode::MZP_DEC:
@@ -3232,14 +1535,14 @@ void CPU::trace2()
   case Opcode::MZP_SMB5:
   case Opcode::MZP_SMB6:
   case Opcode::MZP_SMB7:
-    off += sprintf( buf.data() + off, "$%02x\t;$%02x->$%02x", mState.eal, mState.m1, mState.m2 );
+    off += sprintf( out + off, "$%02x\t;$%02x->$%02x", after.eal, after.m1, after.m2 );
     break;
   case Opcode::WZP_STA:
   case Opcode::WZP_STX:
   case Opcode::WZP_STY:
   case Opcode::WZP_STZ:
   case Opcode::UND_3_44:
-    off += sprintf( buf.data() + off, "$%02x", mState.eal );
+    off += sprintf( out + off, "$%02x", after.eal );
     break;
   case Opcode::RZX_LDA:
   case Opcode::RZX_LDY:
@@ -3250,7 +1553,7 @@ void CPU::trace2()
   case Opcode::RZX_ORA:
   case Opcode::RZX_ADC:
   case Opcode::RZX_SBC:
-    off += sprintf( buf.data() + off, "$%02x,x\t;[$%04x]=$%02x", mState.eal, mState.t, mState.m1 );
+    off += sprintf( out + off, "$%02x,x\t;[$%04x]=$%02x", after.eal, after.t, after.m1 );
     break;
   case Opcode::MZX_ASL:
   case Opcode::MZX_DEC:
@@ -3258,7 +1561,7 @@ void CPU::trace2()
   case Opcode::MZX_LSR:
   case Opcode::MZX_ROL:
   case Opcode::MZX_ROR:
-    off += sprintf( buf.data() + off, "$%02x,x\t;[$%04x]=$%02x->$%02x", mState.eal, mState.t, mState.m1, mState.m2 );
+    off += sprintf( out + off, "$%02x,x\t;[$%04x]=$%02x->$%02x", after.eal, after.t, after.m1, after.m2 );
     break;
   case Opcode::WZX_STA:
   case Opcode::WZX_STY:
@@ -3266,13 +1569,13 @@ void CPU::trace2()
   case Opcode::UND_4_54:
   case Opcode::UND_4_d4:
   case Opcode::UND_4_f4:
-    off += sprintf( buf.data() + off, "$%02x,x\t;[$%04x]", mState.eal, mState.t );
+    off += sprintf( out + off, "$%02x,x\t;[$%04x]", after.eal, after.t );
     break;
   case Opcode::RZY_LDX:
-    off += sprintf( buf.data() + off, "$%02x,y\t;[$%04x]=$%02x", mState.eal, mState.t, mState.m1 );
+    off += sprintf( out + off, "$%02x,y\t;[$%04x]=$%02x", after.eal, after.t, after.m1 );
     break;
   case Opcode::WZY_STX:
-    off += sprintf( buf.data() + off, "$%02x,y\t;[$%04x]", mState.eal, mState.t );
+    off += sprintf( out + off, "$%02x,y\t;[$%04x]", after.eal, after.t );
     break;
   case Opcode::RIN_LDA:
   case Opcode::RIN_AND:
@@ -3283,21 +1586,21 @@ void CPU::trace2()
   case Opcode::RIN_SBC:
     if ( comment )
     {
-      off = fmt::format_to( buf.data() + off, "({:02x})\t;[{}]={:02x}\t{}", mState.fa, mTraceHelper->addressLabel( mState.t ), mState.m1, *comment ) - buf.data();
+      off = fmt::format_to( out + off, "({:02x})\t;[{}]={:02x}\t{}", after.fa, traceHelper.addressLabel( after.t ), after.m1, *comment ) - out;
     }
     else
     {
-      off += sprintf( buf.data() + off, "($%02x)\t;[%s]=$%02x", mState.fa, mTraceHelper->addressLabel( mState.t ), mState.m1 );
+      off += sprintf( out + off, "($%02x)\t;[%s]=$%02x", after.fa, traceHelper.addressLabel( after.t ), after.m1 );
     }
     break;
   case Opcode::WIN_STA:
     if ( comment )
     {
-      off = fmt::format_to( buf.data() + off, "({:02x})\t;[{}]\t{}", mState.fa, mTraceHelper->addressLabel( mState.t ), *comment ) - buf.data();
+      off = fmt::format_to( out + off, "({:02x})\t;[{}]\t{}", after.fa, traceHelper.addressLabel( after.t ), *comment ) - out;
     }
     else
     {
-      off += sprintf( buf.data() + off, "($%02x)\t;[%s]", mState.fa, mTraceHelper->addressLabel( mState.t ) );
+      off += sprintf( out + off, "($%02x)\t;[%s]", after.fa, traceHelper.addressLabel( after.t ) );
     }
     break;
   case Opcode::RIX_AND:
@@ -3309,21 +1612,21 @@ void CPU::trace2()
   case Opcode::RIX_SBC:
     if ( comment )
     {
-      off = fmt::format_to( buf.data() + off, "({:02x},x)\t;[{}]={:02x}\t{}", mState.fa, mTraceHelper->addressLabel( mState.t ), mState.m1, *comment ) - buf.data();
+      off = fmt::format_to( out + off, "({:02x},x)\t;[{}]={:02x}\t{}", after.fa, traceHelper.addressLabel( after.t ), after.m1, *comment ) - out;
     }
     else
     {
-      off += sprintf( buf.data() + off, "($%02x,x)\t;[%s]=$%02x", mState.fa, mTraceHelper->addressLabel( mState.t ), mState.m1 );
+      off += sprintf( out + off, "($%02x,x)\t;[%s]=$%02x", after.fa, traceHelper.addressLabel( after.t ), after.m1 );
     }
     break;
   case Opcode::WIX_STA:
     if ( comment )
     {
-      off = fmt::format_to( buf.data() + off, "({:02x},x)\t;[{}]\t{}", mState.fa, mTraceHelper->addressLabel( mState.t ), *comment ) - buf.data();
+      off = fmt::format_to( out + off, "({:02x},x)\t;[{}]\t{}", after.fa, traceHelper.addressLabel( after.t ), *comment ) - out;
     }
     else
     {
-      off += sprintf( buf.data() + off, "($%02x,x)\t;[%s]", mState.fa, mTraceHelper->addressLabel( mState.t ) );
+      off += sprintf( out + off, "($%02x,x)\t;[%s]", after.fa, traceHelper.addressLabel( after.t ) );
     }
     break;
   case Opcode::RIY_AND:
@@ -3335,21 +1638,21 @@ void CPU::trace2()
   case Opcode::RIY_SBC:
     if ( comment )
     {
-      off = fmt::format_to( buf.data() + off, "({:02x}),y\t;[{}]={:02x}\t{}", mState.fa, mTraceHelper->addressLabel( mState.ea ), mState.m1, *comment ) - buf.data();
+      off = fmt::format_to( out + off, "({:02x}),y\t;[{}]={:02x}\t{}", after.fa, traceHelper.addressLabel( after.ea ), after.m1, *comment ) - out;
     }
     else
     {
-      off += sprintf( buf.data() + off, "($%02x),y\t;[%s]=$%02x", mState.fa, mTraceHelper->addressLabel( mState.ea ), mState.m1 );
+      off += sprintf( out + off, "($%02x),y\t;[%s]=$%02x", after.fa, traceHelper.addressLabel( after.ea ), after.m1 );
     }
     break;
   case Opcode::WIY_STA:
     if ( comment )
     {
-      off = fmt::format_to( buf.data() + off, "({:02x}),y\t;[{}]\t{}", mState.fa, mTraceHelper->addressLabel( mState.ea ), *comment ) - buf.data();
+      off = fmt::format_to( out + off, "({:02x}),y\t;[{}]\t{}", after.fa, traceHelper.addressLabel( after.ea ), *comment ) - out;
     }
     else
     {
-      off += sprintf( buf.data() + off, "($%02x),y\t;[%s]", mState.fa, mTraceHelper->addressLabel( mState.ea ) );
+      off += sprintf( out + off, "($%02x),y\t;[%s]", after.fa, traceHelper.addressLabel( after.ea ) );
     }
     break;
   case Opcode::RAB_AND:
@@ -3366,11 +1669,11 @@ void CPU::trace2()
   case Opcode::RAB_SBC:
     if ( comment )
     {
-      off = fmt::format_to( buf.data() + off, "{}\t;={:02x}\t{}", mTraceHelper->addressLabel( mState.ea ), mState.m1, *comment ) - buf.data();
+      off = fmt::format_to( out + off, "{}\t;={:02x}\t{}", traceHelper.addressLabel( after.ea ), after.m1, *comment ) - out;
     }
     else
     {
-      off += sprintf( buf.data() + off, "%s\t;=$%02x", mTraceHelper->addressLabel( mState.ea ), mState.m1 );
+      off += sprintf( out + off, "%s\t;=$%02x", traceHelper.addressLabel( after.ea ), after.m1 );
     }
     break;
   case Opcode::MAB_ASL:
@@ -3383,11 +1686,11 @@ void CPU::trace2()
   case Opcode::MAB_TSB:
     if ( comment )
     {
-      off = fmt::format_to( buf.data() + off, "{}\t;={:02x}->{:02x}\t{}", mTraceHelper->addressLabel( mState.ea ), mState.m1, mState.m2, *comment ) - buf.data();
+      off = fmt::format_to( out + off, "{}\t;={:02x}->{:02x}\t{}", traceHelper.addressLabel( after.ea ), after.m1, after.m2, *comment ) - out;
     }
     else
     {
-      off += sprintf( buf.data() + off, "%s\t;=$%02x->$%02x", mTraceHelper->addressLabel( mState.ea ), mState.m1, mState.m2 );
+      off += sprintf( out + off, "%s\t;=$%02x->$%02x", traceHelper.addressLabel( after.ea ), after.m1, after.m2 );
     }
     break;
   case Opcode::WAB_STA:
@@ -3396,11 +1699,11 @@ void CPU::trace2()
   case Opcode::WAB_STZ:
     if ( comment )
     {
-      off = fmt::format_to( buf.data() + off, "{}\t;{}", mTraceHelper->addressLabel( mState.ea ), *comment ) - buf.data();
+      off = fmt::format_to( out + off, "{}\t;{}", traceHelper.addressLabel( after.ea ), *comment ) - out;
     }
     else
     {
-      off += sprintf( buf.data() + off, "%s", mTraceHelper->addressLabel( mState.ea ) );
+      off += sprintf( out + off, "%s", traceHelper.addressLabel( after.ea ) );
     }
     break;
   case Opcode::JMA_JMP:
@@ -3408,7 +1711,7 @@ void CPU::trace2()
   case Opcode::UND_4_dc:
   case Opcode::UND_4_fc:
   case Opcode::UND_8_5c:
-    off += sprintf( buf.data() + off, "%s", mTraceHelper->addressLabel( mState.ea ) );
+    off += sprintf( out + off, "%s", traceHelper.addressLabel( after.ea ) );
     break;
   case Opcode::RAX_AND:
   case Opcode::RAX_BIT:
@@ -3421,11 +1724,11 @@ void CPU::trace2()
   case Opcode::RAX_SBC:
     if ( comment )
     {
-      off = fmt::format_to( buf.data() + off, "{:04x},x\t;[{}]={:02x}\t{}", mState.ea, mTraceHelper->addressLabel( mState.fa ), mState.m1, *comment ) - buf.data();
+      off = fmt::format_to( out + off, "{:04x},x\t;[{}]={:02x}\t{}", after.ea, traceHelper.addressLabel( after.fa ), after.m1, *comment ) - out;
     }
     else
     {
-      off += sprintf( buf.data() + off, "$%04x,x\t;[%s]=$%02x", mState.ea, mTraceHelper->addressLabel( mState.fa ), mState.m1 );
+      off += sprintf( out + off, "$%04x,x\t;[%s]=$%02x", after.ea, traceHelper.addressLabel( after.fa ), after.m1 );
     }
     break;
   case Opcode::MAX_ASL:
@@ -3436,22 +1739,22 @@ void CPU::trace2()
   case Opcode::MAX_ROR:
     if ( comment )
     {
-      off = fmt::format_to( buf.data() + off, "{:04x},x\t;[{}]={:02x}->{:02x}\t{}", mState.ea, mTraceHelper->addressLabel( mState.fa ), mState.m1, mState.m2, *comment ) - buf.data();
+      off = fmt::format_to( out + off, "{:04x},x\t;[{}]={:02x}->{:02x}\t{}", after.ea, traceHelper.addressLabel( after.fa ), after.m1, after.m2, *comment ) - out;
     }
     else
     {
-      off += sprintf( buf.data() + off, "$%04x,x\t;[%s]=$%02x->$%02x", mState.ea, mTraceHelper->addressLabel( mState.fa ), mState.m1, mState.m2 );
+      off += sprintf( out + off, "$%04x,x\t;[%s]=$%02x->$%02x", after.ea, traceHelper.addressLabel( after.fa ), after.m1, after.m2 );
     }
     break;
   case Opcode::WAX_STA:
   case Opcode::WAX_STZ:
     if ( comment )
     {
-      off = fmt::format_to( buf.data() + off, "{:04x},x\t;[{}]\t{}", mState.ea, mTraceHelper->addressLabel( mState.fa ), *comment ) - buf.data();
+      off = fmt::format_to( out + off, "{:04x},x\t;[{}]\t{}", after.ea, traceHelper.addressLabel( after.fa ), *comment ) - out;
     }
     else
     {
-      off += sprintf( buf.data() + off, "$%04x,x\t;[%s]", mState.ea, mTraceHelper->addressLabel( mState.fa ) );
+      off += sprintf( out + off, "$%04x,x\t;[%s]", after.ea, traceHelper.addressLabel( after.fa ) );
     }
     break;
   case Opcode::RAY_AND:
@@ -3464,28 +1767,28 @@ void CPU::trace2()
   case Opcode::RAY_SBC:
     if ( comment )
     {
-      off = fmt::format_to( buf.data() + off, "{:04x},y\t;[{}]={:02x}\t{}", mState.ea, mTraceHelper->addressLabel( mState.fa ), mState.m1, *comment ) - buf.data();
+      off = fmt::format_to( out + off, "{:04x},y\t;[{}]={:02x}\t{}", after.ea, traceHelper.addressLabel( after.fa ), after.m1, *comment ) - out;
     }
     else
     {
-      off += sprintf( buf.data() + off, "$%04x,y\t;[%s]=$%02x", mState.ea, mTraceHelper->addressLabel( mState.fa ), mState.m1 );
+      off += sprintf( out + off, "$%04x,y\t;[%s]=$%02x", after.ea, traceHelper.addressLabel( after.fa ), after.m1 );
     }
     break;
   case Opcode::WAY_STA:
     if ( comment )
     {
-      off = fmt::format_to( buf.data() + off, "{:04x},y\t;[{}]\t{}", mState.ea, mTraceHelper->addressLabel( mState.fa ), *comment ) - buf.data();
+      off = fmt::format_to( out + off, "{:04x},y\t;[{}]\t{}", after.ea, traceHelper.addressLabel( after.fa ), *comment ) - out;
     }
     else
     {
-      off += sprintf( buf.data() + off, "$%04x,y\t;[%s]", mState.ea, mTraceHelper->addressLabel( mState.fa ) );
+      off += sprintf( out + off, "$%04x,y\t;[%s]", after.ea, traceHelper.addressLabel( after.fa ) );
     }
     break;
   case Opcode::JMX_JMP:
-    off += sprintf( buf.data() + off, "($%04x,x)\t;[%s]", mState.fa, mTraceHelper->addressLabel( mState.ea ) );
+    off += sprintf( out + off, "($%04x,x)\t;[%s]", after.fa, traceHelper.addressLabel( after.ea ) );
     break;
   case Opcode::JMI_JMP:
-    off += sprintf( buf.data() + off, "($%04x)\t;[%s]", mState.fa, mTraceHelper->addressLabel( mState.t ) );
+    off += sprintf( out + off, "($%04x)\t;[%s]", after.fa, traceHelper.addressLabel( after.t ) );
     break;
   case Opcode::IMP_ASL:
   case Opcode::IMP_CLC:
@@ -3542,7 +1845,7 @@ void CPU::trace2()
   case Opcode::UND_2_C2:
   case Opcode::UND_2_E2:
   case Opcode::BRK_BRK:
-    off += sprintf( buf.data() + off, "#$%02x", mState.eal );
+    off += sprintf( out + off, "#$%02x", after.eal );
     break;
   case Opcode::BRL_BCC:
   case Opcode::BRL_BCS:
@@ -3553,7 +1856,7 @@ void CPU::trace2()
   case Opcode::BRL_BVC:
   case Opcode::BRL_BVS:
   case Opcode::BRL_BRA:
-    off += sprintf( buf.data() + off, "$%04x", mState.t );
+    off += sprintf( out + off, "$%04x", after.t );
     break;
   case Opcode::BZR_BBR0:
   case Opcode::BZR_BBR1:
@@ -3571,13 +1874,32 @@ void CPU::trace2()
   case Opcode::BZR_BBS5:
   case Opcode::BZR_BBS6:
   case Opcode::BZR_BBS7:
-    off += sprintf( buf.data() + off, "$%02x,$%04x\t;$%02x", mState.eal, mState.t, mState.m1 );
+    off += sprintf( out + off, "$%02x,$%04x\t;$%02x", after.eal, after.t, after.m1 );
     break;
   }
 
-  if ( mFtrace.good() && ( mTrace || mTraceNextCount ) )
+  return (size_t)off;
+}
+
+void CPU::trace2()
+{
+  if ( !mGlobalTrace )
+    return;
+
+  if ( mRecorder )
+    mRecorder->record( mPreviousState, mState );
+  if ( mProfiler )
+    mProfiler->end( mState );
+
+  if ( !mTrace && !mTraceNextCount )
+    return;
+
+  auto comment = mTraceHelper->getTraceComment();
+  size_t size = formatTrace( buf.data(), mPreviousState, mState, *mTraceHelper, comment.get() );
+
+  if ( mFtrace.good() )
   {
-    mFtrace.write( buf.data(), off );
+    mFtrace.write( buf.data(), size );
     mFtrace.put( '\n' );
   }
 
@@ -3621,7 +1943,7 @@ void CPU::traceNextCount( int count )
 
 void CPU::setGlobalTrace()
 {
-  if ( mTrace || mTraceNextCount )
+  if ( mTrace || mTraceNextCount || mRecorder || mProfiler )
   {
     if ( !mGlobalTrace )
     {
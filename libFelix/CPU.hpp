@@ -7,6 +7,9 @@ enum class Opcode : uint8_t;
 struct CpuTrace;
 struct TraceRequest;
 class TraceHelper;
+class TraceRecorder;
+class CodeProfiler;
+class StateStream;
 
 class CPU
 {
@@ -17,7 +20,7 @@ public:
   static constexpr uint16_t IRQ_VECTOR = 0xfffe;
 
 
-  struct Request : private NonCopyable //won't compile on gcc https://gcc.gnu.org/bugzilla/show_bug.cgi?id=99575
+  struct Request : private NonCopyable
   {
     enum class Type : uint8_t
     {
@@ -33,23 +36,23 @@ public:
     Type type;
   };
 
-  struct Response : private NonCopyable //won't compile on gcc https://gcc.gnu.org/bugzilla/show_bug.cgi?id=99575
+  struct Response : private NonCopyable
   {
     Response( CPUState & state ) : state{ state }, interrupt{}, value{} {}
     CPUState & state;
     int interrupt;
     uint8_t value;
-
-    bool await_ready() { return false; }
-    void await_suspend( std::coroutine_handle<> c ) {}
-
   };
 
 
   CPU( std::shared_ptr<TraceHelper> traceHelper );
   ~CPU();
 
+  //resumes the coroutine until its next bus request
   Request const& advance();
+  //alternative to advance() executing whole instructions with direct bus calls until a break, defined in CPUInterpreter.hpp
+  template<typename Bus>
+  CpuBreakType interpret( Bus & bus );
 
   //triggers a break on next instruction boundary on batch end
   void breakNext();
@@ -72,6 +75,14 @@ public:
   void desertInterrupt( int mask );
   int interruptedMask() const;
   void setLog( std::filesystem::path const & path );
+  //appends binary records of executed instructions to the recorder, nullptr stops recording
+  void setTraceRecorder( std::shared_ptr<TraceRecorder> recorder );
+  //counts executed instructions in the profiler, nullptr stops profiling
+  void setProfiler( std::shared_ptr<CodeProfiler> profiler );
+
+  //state can only be saved between instructions, i.e. right after an opcode fetch
+  bool instructionBoundary() const;
+  void serialize( StateStream & stream );
 
   CPUState & state();
 
@@ -80,7 +91,9 @@ public:
   void toggleTrace( bool on );
   void traceNextCount( int count );
   void printStatus( std::span<uint8_t, 3 * 14> text );
-  static bool disasmOp( char* out, Opcode op, CPUState* state = nullptr );
+  static bool disasmOp( char* out, Opcode op, CPUState const* state = nullptr );
+  //text trace line of an instruction executed from state before to state after, returns its length
+  static size_t formatTrace( char* out, CPUState const& before, CPUState const& after, TraceHelper const& traceHelper, std::string_view const* comment );
   uint8_t disasmOpr( uint8_t const* ram, char* out, int& pc );
   void disassemblyFromPC( uint8_t const* ram, char * out, int columns, int rows );
 
@@ -105,10 +118,11 @@ private:
 
     Execute();
     Execute( handle c );
+    Execute & operator=( Execute && other );
     ~Execute();
 
     handle coro;
-  } const mEx;
+  } mEx;
 
   Request mReq;
   Response mRes;
@@ -117,61 +131,76 @@ private:
   bool mGlobalTrace;
   std::ofstream mFtrace;
   std::shared_ptr<TraceHelper> mTraceHelper;
+  std::shared_ptr<TraceRecorder> mRecorder;
+  std::shared_ptr<CodeProfiler> mProfiler;
+  //execute() was entered
+  bool mStarted;
+  //execute() was recreated by serialize() and continues right after an opcode fetch
+  bool mResumeAfterFetch;
 
   Execute execute();
   bool isHiccup();
 
 
-  auto & fetchOpcode( uint16_t address )
+  //awaiters only refer to mRes so they can be freely copied by the compiler (gcc https://gcc.gnu.org/bugzilla/show_bug.cgi?id=99575)
+  struct ResponseAwaiter
+  {
+    Response & res;
+
+    bool await_ready() { return false; }
+    void await_suspend( std::coroutine_handle<> c ) {}
+  };
+
+  auto fetchOpcode( uint16_t address )
   {
-    struct CPUFetchOpcodeAwaiter : public Response
+    struct CPUFetchOpcodeAwaiter : public ResponseAwaiter
     {
       void await_resume()
       {
-        state.interrupt = interrupt;
-        state.op = (Opcode)value;
+        res.state.interrupt = res.interrupt;
+        res.state.op = (Opcode)res.value;
       }
     };
 
     mReq.type = Request::Type::FETCH_OPCODE;
     mReq.address = address;
-    return static_cast<CPUFetchOpcodeAwaiter &>( mRes );
+    return CPUFetchOpcodeAwaiter{ mRes };
   }
 
-  auto & fetchOperand( uint16_t address )
+  auto fetchOperand( uint16_t address )
   {
-    struct CPUFetchOperandAwaiter : public Response
+    struct CPUFetchOperandAwaiter : public ResponseAwaiter
     {
       uint8_t await_resume()
       {
-        return value;
+        return res.value;
       }
     };
 
     mReq.type = Request::Type::FETCH_OPERAND;
     mReq.address = address;
-    return static_cast<CPUFetchOperandAwaiter &>( mRes );
+    return CPUFetchOperandAwaiter{ mRes };
   }
 
 
-  auto & read( uint16_t address )
+  auto read( uint16_t address )
   {
-    struct CPUReadAwaiter : public Response
+    struct CPUReadAwaiter : public ResponseAwaiter
     {
       uint8_t await_resume()
       {
-        return value;
+        return res.value;
       }
     };
 
     mReq.type = Request::Type::READ;
     mReq.address = address;
-    return static_cast<CPUReadAwaiter &>( mRes );
+    return CPUReadAwaiter{ mRes };
   }
 
-  auto & write( uint16_t address, uint8_t value )
+  auto write( uint16_t address, uint8_t value )
   {
-    struct CPUWriteAwaiter : public Response
+    struct CPUWriteAwaiter : public ResponseAwaiter
     {
       void await_resume()
       {
@@ -181,7 +210,7 @@ private:
     mReq.type = Request::Type::WRITE;
     mReq.address = address;
     mReq.value = value;
-    return static_cast<CPUWriteAwaiter &>( mRes );
+    return CPUWriteAwaiter{ mRes };
   }
 
   void trace1();
@@ -191,7 +220,6 @@ private:
 private:
 
   std::array<char, 1024> buf;
-  int64_t off;
   //true if mStackBreakCondition is valid for CpuBreakType::STEP_OUT
   bool mPostponedStepOut;
   uint16_t mStackBreakCondition;
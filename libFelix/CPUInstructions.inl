@@ -0,0 +1,1770 @@
+//Body of a single 65C02 instruction shared by the CPU backends.
+//The includer provides CPU_FETCH_OPERAND( address ), CPU_READ( address ) and CPU_WRITE( address, value ) expressions
+//performing the bus access in its own way and has state referring to the CPUState.
+
+switch ( state.op )
+{
+case Opcode::RZP_AND:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  state.setnz( state.a &= state.m1 );
+  break;
+case Opcode::RZP_BIT:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  state.bit( state.m1 );
+  break;
+case Opcode::RZP_CMP:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  state.cmp( state.m1 );
+  break;
+case Opcode::RZP_CPX:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  state.cpx( state.m1 );
+  break;
+case Opcode::RZP_CPY:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  state.cpy( state.m1 );
+  break;
+case Opcode::RZP_EOR:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  state.setnz( state.a ^= state.m1 );
+  break;
+case Opcode::RZP_LDA:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  state.setnz( state.a = state.m1 );
+  break;
+case Opcode::RZP_LDX:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  state.setnz( state.x = state.m1 );
+  break;
+case Opcode::RZP_LDY:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  state.setnz( state.y = state.m1 );
+  break;
+case Opcode::RZP_ORA:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  state.setnz( state.a |= state.m1 );
+  break;
+case Opcode::RZP_ADC:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  state.adc( state.m1 );
+  if ( state.d )
+  {
+    CPU_READ( state.ea );
+  }
+  break;
+case Opcode::RZP_SBC:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  state.sbc( state.m1 );
+  if ( state.d )
+  {
+    CPU_READ( state.ea );
+  }
+  break;
+case Opcode::WZP_STA:
+  ++state.pc;
+  CPU_WRITE( state.ea, state.a );
+  break;
+case Opcode::WZP_STX:
+  ++state.pc;
+  CPU_WRITE( state.ea, state.x );
+  break;
+case Opcode::WZP_STY:
+  ++state.pc;
+  CPU_WRITE( state.ea, state.y );
+  break;
+case Opcode::WZP_STZ:
+  ++state.pc;
+  CPU_WRITE( state.ea, 0x00 );
+  break;
+case Opcode::MZP_ASL:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  CPU_READ( state.ea );
+  state.m2 = state.asl( state.m1 );
+  CPU_WRITE( state.ea, state.m2 );
+  break;
+case Opcode::MZP_DEC:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  CPU_READ( state.ea );
+  state.m2 = state.dec( state.m1 );
+  CPU_WRITE( state.ea, state.m2 );
+  break;
+case Opcode::MZP_INC:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  CPU_READ( state.ea );
+  state.m2 = state.inc( state.m1 );
+  CPU_WRITE( state.ea, state.m2 );
+  break;
+case Opcode::MZP_LSR:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  CPU_READ( state.ea );
+  state.m2 = state.lsr( state.m1 );
+  CPU_WRITE( state.ea, state.m2 );
+  break;
+case Opcode::MZP_ROL:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  CPU_READ( state.ea );
+  state.m2 = state.rol( state.m1 );
+  CPU_WRITE( state.ea, state.m2 );
+  break;
+case Opcode::MZP_ROR:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  CPU_READ( state.ea );
+  state.m2 = state.ror( state.m1 );
+  CPU_WRITE( state.ea, state.m2 );
+  break;
+case Opcode::MZP_TRB:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  CPU_READ( state.ea );
+  state.setz( state.m1 & state.a );
+  state.m2 = state.m1 & ~state.a;
+  CPU_WRITE( state.ea, state.m2 );
+  break;
+case Opcode::MZP_TSB:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  CPU_READ( state.ea );
+  state.setz( state.m1 & state.a );
+  state.m2 = state.m1 | state.a;
+  CPU_WRITE( state.ea, state.m2 );
+  break;
+case Opcode::MZP_RMB0:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  CPU_READ( state.ea );
+  state.m2 = state.m1 & ~0x01;
+  CPU_WRITE( state.ea, state.m2 );
+  break;
+case Opcode::MZP_RMB1:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  CPU_READ( state.ea );
+  state.m2 = state.m1 & ~0x02;
+  CPU_WRITE( state.ea, state.m2 );
+  break;
+case Opcode::MZP_RMB2:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  CPU_READ( state.ea );
+  state.m2 = state.m1 & ~0x04;
+  CPU_WRITE( state.ea, state.m2 );
+  break;
+case Opcode::MZP_RMB3:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  CPU_READ( state.ea );
+  state.m2 = state.m1 & ~0x08;
+  CPU_WRITE( state.ea, state.m2 );
+  break;
+case Opcode::MZP_RMB4:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  CPU_READ( state.ea );
+  state.m2 = state.m1 & ~0x10;
+  CPU_WRITE( state.ea, state.m2 );
+  break;
+case Opcode::MZP_RMB5:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  CPU_READ( state.ea );
+  state.m2 = state.m1 & ~0x20;
+  CPU_WRITE( state.ea, state.m2 );
+  break;
+case Opcode::MZP_RMB6:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  CPU_READ( state.ea );
+  state.m2 = state.m1 & ~0x40;
+  CPU_WRITE( state.ea, state.m2 );
+  break;
+case Opcode::MZP_RMB7:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  CPU_READ( state.ea );
+  state.m2 = state.m1 & ~0x80;
+  CPU_WRITE( state.ea, state.m2 );
+  break;
+case Opcode::MZP_SMB0:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  CPU_READ( state.ea );
+  state.m2 = state.m1 | 0x01;
+  CPU_WRITE( state.ea, state.m2 );
+  break;
+case Opcode::MZP_SMB1:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  CPU_READ( state.ea );
+  state.m2 = state.m1 | 0x02;
+  CPU_WRITE( state.ea, state.m2 );
+  break;
+case Opcode::MZP_SMB2:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  CPU_READ( state.ea );
+  state.m2 = state.m1 | 0x04;
+  CPU_WRITE( state.ea, state.m2 );
+  break;
+case Opcode::MZP_SMB3:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  CPU_READ( state.ea );
+  state.m2 = state.m1 | 0x08;
+  CPU_WRITE( state.ea, state.m2 );
+  break;
+case Opcode::MZP_SMB4:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  CPU_READ( state.ea );
+  state.m2 = state.m1 | 0x10;
+  CPU_WRITE( state.ea, state.m2 );
+  break;
+case Opcode::MZP_SMB5:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  CPU_READ( state.ea );
+  state.m2 = state.m1 | 0x20;
+  CPU_WRITE( state.ea, state.m2 );
+  break;
+case Opcode::MZP_SMB6:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  CPU_READ( state.ea );
+  state.m2 = state.m1 | 0x40;
+  CPU_WRITE( state.ea, state.m2 );
+  break;
+case Opcode::MZP_SMB7:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  CPU_READ( state.ea );
+  state.m2 = state.m1 | 0x80;
+  CPU_WRITE( state.ea, state.m2 );
+  break;
+case Opcode::RZX_AND:
+  CPU_READ( ++state.pc );
+  state.tl = state.eal + state.x;
+  state.m1 = CPU_READ( state.t );
+  state.setnz( state.a &= state.m1 );
+  break;
+case Opcode::RZX_BIT:
+  CPU_READ( ++state.pc );
+  state.tl = state.eal + state.x;
+  state.m1 = CPU_READ( state.t );
+  state.bit( state.m1 );
+  break;
+case Opcode::RZX_CMP:
+  CPU_READ( ++state.pc );
+  state.tl = state.eal + state.x;
+  state.m1 = CPU_READ( state.t );
+  state.cmp( state.m1 );
+  break;
+case Opcode::RZX_EOR:
+  CPU_READ( ++state.pc );
+  state.tl = state.eal + state.x;
+  state.m1 = CPU_READ( state.t );
+  state.setnz( state.a ^= state.m1 );
+  break;
+case Opcode::RZX_LDA:
+  CPU_READ( ++state.pc );
+  state.tl = state.eal + state.x;
+  state.m1 = CPU_READ( state.t );
+  state.setnz( state.a = state.m1 );
+  break;
+case Opcode::RZX_LDY:
+  CPU_READ( ++state.pc );
+  state.tl = state.eal + state.x;
+  state.m1 = CPU_READ( state.t );
+  state.setnz( state.y = state.m1 );
+  break;
+case Opcode::RZX_ORA:
+  CPU_READ( ++state.pc );
+  state.tl = state.eal + state.x;
+  state.m1 = CPU_READ( state.t );
+  state.setnz( state.a |= state.m1 );
+  break;
+case Opcode::RZX_ADC:
+  CPU_READ( ++state.pc );
+  state.tl = state.eal + state.x;
+  state.m1 = CPU_READ( state.t );
+  state.adc( state.m1 );
+  if ( state.d )
+  {
+    CPU_READ( state.t );
+  }
+  break;
+case Opcode::RZX_SBC:
+  CPU_READ( ++state.pc );
+  state.tl = state.eal + state.x;
+  state.m1 = CPU_READ( state.t );
+  state.sbc( state.m1 );
+  if ( state.d )
+  {
+    CPU_READ( state.t );
+  }
+  break;
+case Opcode::RZY_LDX:
+  CPU_READ( ++state.pc );
+  state.tl = state.eal + state.y;
+  state.m1 = CPU_READ( state.t );
+  state.setnz( state.x = state.m1 );
+  break;
+case Opcode::WZX_STA:
+  CPU_READ( ++state.pc );
+  state.tl = state.eal + state.x;
+  CPU_WRITE( state.t, state.a );
+  break;
+case Opcode::WZX_STY:
+  CPU_READ( ++state.pc );
+  state.tl = state.eal + state.x;
+  CPU_WRITE( state.t, state.y );
+  break;
+case Opcode::WZX_STZ:
+  CPU_READ( ++state.pc );
+  state.tl = state.eal + state.x;
+  CPU_WRITE( state.t, 0x00 );
+  break;
+case Opcode::WZY_STX:
+  CPU_READ( ++state.pc );
+  state.tl = state.eal + state.y;
+  CPU_WRITE( state.t, state.x );
+  break;
+case Opcode::MZX_ASL:
+  CPU_READ( state.pc++ );
+  state.tl = state.eal + state.x;
+  state.m1 = CPU_READ( state.t );
+  CPU_READ( state.t );
+  state.m2 = state.asl( state.m1 );
+  CPU_WRITE( state.t, state.m2 );
+  break;
+case Opcode::MZX_DEC:
+  CPU_READ( state.pc++ );
+  state.tl = state.eal + state.x;
+  state.m1 = CPU_READ( state.t );
+  CPU_READ( state.t );
+  state.m2 = state.dec( state.m1 );
+  CPU_WRITE( state.t, state.m2 );
+  break;
+case Opcode::MZX_INC:
+  CPU_READ( state.pc++ );
+  state.tl = state.eal + state.x;
+  state.m1 = CPU_READ( state.t );
+  CPU_READ( state.t );
+  state.m2 = state.inc( state.m1 );
+  CPU_WRITE( state.t, state.m2 );
+  break;
+case Opcode::MZX_LSR:
+  CPU_READ( state.pc++ );
+  state.tl = state.eal + state.x;
+  state.m1 = CPU_READ( state.t );
+  CPU_READ( state.t );
+  state.m2 = state.lsr( state.m1 );
+  CPU_WRITE( state.t, state.m2 );
+  break;
+case Opcode::MZX_ROL:
+  CPU_READ( state.pc++ );
+  state.tl = state.eal + state.x;
+  state.m1 = CPU_READ( state.t );
+  CPU_READ( state.t );
+  state.m2 = state.rol( state.m1 );
+  CPU_WRITE( state.t, state.m2 );
+  break;
+case Opcode::MZX_ROR:
+  CPU_READ( state.pc++ );
+  state.tl = state.eal + state.x;
+  state.m1 = CPU_READ( state.t );
+  CPU_READ( state.t );
+  state.m2 = state.ror( state.m1 );
+  CPU_WRITE( state.t, state.m2 );
+  break;
+case Opcode::RIN_AND:
+  ++state.pc;
+  state.fa = state.ea;
+  state.tl = CPU_READ( state.ea++ );
+  state.th = CPU_READ( state.ea );
+  state.m1 = CPU_READ( state.t );
+  state.setnz( state.a &= state.m1 );
+  break;
+case Opcode::RIN_CMP:
+  ++state.pc;
+  state.fa = state.ea;
+  state.tl = CPU_READ( state.ea++ );
+  state.th = CPU_READ( state.ea );
+  state.m1 = CPU_READ( state.t );
+  state.cmp( state.m1 );
+  break;
+case Opcode::RIN_EOR:
+  ++state.pc;
+  state.fa = state.ea;
+  state.tl = CPU_READ( state.ea++ );
+  state.th = CPU_READ( state.ea );
+  state.m1 = CPU_READ( state.t );
+  state.setnz( state.a ^= state.m1 );
+  break;
+case Opcode::RIN_LDA:
+  ++state.pc;
+  state.fa = state.ea;
+  state.tl = CPU_READ( state.ea++ );
+  state.th = CPU_READ( state.ea );
+  state.m1 = CPU_READ( state.t );
+  state.setnz( state.a = state.m1 );
+  break;
+case Opcode::RIN_ORA:
+  ++state.pc;
+  state.fa = state.ea;
+  state.tl = CPU_READ( state.ea++ );
+  state.th = CPU_READ( state.ea );
+  state.m1 = CPU_READ( state.t );
+  state.setnz( state.a |= state.m1 );
+  break;
+case Opcode::RIN_ADC:
+  ++state.pc;
+  state.fa = state.ea;
+  state.tl = CPU_READ( state.ea++ );
+  state.th = CPU_READ( state.ea );
+  state.m1 = CPU_READ( state.t );
+  state.adc( state.m1 );
+  if ( state.d )
+  {
+    CPU_READ( state.t );
+  }
+  break;
+case Opcode::RIN_SBC:
+  ++state.pc;
+  state.fa = state.ea;
+  state.tl = CPU_READ( state.ea++ );
+  state.th = CPU_READ( state.ea );
+  state.m1 = CPU_READ( state.t );
+  state.sbc( state.m1 );
+  if ( state.d )
+  {
+    CPU_READ( state.t );
+  }
+  break;
+case Opcode::WIN_STA:
+  ++state.pc;
+  state.fa = state.ea;
+  state.tl = CPU_READ( state.ea++ );
+  state.th = CPU_READ( state.ea );
+  CPU_WRITE( state.t, state.a );
+  break;
+case Opcode::RIX_AND:
+  CPU_READ( ++state.pc );
+  state.fa = state.ea;
+  state.eal += state.x;
+  state.tl = CPU_READ( state.ea++ );
+  state.th = CPU_READ( state.ea );
+  state.m1 = CPU_READ( state.t );
+  state.setnz( state.a &= state.m1 );
+  break;
+case Opcode::RIX_CMP:
+  CPU_READ( ++state.pc );
+  state.fa = state.ea;
+  state.eal += state.x;
+  state.tl = CPU_READ( state.ea++ );
+  state.th = CPU_READ( state.ea );
+  state.m1 = CPU_READ( state.t );
+  state.cmp( state.m1 );
+  break;
+case Opcode::RIX_EOR:
+  CPU_READ( ++state.pc );
+  state.fa = state.ea;
+  state.eal += state.x;
+  state.tl = CPU_READ( state.ea++ );
+  state.th = CPU_READ( state.ea );
+  state.m1 = CPU_READ( state.t );
+  state.setnz( state.a ^= state.m1 );
+  break;
+case Opcode::RIX_LDA:
+  CPU_READ( ++state.pc );
+  state.fa = state.ea;
+  state.eal += state.x;
+  state.tl = CPU_READ( state.ea++ );
+  state.th = CPU_READ( state.ea );
+  state.m1 = CPU_READ( state.t );
+  state.setnz( state.a = state.m1 );
+  break;
+case Opcode::RIX_ORA:
+  CPU_READ( ++state.pc );
+  state.fa = state.ea;
+  state.eal += state.x;
+  state.tl = CPU_READ( state.ea++ );
+  state.th = CPU_READ( state.ea );
+  state.m1 = CPU_READ( state.t );
+  state.setnz( state.a |= state.m1 );
+  break;
+case Opcode::RIX_ADC:
+  CPU_READ( ++state.pc );
+  state.fa = state.ea;
+  state.eal += state.x;
+  state.tl = CPU_READ( state.ea++ );
+  state.th = CPU_READ( state.ea );
+  state.m1 = CPU_READ( state.t );
+  state.adc( state.m1 );
+  if ( state.d )
+  {
+    CPU_READ( state.t );
+  }
+  break;
+case Opcode::RIX_SBC:
+  CPU_READ( ++state.pc );
+  state.fa = state.ea;
+  state.eal += state.x;
+  state.tl = CPU_READ( state.ea++ );
+  state.th = CPU_READ( state.ea );
+  state.m1 = CPU_READ( state.t );
+  state.sbc( state.m1 );
+  if ( state.d )
+  {
+    CPU_READ( state.t );
+  }
+  break;
+case Opcode::WIX_STA:
+  CPU_READ( ++state.pc );
+  state.fa = state.ea;
+  state.eal += state.x;
+  state.tl = CPU_READ( state.ea++ );
+  state.th = CPU_READ( state.ea );
+  CPU_WRITE( state.t, state.a );
+  break;
+case Opcode::RIY_AND:
+  CPU_READ( ++state.pc );
+  state.fa = state.ea;
+  state.tl = CPU_READ( state.ea++ );
+  state.th = CPU_READ( state.ea );
+  state.ea = state.t;
+  state.ea += state.y;
+  if ( state.eah != state.th )
+  {
+    state.tl += state.y;
+    CPU_READ( state.t );
+  }
+  state.m1 = CPU_READ( state.ea );
+  state.setnz( state.a &= state.m1 );
+  break;
+case Opcode::RIY_CMP:
+  CPU_READ( ++state.pc );
+  state.fa = state.ea;
+  state.tl = CPU_READ( state.ea++ );
+  state.th = CPU_READ( state.ea );
+  state.ea = state.t;
+  state.ea += state.y;
+  if ( state.eah != state.th )
+  {
+    state.tl += state.y;
+    CPU_READ( state.t );
+  }
+  state.m1 = CPU_READ( state.ea );
+  state.cmp( state.m1 );
+  break;
+case Opcode::RIY_EOR:
+  CPU_READ( ++state.pc );
+  state.fa = state.ea;
+  state.tl = CPU_READ( state.ea++ );
+  state.th = CPU_READ( state.ea );
+  state.ea = state.t;
+  state.ea += state.y;
+  if ( state.eah != state.th )
+  {
+    state.tl += state.y;
+    CPU_READ( state.t );
+  }
+  state.m1 = CPU_READ( state.ea );
+  state.setnz( state.a ^= state.m1 );
+  break;
+case Opcode::RIY_LDA:
+  CPU_READ( ++state.pc );
+  state.fa = state.ea;
+  state.tl = CPU_READ( state.ea++ );
+  state.th = CPU_READ( state.ea );
+  state.ea = state.t;
+  state.ea += state.y;
+  if ( state.eah != state.th )
+  {
+    state.tl += state.y;
+    CPU_READ( state.t );
+  }
+  state.m1 = CPU_READ( state.ea );
+  state.setnz( state.a = state.m1 );
+  break;
+case Opcode::RIY_ORA:
+  CPU_READ( ++state.pc );
+  state.fa = state.ea;
+  state.tl = CPU_READ( state.ea++ );
+  state.th = CPU_READ( state.ea );
+  state.ea = state.t;
+  state.ea += state.y;
+  if ( state.eah != state.th )
+  {
+    state.tl += state.y;
+    CPU_READ( state.t );
+  }
+  state.m1 = CPU_READ( state.ea );
+  state.setnz( state.a |= state.m1 );
+  break;
+case Opcode::RIY_ADC:
+  CPU_READ( ++state.pc );
+  state.fa = state.ea;
+  state.tl = CPU_READ( state.ea++ );
+  state.th = CPU_READ( state.ea );
+  state.ea = state.t;
+  state.ea += state.y;
+  if ( state.eah != state.th )
+  {
+    state.tl += state.y;
+    CPU_READ( state.t );
+  }
+  state.m1 = CPU_READ( state.ea );
+  state.adc( state.m1 );
+  if ( state.d )
+  {
+    CPU_READ( state.t );
+  }
+  break;
+case Opcode::RIY_SBC:
+  CPU_READ( ++state.pc );
+  state.fa = state.ea;
+  state.tl = CPU_READ( state.ea++ );
+  state.th = CPU_READ( state.ea );
+  state.ea = state.t;
+  state.ea += state.y;
+  if ( state.eah != state.th )
+  {
+    state.tl += state.y;
+    CPU_READ( state.t );
+  }
+  state.m1 = CPU_READ( state.ea );
+  state.sbc( state.m1 );
+  if ( state.d )
+  {
+    CPU_READ( state.t );
+  }
+  break;
+case Opcode::WIY_STA:
+  CPU_READ( ++state.pc );
+  state.fa = state.ea;
+  state.tl = CPU_READ( state.ea++ );
+  state.th = CPU_READ( state.ea );
+  state.ea = state.t;
+  state.ea += state.y;
+  state.tl += state.y;
+  CPU_READ( state.t );
+  CPU_WRITE( state.ea, state.a );
+  break;
+case Opcode::RAB_AND:
+  ++state.pc;
+  state.eah = CPU_FETCH_OPERAND( state.pc++ );
+  state.m1 = CPU_READ( state.ea );
+  state.setnz( state.a &= state.m1 );
+  break;
+case Opcode::RAB_BIT:
+  ++state.pc;
+  state.eah = CPU_FETCH_OPERAND( state.pc++ );
+  state.m1 = CPU_READ( state.ea );
+  state.bit( state.m1 );
+  break;
+case Opcode::RAB_CMP:
+  ++state.pc;
+  state.eah = CPU_FETCH_OPERAND( state.pc++ );
+  state.m1 = CPU_READ( state.ea );
+  state.cmp( state.m1 );
+  break;
+case Opcode::RAB_CPX:
+  ++state.pc;
+  state.eah = CPU_FETCH_OPERAND( state.pc++ );
+  state.m1 = CPU_READ( state.ea );
+  state.cpx( state.m1 );
+  break;
+case Opcode::RAB_CPY:
+  ++state.pc;
+  state.eah = CPU_FETCH_OPERAND( state.pc++ );
+  state.m1 = CPU_READ( state.ea );
+  state.cpy( state.m1 );
+  break;
+case Opcode::RAB_EOR:
+  ++state.pc;
+  state.eah = CPU_FETCH_OPERAND( state.pc++ );
+  state.m1 = CPU_READ( state.ea );
+  state.setnz( state.a ^= state.m1 );
+  break;
+case Opcode::RAB_LDA:
+  ++state.pc;
+  state.eah = CPU_FETCH_OPERAND( state.pc++ );
+  state.m1 = CPU_READ( state.ea );
+  state.setnz( state.a = state.m1 );
+  break;
+case Opcode::RAB_LDX:
+  ++state.pc;
+  state.eah = CPU_FETCH_OPERAND( state.pc++ );
+  state.m1 = CPU_READ( state.ea );
+  state.setnz( state.x = state.m1 );
+  break;
+case Opcode::RAB_LDY:
+  ++state.pc;
+  state.eah = CPU_FETCH_OPERAND( state.pc++ );
+  state.m1 = CPU_READ( state.ea );
+  state.setnz( state.y = state.m1 );
+  break;
+case Opcode::RAB_ORA:
+  ++state.pc;
+  state.eah = CPU_FETCH_OPERAND( state.pc++ );
+  state.m1 = CPU_READ( state.ea );
+  state.setnz( state.a |= state.m1 );
+  break;
+case Opcode::RAB_ADC:
+  ++state.pc;
+  state.eah = CPU_FETCH_OPERAND( state.pc++ );
+  state.m1 = CPU_READ( state.ea );
+  state.adc( state.m1 );
+  if ( state.d )
+  {
+    CPU_READ( state.ea );
+  }
+  break;
+case Opcode::RAB_SBC:
+  ++state.pc;
+  state.eah = CPU_FETCH_OPERAND( state.pc++ );
+  state.m1 = CPU_READ( state.ea );
+  state.sbc( state.m1 );
+  if ( state.d )
+  {
+    CPU_READ( state.ea );
+  }
+  break;
+case Opcode::WAB_STA:
+  ++state.pc;
+  state.eah = CPU_FETCH_OPERAND( state.pc++ );
+  CPU_WRITE( state.ea, state.a );
+  break;
+case Opcode::WAB_STX:
+  ++state.pc;
+  state.eah = CPU_FETCH_OPERAND( state.pc++ );
+  CPU_WRITE( state.ea, state.x );
+  break;
+case Opcode::WAB_STY:
+  ++state.pc;
+  state.eah = CPU_FETCH_OPERAND( state.pc++ );
+  CPU_WRITE( state.ea, state.y );
+  break;
+case Opcode::WAB_STZ:
+  ++state.pc;
+  state.eah = CPU_FETCH_OPERAND( state.pc++ );
+  CPU_WRITE( state.ea, 0x00 );
+  break;
+case Opcode::MAB_ASL:
+  ++state.pc;
+  state.eah = CPU_FETCH_OPERAND( state.pc++ );
+  state.m1 = CPU_READ( state.ea );
+  CPU_READ( state.ea );
+  state.m2 = state.asl( state.m1 );
+  CPU_WRITE( state.ea, state.m2 );
+  break;
+case Opcode::MAB_DEC:
+  ++state.pc;
+  state.eah = CPU_FETCH_OPERAND( state.pc++ );
+  state.m1 = CPU_READ( state.ea );
+  CPU_READ( state.ea );
+  state.m2 = state.dec( state.m1 );
+  CPU_WRITE( state.ea, state.m2 );
+  break;
+case Opcode::MAB_INC:
+  ++state.pc;
+  state.eah = CPU_FETCH_OPERAND( state.pc++ );
+  state.m1 = CPU_READ( state.ea );
+  CPU_READ( state.ea );
+  state.m2 = state.inc( state.m1 );
+  CPU_WRITE( state.ea, state.m2 );
+  break;
+case Opcode::MAB_LSR:
+  ++state.pc;
+  state.eah = CPU_FETCH_OPERAND( state.pc++ );
+  state.m1 = CPU_READ( state.ea );
+  CPU_READ( state.ea );
+  state.m2 = state.lsr( state.m1 );
+  CPU_WRITE( state.ea, state.m2 );
+  break;
+case Opcode::MAB_ROL:
+  ++state.pc;
+  state.eah = CPU_FETCH_OPERAND( state.pc++ );
+  state.m1 = CPU_READ( state.ea );
+  CPU_READ( state.ea );
+  state.m2 = state.rol( state.m1 );
+  CPU_WRITE( state.ea, state.m2 );
+  break;
+case Opcode::MAB_ROR:
+  ++state.pc;
+  state.eah = CPU_FETCH_OPERAND( state.pc++ );
+  state.m1 = CPU_READ( state.ea );
+  CPU_READ( state.ea );
+  state.m2 = state.ror( state.m1 );
+  CPU_WRITE( state.ea, state.m2 );
+  break;
+case Opcode::MAB_TRB:
+  ++state.pc;
+  state.eah = CPU_FETCH_OPERAND( state.pc++ );
+  state.m1 = CPU_READ( state.ea );
+  CPU_READ( state.ea );
+  state.setz( state.m1 & state.a );
+  state.m2 = state.m1 & ~state.a;
+  CPU_WRITE( state.ea, state.m2 );
+  break;
+case Opcode::MAB_TSB:
+  ++state.pc;
+  state.eah = CPU_FETCH_OPERAND( state.pc++ );
+  state.m1 = CPU_READ( state.ea );
+  CPU_READ( state.ea );
+  state.setz( state.m1 & state.a );
+  state.m2 = state.m1 | state.a;
+  CPU_WRITE( state.ea, state.m2 );
+  break;
+case Opcode::RAX_AND:
+  state.eah = CPU_FETCH_OPERAND( state.pc + 1 );
+  state.fa = state.ea + state.x;
+  if ( state.eah != state.fah )
+  {
+    CPU_READ( state.pc + 1 );
+  }
+  state.m1 = CPU_READ( state.fa );
+  state.setnz( state.a &= state.m1 );
+  state.pc += 2;
+  break;
+case Opcode::RAX_BIT:
+  state.eah = CPU_FETCH_OPERAND( state.pc + 1 );
+  state.fa = state.ea + state.x;
+  if ( state.eah != state.fah )
+  {
+    CPU_READ( state.pc + 1 );
+  }
+  state.m1 = CPU_READ( state.fa );
+  state.bit( state.m1 );
+  state.pc += 2;
+  break;
+case Opcode::RAX_CMP:
+  state.eah = CPU_FETCH_OPERAND( state.pc + 1 );
+  state.fa = state.ea + state.x;
+  if ( state.eah != state.fah )
+  {
+    CPU_READ( state.pc + 1 );
+  }
+  state.m1 = CPU_READ( state.fa );
+  state.cmp( state.m1 );
+  state.pc += 2;
+  break;
+case Opcode::RAX_EOR:
+  state.eah = CPU_FETCH_OPERAND( state.pc + 1 );
+  state.fa = state.ea + state.x;
+  if ( state.eah != state.fah )
+  {
+    CPU_READ( state.pc + 1 );
+  }
+  state.m1 = CPU_READ( state.fa );
+  state.setnz( state.a ^= state.m1 );
+  state.pc += 2;
+  break;
+case Opcode::RAX_LDA:
+  state.eah = CPU_FETCH_OPERAND( state.pc + 1 );
+  state.fa = state.ea + state.x;
+  if ( state.eah != state.fah )
+  {
+    CPU_READ( state.pc + 1 );
+  }
+  state.m1 = CPU_READ( state.fa );
+  state.setnz( state.a = state.m1 );
+  state.pc += 2;
+  break;
+case Opcode::RAX_LDY:
+  state.eah = CPU_FETCH_OPERAND( state.pc + 1 );
+  state.fa = state.ea + state.x;
+  if ( state.eah != state.fah )
+  {
+    CPU_READ( state.pc + 1 );
+  }
+  state.m1 = CPU_READ( state.fa );
+  state.setnz( state.y = state.m1 );
+  state.pc += 2;
+  break;
+case Opcode::RAX_ORA:
+  state.eah = CPU_FETCH_OPERAND( state.pc + 1 );
+  state.fa = state.ea + state.x;
+  if ( state.eah != state.fah )
+  {
+    CPU_READ( state.pc + 1 );
+  }
+  state.m1 = CPU_READ( state.fa );
+  state.setnz( state.a |= state.m1 );
+  state.pc += 2;
+  break;
+case Opcode::RAX_ADC:
+  state.eah = CPU_FETCH_OPERAND( state.pc + 1 );
+  state.fa = state.ea + state.x;
+  if ( state.eah != state.fah )
+  {
+    CPU_READ( state.pc + 1 );
+  }
+  state.m1 = CPU_READ( state.fa );
+  state.adc( state.m1 );
+  if ( state.d )
+  {
+    CPU_READ( state.fa );
+  }
+  state.pc += 2;
+  break;
+case Opcode::RAX_SBC:
+  state.eah = CPU_FETCH_OPERAND( state.pc + 1 );
+  state.fa = state.ea + state.x;
+  if ( state.eah != state.fah )
+  {
+    CPU_READ( state.pc + 1 );
+  }
+  state.m1 = CPU_READ( state.fa );
+  state.sbc( state.m1 );
+  if ( state.d )
+  {
+    CPU_READ( state.fa );
+  }
+  state.pc += 2;
+  break;
+case Opcode::RAY_AND:
+  state.eah = CPU_FETCH_OPERAND( state.pc + 1 );
+  state.fa = state.ea + state.y;
+  if ( state.eah != state.fah )
+  {
+    CPU_READ( state.pc + 1 );
+  }
+  state.m1 = CPU_READ( state.fa );
+  state.setnz( state.a &= state.m1 );
+  state.pc += 2;
+  break;
+case Opcode::RAY_CMP:
+  state.eah = CPU_FETCH_OPERAND( state.pc + 1 );
+  state.fa = state.ea + state.y;
+  if ( state.eah != state.fah )
+  {
+    CPU_READ( state.pc + 1 );
+  }
+  state.m1 = CPU_READ( state.fa );
+  state.cmp( state.m1 );
+  state.pc += 2;
+  break;
+case Opcode::RAY_EOR:
+  state.eah = CPU_FETCH_OPERAND( state.pc + 1 );
+  state.fa = state.ea + state.y;
+  if ( state.eah != state.fah )
+  {
+    CPU_READ( state.pc + 1 );
+  }
+  state.m1 = CPU_READ( state.fa );
+  state.setnz( state.a ^= state.m1 );
+  state.pc += 2;
+  break;
+case Opcode::RAY_LDA:
+  state.eah = CPU_FETCH_OPERAND( state.pc + 1 );
+  state.fa = state.ea + state.y;
+  if ( state.eah != state.fah )
+  {
+    CPU_READ( state.pc + 1 );
+  }
+  state.m1 = CPU_READ( state.fa );
+  state.setnz( state.a = state.m1 );
+  state.pc += 2;
+  break;
+case Opcode::RAY_LDX:
+  state.eah = CPU_FETCH_OPERAND( state.pc + 1 );
+  state.fa = state.ea + state.y;
+  if ( state.eah != state.fah )
+  {
+    CPU_READ( state.pc + 1 );
+  }
+  state.m1 = CPU_READ( state.fa );
+  state.setnz( state.x = state.m1 );
+  state.pc += 2;
+  break;
+case Opcode::RAY_ORA:
+  state.eah = CPU_FETCH_OPERAND( state.pc + 1 );
+  state.fa = state.ea + state.y;
+  if ( state.eah != state.fah )
+  {
+    CPU_READ( state.pc + 1 );
+  }
+  state.m1 = CPU_READ( state.fa );
+  state.setnz( state.a |= state.m1 );
+  state.pc += 2;
+  break;
+case Opcode::RAY_ADC:
+  state.eah = CPU_FETCH_OPERAND( state.pc + 1 );
+  state.fa = state.ea + state.y;
+  if ( state.eah != state.fah )
+  {
+    CPU_READ( state.pc + 1 );
+  }
+  state.m1 = CPU_READ( state.fa );
+  state.adc( state.m1 );
+  if ( state.d )
+  {
+    CPU_READ( state.ea );
+  }
+  state.pc += 2;
+  break;
+case Opcode::RAY_SBC:
+  state.eah = CPU_FETCH_OPERAND( state.pc + 1 );
+  state.fa = state.ea + state.y;
+  if ( state.eah != state.fah )
+  {
+    CPU_READ( state.pc + 1 );
+  }
+  state.m1 = CPU_READ( state.fa );
+  state.sbc( state.m1 );
+  if ( state.d )
+  {
+    CPU_READ( state.ea );
+  }
+  state.pc += 2;
+  break;
+case Opcode::WAX_STA:
+  state.eah = CPU_FETCH_OPERAND( state.pc + 1 );
+  state.fa = state.ea + state.x;
+  CPU_READ( state.pc + 1 );
+  CPU_WRITE( state.fa, state.a );
+  state.pc += 2;
+  break;
+case Opcode::WAX_STZ:
+  state.eah = CPU_FETCH_OPERAND( state.pc + 1 );
+  state.fa = state.ea + state.x;
+  CPU_READ( state.pc + 1 );
+  CPU_WRITE( state.fa, 0x00 );
+  state.pc += 2;
+  break;
+case Opcode::WAY_STA:
+  state.eah = CPU_FETCH_OPERAND( state.pc + 1 );
+  state.fa = state.ea + state.y;
+  CPU_READ( state.pc + 1 );
+  CPU_WRITE( state.fa, state.a );
+  state.pc += 2;
+  break;
+case Opcode::MAX_ASL:
+  state.eah = CPU_FETCH_OPERAND( state.pc + 1 );
+  state.fa = state.ea + state.x;
+  if ( state.eah != state.fah )
+  {
+    CPU_READ( state.pc + 1 );
+  }
+  state.m1 = CPU_READ( state.fa );
+  CPU_READ( state.fa );
+  state.m2 = state.asl( state.m1 );
+  CPU_WRITE( state.fa, state.m2 );
+  state.pc += 2;
+  break;
+case Opcode::MAX_DEC:
+  state.eah = CPU_FETCH_OPERAND( state.pc + 1 );
+  state.fa = state.ea + state.x;
+  if ( state.eah != state.fah )
+  {
+    CPU_READ( state.pc + 1 );
+  }
+  state.m1 = CPU_READ( state.fa );
+  CPU_READ( state.fa );
+  state.m2 = state.dec( state.m1 );
+  CPU_WRITE( state.fa, state.m2 );
+  state.pc += 2;
+  break;
+case Opcode::MAX_INC:
+  state.eah = CPU_FETCH_OPERAND( state.pc + 1 );
+  state.fa = state.ea + state.x;
+  if ( state.eah != state.fah )
+  {
+    CPU_READ( state.pc + 1 );
+  }
+  state.m1 = CPU_READ( state.fa );
+  CPU_READ( state.fa );
+  state.m2 = state.inc( state.m1 );
+  CPU_WRITE( state.fa, state.m2 );
+  state.pc += 2;
+  break;
+case Opcode::MAX_LSR:
+  state.eah = CPU_FETCH_OPERAND( state.pc + 1 );
+  state.fa = state.ea + state.x;
+  if ( state.eah != state.fah )
+  {
+    CPU_READ( state.pc + 1 );
+  }
+  state.m1 = CPU_READ( state.fa );
+  CPU_READ( state.fa );
+  state.m2 = state.lsr( state.m1 );
+  CPU_WRITE( state.fa, state.m2 );
+  state.pc += 2;
+  break;
+case Opcode::MAX_ROL:
+  state.eah = CPU_FETCH_OPERAND( state.pc + 1 );
+  state.fa = state.ea + state.x;
+  if ( state.eah != state.fah )
+  {
+    CPU_READ( state.pc + 1 );
+  }
+  state.m1 = CPU_READ( state.fa );
+  CPU_READ( state.fa );
+  state.m2 = state.rol( state.m1 );
+  CPU_WRITE( state.fa, state.m2 );
+  state.pc += 2;
+  break;
+case Opcode::MAX_ROR:
+  state.eah = CPU_FETCH_OPERAND( state.pc + 1 );
+  state.fa = state.ea + state.x;
+  if ( state.eah != state.fah )
+  {
+    CPU_READ( state.pc + 1 );
+  }
+  state.m1 = CPU_READ( state.fa );
+  CPU_READ( state.fa );
+  state.m2 = state.ror( state.m1 );
+  CPU_WRITE( state.fa, state.m2 );
+  state.pc += 2;
+  break;
+case Opcode::JMA_JMP:
+  ++state.pc;
+  state.eah = CPU_FETCH_OPERAND( state.pc++ );
+  state.pc = state.ea;
+  break;
+case Opcode::JSA_JSR:
+  ++state.pc;
+  CPU_READ( state.s );
+  CPU_WRITE( state.s, state.pch );
+  state.sl--;
+  CPU_WRITE( state.s, state.pcl );
+  state.sl--;
+  state.eah = CPU_FETCH_OPERAND( state.pc++ );
+  state.pc = state.ea;
+  if ( mReq.cpuBreakType == CpuBreakType::STEP_OVER )
+  {
+    mReq.cpuBreakType = CpuBreakType::NONE;
+    mStackBreakCondition = state.s;
+  }
+  break;
+case Opcode::JMX_JMP:
+  ++state.pc;
+  state.eah = CPU_FETCH_OPERAND( state.pc++ );
+  CPU_READ( state.pc );
+  state.fa = state.t = state.ea;
+  state.eal += state.x;
+  CPU_READ( state.ea );
+  state.t += state.x;
+  state.eal = CPU_READ( state.t++ );
+  state.eah = CPU_READ( state.t );
+  state.pc = state.ea;
+  break;
+case Opcode::JMI_JMP:
+  ++state.pc;
+  state.eah = CPU_FETCH_OPERAND( state.pc++ );
+  state.fa = state.tl = CPU_READ( state.ea );
+  state.eal++;
+  CPU_READ( state.ea );
+  state.eah += state.eal == 0 ? 1 : 0;
+  state.th = CPU_READ( state.ea );
+  state.pc = state.t;
+  break;
+case Opcode::IMP_ASL:
+  state.a = state.asl( state.a );
+  break;
+case Opcode::IMP_CLC:
+  state.c.clear();
+  break;
+case Opcode::IMP_CLD:
+  state.d.clear();
+  break;
+case Opcode::IMP_CLI:
+  state.i.clear();
+  break;
+case Opcode::IMP_CLV:
+  state.v.clear();
+  break;
+case Opcode::IMP_DEC:
+  state.a = state.dec( state.a );
+  break;
+case Opcode::IMP_DEX:
+  state.x = state.dec( state.x );
+  break;
+case Opcode::IMP_DEY:
+  state.y = state.dec( state.y );
+  break;
+case Opcode::IMP_INC:
+  state.a = state.inc( state.a );
+  break;
+case Opcode::IMP_INX:
+  state.x = state.inc( state.x );
+  break;
+case Opcode::IMP_INY:
+  state.y = state.inc( state.y );
+  break;
+case Opcode::IMP_LSR:
+  state.a = state.lsr( state.a );
+  break;
+case Opcode::IMP_NOP:
+  break;
+case Opcode::IMP_ROL:
+  state.a = state.rol( state.a );
+  break;
+case Opcode::IMP_ROR:
+  state.a = state.ror( state.a );
+  break;
+case Opcode::IMP_SEC:
+  state.c.set();
+  break;
+case Opcode::IMP_SED:
+  state.d.set();
+  break;
+case Opcode::IMP_SEI:
+  state.i.set();
+  break;
+case Opcode::IMP_TAX:
+  state.setnz( state.x = state.a );
+  break;
+case Opcode::IMP_TAY:
+  state.setnz( state.y = state.a );
+  break;
+case Opcode::IMP_TSX:
+  state.setnz( state.x = state.sl );
+  break;
+case Opcode::IMP_TXA:
+  state.setnz( state.a = state.x );
+  break;
+case Opcode::IMP_TXS:
+  state.sl = state.x;
+  break;
+case Opcode::IMP_TYA:
+  state.setnz( state.a = state.y );
+  break;
+case Opcode::IMM_AND:
+  ++state.pc;
+  state.setnz( state.a &= state.eal );
+  break;
+case Opcode::IMM_BIT:
+  ++state.pc;
+  state.setz( state.a & state.eal );
+  break;
+case Opcode::IMM_CMP:
+  ++state.pc;
+  state.cmp( state.eal );
+  break;
+case Opcode::IMM_CPX:
+  ++state.pc;
+  state.cpx( state.eal );
+  break;
+case Opcode::IMM_CPY:
+  ++state.pc;
+  state.cpy( state.eal );
+  break;
+case Opcode::IMM_EOR:
+  ++state.pc;
+  state.setnz( state.a ^= state.eal );
+  break;
+case Opcode::IMM_LDA:
+  ++state.pc;
+  state.setnz( state.a = state.eal );
+  break;
+case Opcode::IMM_LDX:
+  ++state.pc;
+  state.setnz( state.x = state.eal );
+  break;
+case Opcode::IMM_LDY:
+  ++state.pc;
+  state.setnz( state.y = state.eal );
+  break;
+case Opcode::IMM_ORA:
+  ++state.pc;
+  state.setnz( state.a |= state.eal );
+  break;
+case Opcode::IMM_ADC:
+  ++state.pc;
+  state.adc( state.eal );
+  if ( state.d )
+  {
+    CPU_READ( state.pc );
+  }
+  break;
+case Opcode::IMM_SBC:
+  ++state.pc;
+  state.sbc( state.eal );
+  if ( state.d )
+  {
+    CPU_READ( state.pc );
+  }
+  break;
+case Opcode::BRL_BCC:
+  ++state.pc;
+  state.t = state.pc + ( int8_t )state.eal;
+  if ( !state.c )
+  {
+    CPU_READ( state.pc );
+    if ( state.th != state.pch )
+    {
+      CPU_READ( state.pc );
+    }
+    state.pc = state.t;
+  }
+  break;
+case Opcode::BRL_BCS:
+  ++state.pc;
+  state.t = state.pc + ( int8_t )state.eal;
+  if ( state.c )
+  {
+    CPU_READ( state.pc );
+    if ( state.th != state.pch )
+    {
+      CPU_READ( state.pc );
+    }
+    state.pc = state.t;
+  }
+  break;
+case Opcode::BRL_BEQ:
+  ++state.pc;
+  state.t = state.pc + ( int8_t )state.eal;
+  if ( state.z )
+  {
+    CPU_READ( state.pc );
+    if ( state.th != state.pch )
+    {
+      CPU_READ( state.pc );
+    }
+    state.pc = state.t;
+  }
+  break;
+case Opcode::BRL_BMI:
+  ++state.pc;
+  state.t = state.pc + ( int8_t )state.eal;
+  if ( state.n )
+  {
+    CPU_READ( state.pc );
+    if ( state.th != state.pch )
+    {
+      CPU_READ( state.pc );
+    }
+    state.pc = state.t;
+  }
+  break;
+case Opcode::BRL_BNE:
+  ++state.pc;
+  state.t = state.pc + ( int8_t )state.eal;
+  if ( !state.z )
+  {
+    CPU_READ( state.pc );
+    if ( state.th != state.pch )
+    {
+      CPU_READ( state.pc );
+    }
+    state.pc = state.t;
+  }
+  break;
+case Opcode::BRL_BPL:
+  ++state.pc;
+  state.t = state.pc + ( int8_t )state.eal;
+  if ( !state.n )
+  {
+    CPU_READ( state.pc );
+    if ( state.th != state.pch )
+    {
+      CPU_READ( state.pc );
+    }
+    state.pc = state.t;
+  }
+  break;
+case Opcode::BRL_BRA:
+  CPU_READ( ++state.pc );
+  state.t = state.pc + ( int8_t )state.eal;
+  if ( state.th != state.pch )
+  {
+    CPU_READ( state.pc );
+  }
+  state.pc = state.t;
+  break;
+case Opcode::BRL_BVC:
+  ++state.pc;
+  state.t = state.pc + ( int8_t )state.eal;
+  if ( !state.v )
+  {
+    CPU_READ( state.pc );
+    if ( state.th != state.pch )
+    {
+      CPU_READ( state.pc );
+    }
+    state.pc = state.t;
+  }
+  break;
+case Opcode::BRL_BVS:
+  ++state.pc;
+  state.t = state.pc + ( int8_t )state.eal;
+  if ( state.v )
+  {
+    CPU_READ( state.pc );
+    if ( state.th != state.pch )
+    {
+      CPU_READ( state.pc );
+    }
+    state.pc = state.t;
+  }
+  break;
+case Opcode::BZR_BBR0:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  state.tl = CPU_FETCH_OPERAND( state.pc++ );
+  CPU_READ( state.ea );
+  state.t = state.pc + ( int8_t )state.tl;
+  if ( ( state.m1 & 0x01 ) == 0 )
+  {
+    state.pc = state.t;
+  }
+  break;
+case Opcode::BZR_BBR1:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  state.tl = CPU_FETCH_OPERAND( state.pc++ );
+  CPU_READ( state.ea );
+  state.t = state.pc + ( int8_t )state.tl;
+  if ( ( state.m1 & 0x02 ) == 0 )
+  {
+    state.pc = state.t;
+  }
+  break;
+case Opcode::BZR_BBR2:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  state.tl = CPU_FETCH_OPERAND( state.pc++ );
+  CPU_READ( state.ea );
+  state.t = state.pc + ( int8_t )state.tl;
+  if ( ( state.m1 & 0x04 ) == 0 )
+  {
+    state.pc = state.t;
+  }
+  break;
+case Opcode::BZR_BBR3:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  state.tl = CPU_FETCH_OPERAND( state.pc++ );
+  CPU_READ( state.ea );
+  state.t = state.pc + ( int8_t )state.tl;
+  if ( ( state.m1 & 0x08 ) == 0 )
+  {
+    state.pc = state.t;
+  }
+  break;
+case Opcode::BZR_BBR4:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  state.tl = CPU_FETCH_OPERAND( state.pc++ );
+  CPU_READ( state.ea );
+  state.t = state.pc + ( int8_t )state.tl;
+  if ( ( state.m1 & 0x10 ) == 0 )
+  {
+    state.pc = state.t;
+  }
+  break;
+case Opcode::BZR_BBR5:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  state.tl = CPU_FETCH_OPERAND( state.pc++ );
+  CPU_READ( state.ea );
+  state.t = state.pc + ( int8_t )state.tl;
+  if ( ( state.m1 & 0x20 ) == 0 )
+  {
+    state.pc = state.t;
+  }
+  break;
+case Opcode::BZR_BBR6:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  state.tl = CPU_FETCH_OPERAND( state.pc++ );
+  CPU_READ( state.ea );
+  state.t = state.pc + ( int8_t )state.tl;
+  if ( ( state.m1 & 0x40 ) == 0 )
+  {
+    state.pc = state.t;
+  }
+  break;
+case Opcode::BZR_BBR7:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  state.tl = CPU_FETCH_OPERAND( state.pc++ );
+  CPU_READ( state.ea );
+  state.t = state.pc + ( int8_t )state.tl;
+  if ( ( state.m1 & 0x80 ) == 0 )
+  {
+    state.pc = state.t;
+  }
+  break;
+case Opcode::BZR_BBS0:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  state.tl = CPU_FETCH_OPERAND( state.pc++ );
+  CPU_READ( state.ea );
+  state.t = state.pc + ( int8_t )state.tl;
+  if ( ( state.m1 & 0x01 ) != 0 )
+  {
+    state.pc = state.t;
+  }
+  break;
+case Opcode::BZR_BBS1:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  state.tl = CPU_FETCH_OPERAND( state.pc++ );
+  CPU_READ( state.ea );
+  state.t = state.pc + ( int8_t )state.tl;
+  if ( ( state.m1 & 0x02 ) != 0 )
+  {
+    state.pc = state.t;
+  }
+  break;
+case Opcode::BZR_BBS2:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  state.tl = CPU_FETCH_OPERAND( state.pc++ );
+  CPU_READ( state.ea );
+  state.t = state.pc + ( int8_t )state.tl;
+  if ( ( state.m1 & 0x04 ) != 0 )
+  {
+    state.pc = state.t;
+  }
+  break;
+case Opcode::BZR_BBS3:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  state.tl = CPU_FETCH_OPERAND( state.pc++ );
+  CPU_READ( state.ea );
+  state.t = state.pc + ( int8_t )state.tl;
+  if ( ( state.m1 & 0x08 ) != 0 )
+  {
+    state.pc = state.t;
+  }
+  break;
+case Opcode::BZR_BBS4:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  state.tl = CPU_FETCH_OPERAND( state.pc++ );
+  CPU_READ( state.ea );
+  state.t = state.pc + ( int8_t )state.tl;
+  if ( ( state.m1 & 0x10 ) != 0 )
+  {
+    state.pc = state.t;
+  }
+  break;
+case Opcode::BZR_BBS5:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  state.tl = CPU_FETCH_OPERAND( state.pc++ );
+  CPU_READ( state.ea );
+  state.t = state.pc + ( int8_t )state.tl;
+  if ( ( state.m1 & 0x20 ) != 0 )
+  {
+    state.pc = state.t;
+  }
+  break;
+case Opcode::BZR_BBS6:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  state.tl = CPU_FETCH_OPERAND( state.pc++ );
+  CPU_READ( state.ea );
+  state.t = state.pc + ( int8_t )state.tl;
+  if ( ( state.m1 & 0x40 ) != 0 )
+  {
+    state.pc = state.t;
+  }
+  break;
+case Opcode::BZR_BBS7:
+  ++state.pc;
+  state.m1 = CPU_READ( state.ea );
+  state.tl = CPU_FETCH_OPERAND( state.pc++ );
+  CPU_READ( state.ea );
+  state.t = state.pc + ( int8_t )state.tl;
+  if ( ( state.m1 & 0x80 ) != 0 )
+  {
+    state.pc = state.t;
+  }
+  break;
+case Opcode::BRK_BRK:
+  if ( state.interrupt & CPUState::I_RESET )
+  {
+    CPU_READ( state.s );
+    state.sl--;
+    CPU_READ( state.s );
+    state.sl--;
+    CPU_READ( state.s );
+    state.sl--;
+    state.eal = CPU_READ( RESET_VECTOR );
+    state.eah = CPU_READ( RESET_VECTOR + 1 );
+  }
+  else
+  {
+    //on state.interrupt PC should point to interrupted instruction
+    if ( state.interrupt )
+    {
+      state.pc -= 1;
+    }
+    //on BRK PC should point past BRK argument
+    else
+    {
+      state.pc += 1;
+      //BRK is treated as NOP if mBreakOnBrk is true
+      if ( mBreakOnBrk )
+      {
+        mReq.cpuBreakType = CpuBreakType::BRK_INSTRUCTION;
+        break;
+      }
+      // "brk #$42" will be ignored
+      if (state.ea == 0x42)
+      {
+          mReq.cpuBreakType = CpuBreakType::NONE;
+          break;
+      }
+    }
+    CPU_WRITE( state.s, state.pch );
+    state.sl--;
+    CPU_WRITE( state.s, state.pcl );
+    state.sl--;
+    CPU_WRITE( state.s, state.getP() );
+    state.sl--;
+    if ( state.interrupt & CPUState::I_NMI )
+    {
+      state.eal = CPU_READ( NMI_VECTOR );
+      state.eah = CPU_READ( NMI_VECTOR + 1 );
+    }
+    else
+    {
+      state.eal = CPU_READ( IRQ_VECTOR );
+      state.eah = CPU_READ( IRQ_VECTOR + 1 );
+    }
+    state.i.set();
+  }
+  state.d.clear();
+  state.pc = state.ea;
+  if ( mReq.cpuBreakType == CpuBreakType::STEP_OVER )
+  {
+    mReq.cpuBreakType = CpuBreakType::NONE;
+    mStackBreakCondition = state.s;
+  }
+  break;
+case Opcode::RTI_RTI:
+  ++state.pc;
+  ++state.sl;
+  state.setP( CPU_READ( state.s ) );
+  ++state.sl;
+  state.eal = CPU_READ( state.s );
+  ++state.sl;
+  state.eah = CPU_READ( state.s );
+  if ( mStackBreakCondition < state.s )
+  {
+    mReq.cpuBreakType = mPostponedStepOut ? CpuBreakType::STEP_OUT : CpuBreakType::STEP_OVER;
+    mPostponedStepOut = false;
+    mStackBreakCondition = 0xffff;
+  }
+  CPU_READ( state.pc );
+  state.pc = state.ea;
+  break;
+case Opcode::RTS_RTS:
+  CPU_READ( ++state.pc );
+  ++state.sl;
+  state.eal = CPU_READ( state.s );
+  ++state.sl;
+  state.eah = CPU_READ( state.s );
+  if ( mStackBreakCondition < state.s )
+  {
+    mReq.cpuBreakType = mPostponedStepOut ? CpuBreakType::STEP_OUT : CpuBreakType::STEP_OVER;
+    mPostponedStepOut = false;
+    mStackBreakCondition = 0xffff;
+  }
+  CPU_READ( state.pc );
+  ++state.ea;
+  state.pc = state.ea;
+  break;
+case Opcode::PHR_PHA:
+  CPU_WRITE( state.s, state.a );
+  state.sl--;
+  break;
+case Opcode::PHR_PHP:
+  CPU_WRITE( state.s, state.getP() );
+  state.sl--;
+  break;
+case Opcode::PHR_PHX:
+  CPU_WRITE( state.s, state.x );
+  state.sl--;
+  break;
+case Opcode::PHR_PHY:
+  CPU_WRITE( state.s, state.y );
+  state.sl--;
+  break;
+case Opcode::PLR_PLA:
+  CPU_READ( state.pc );
+  ++state.sl;
+  state.setnz( state.a = CPU_READ( state.s ) );
+  break;
+case Opcode::PLR_PLP:
+  CPU_READ( state.pc );
+  ++state.sl;
+  state.setP( CPU_READ( state.s ) );
+  break;
+case Opcode::PLR_PLX:
+  CPU_READ( state.pc );
+  ++state.sl;
+  state.setnz( state.x = CPU_READ( state.s ) );
+  break;
+case Opcode::PLR_PLY:
+  CPU_READ( state.pc );
+  ++state.sl;
+  state.setnz( state.y = CPU_READ( state.s ) );
+  break;
+case Opcode::UND_2_02:
+case Opcode::UND_2_22:
+case Opcode::UND_2_42:
+case Opcode::UND_2_62:
+case Opcode::UND_2_82:
+case Opcode::UND_2_C2:
+case Opcode::UND_2_E2:
+  ++state.pc;
+  break;
+case Opcode::UND_3_44:
+  ++state.pc;
+  CPU_READ( state.ea );
+  break;
+case Opcode::UND_4_54:
+case Opcode::UND_4_d4:
+case Opcode::UND_4_f4:
+  ++state.pc;
+  CPU_READ( state.pc );
+  state.tl = state.eal + state.x;
+  CPU_READ( state.ea );
+  break;
+case Opcode::UND_4_dc:
+case Opcode::UND_4_fc:
+  ++state.pc;
+  state.eah = CPU_READ( state.pc++ );
+  CPU_READ( state.ea );
+  break;
+case Opcode::UND_8_5c:
+  //https://laughtonelectronics.com/Arcana/KimKlone/Kimklone_opcode_mapping.html
+  //state.op - code 5C consumes 3 bytes and 8 cycles but conforms to no known address mode; it remains interesting but useless.
+  //I tested the instruction "5C 1234h" ( stored little - endian as 5Ch 34h 12h ) as an example, and observed the following : 3 cycles fetching the instruction, 1 cycle reading FF34, then 4 cycles reading FFFF.
+  ++state.pc;
+  CPU_READ( state.pc++ );
+  state.eah = 0xff;
+  CPU_READ( state.ea );
+  CPU_READ( 0xffff );
+  CPU_READ( 0xffff );
+  CPU_READ( 0xffff );
+  CPU_READ( 0xffff );
+  break;
+default:  //for UND_1_xx
+  break;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "CPU.hpp"
+#include "Opcodes.hpp"
+
+//Bus requires:
+//CpuBreakType fetchOpcode( uint16_t address ) - fetches opcode, responds it with respondFetchOpcode and returns the break
+//uint8_t fetchOperand( uint16_t address )
+//uint8_t read( uint16_t address )
+//void write( uint16_t address, uint8_t value )
+//Every access must leave the machine in the state the run loop would have before advancing the coroutine.
+template<typename Bus>
+CpuBreakType CPU::interpret( Bus & bus )
+{
+  auto& state = mState;
+
+  //either fresh CPU or continuing right after an opcode fetch, as the coroutine would
+  bool opcodeFetched = std::exchange( mStarted, true ) || std::exchange( mResumeAfterFetch, false );
+
+  //trace calls are only made when tracing is on and one cycle NOPs are all $x3 and $xb, saving calls on every instruction
+  if ( !opcodeFetched )
+  {
+    mPreviousState = state;
+    if ( mGlobalTrace )
+      trace1();
+  }
+
+  for ( ;; )
+  {
+    if ( opcodeFetched )
+    {
+      state.interrupt = mRes.interrupt;
+      state.op = (Opcode)mRes.value;
+      mPreviousState = state;
+      if ( mGlobalTrace )
+        trace1();
+      state.pc += 1;
+
+      if ( ( (uint8_t)state.op & 0x07 ) == 0x03 && isHiccup() )
+      {
+        mReq.type = Request::Type::FETCH_OPCODE;
+        mReq.address = state.pc;
+        if ( auto cpuBreakType = bus.fetchOpcode( state.pc ); cpuBreakType != CpuBreakType::NONE )
+          return cpuBreakType;
+        continue;
+      }
+    }
+
+    state.ea = 0;
+    state.t = 0;
+
+    if ( state.interrupt && ( !state.i || ( state.interrupt & ~CPUState::I_IRQ ) != 0 ) )
+    {
+      state.op = Opcode::BRK_BRK;
+    }
+
+    state.eal = bus.fetchOperand( state.pc );
+
+#define CPU_FETCH_OPERAND( address ) bus.fetchOperand( address )
+#define CPU_READ( address ) bus.read( address )
+#define CPU_WRITE( address, value ) bus.write( address, value )
+#include "CPUInstructions.inl"
+#undef CPU_FETCH_OPERAND
+#undef CPU_READ
+#undef CPU_WRITE
+
+    if ( mGlobalTrace )
+      trace2();
+
+    opcodeFetched = true;
+    mReq.type = Request::Type::FETCH_OPCODE;
+    mReq.address = state.pc;
+    if ( auto cpuBreakType = bus.fetchOpcode( state.pc ); cpuBreakType != CpuBreakType::NONE )
+      return cpuBreakType;
+  }
+}
@@ -76,7 +76,13 @@ struct CPUState
   static CPUState reset()
   {
     std::random_device r{};
-    std::default_random_engine e{r()};
+    return reset( r() );
+  }
+
+  //registers that are random on power on are taken from given seed
+  static CPUState reset( uint32_t seed )
+  {
+    std::default_random_engine e{ seed };
     std::uniform_int_distribution randomByte{ 0, 255 };
 
     CPUState result;
@@ -2,17 +2,14 @@
 #include "GameDrive.hpp"
 #include "EEPROM.hpp"
 #include "TraceHelper.hpp"
+#include "StateStream.hpp"
 
 Cartridge::Cartridge( ImageProperties const& imageProperties, std::shared_ptr<ImageCart const> cart, std::shared_ptr<TraceHelper> traceHelper ) :
   mTraceHelper{ std::move( traceHelper ) }, mCart{ std::move( cart ) }, mCustomCart{ GameDrive::create( imageProperties ) },
   mEEPROM{ EEPROM::create( imageProperties, mTraceHelper ) }, mShiftRegister{}, mCounter{}, mAudIn{}, mCurrentStrobe{}, mAddressData{},
   mBank0{}, mBank1{}
 {
-  if ( mCart )
-  {
-    mBank0 = mCart->getBank0();
-    mBank1 = mCart->getBank1();
-  }
+  selectBanks();
 }
 
 Cartridge::~Cartridge()
@@ -44,7 +41,11 @@ void Cartridge::setAudIn( bool value )
     return;
 
   mAudIn = value;
+  selectBanks();
+}
 
+void Cartridge::selectBanks()
+{
   if ( !mCart )
     return;
 
@@ -149,6 +150,25 @@ bool Cartridge::isCart1Inactive() const
   return true;
 }
 
+bool Cartridge::serializable() const
+{
+  return !mCustomCart;
+}
+
+void Cartridge::serialize( StateStream & stream )
+{
+  assert( serializable() );
+  stream( mShiftRegister, mCounter, mAudIn, mCurrentStrobe, mAddressData );
+  if ( mEEPROM )
+  {
+    mEEPROM->serialize( stream );
+  }
+  if ( stream.loading() )
+  {
+    selectBanks();
+  }
+}
+
 
 uint8_t Cartridge::peek( CartBank const & bank )
 {
@@ -6,6 +6,7 @@ class CustomCart;
 class EEPROM;
 class TraceHelper;
 class ImageProperties;
+class StateStream;
 
 class Cartridge
 {
@@ -30,8 +31,13 @@ public:
   bool isCart0Inactive() const;
   bool isCart1Inactive() const;
 
+  //custom carts keep their state in a coroutine, so they can't be serialized at all
+  bool serializable() const;
+  void serialize( StateStream & stream );
+
 private:
   uint8_t peek( CartBank const& bank );
+  void selectBanks();
 
   void incrementCounter( uint64_t tick );
 
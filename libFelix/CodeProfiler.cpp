@@ -0,0 +1,124 @@
+#include "CodeProfiler.hpp"
+#include "TraceHelper.hpp"
+#include "SymbolSource.hpp"
+
+CodeProfiler::CodeProfiler( uint64_t const& tick ) : mTickSource{ tick }, mPCs( 65536 ), mNodes{}, mChildren{}, mNode{}, mPendingNode{}, mTick{}, mPC{}, mRunning{}
+{
+  clear();
+}
+
+void CodeProfiler::pause()
+{
+  mRunning = false;
+}
+
+void CodeProfiler::clear()
+{
+  std::ranges::fill( mPCs, Entry{} );
+  mNodes.assign( 1, Node{} );
+  mChildren.clear();
+  mNode = 0;
+  mPendingNode = 0;
+  mRunning = false;
+}
+
+std::span<CodeProfiler::Entry const, 65536> CodeProfiler::pcs() const
+{
+  return std::span<Entry const, 65536>{ mPCs.data(), 65536 };
+}
+
+void CodeProfiler::call( uint16_t address )
+{
+  //runaway stacks of code that never returns stay at the deepest level
+  if ( mNodes[mNode].depth >= MAX_DEPTH )
+    return;
+
+  uint64_t key = (uint64_t)mNode << 16 | address;
+  auto [it, inserted] = mChildren.try_emplace( key, (uint32_t)mNodes.size() );
+  if ( inserted )
+    mNodes.push_back( Node{ mNode, address, (uint16_t)( mNodes[mNode].depth + 1 ), 0 } );
+  mNode = it->second;
+}
+
+std::vector<std::string> CodeProfiler::labels( TraceHelper const& traceHelper, SymbolSource const* symbols )
+{
+  std::vector<std::string> result( 65536 );
+  for ( size_t i = 0; i < result.size(); ++i )
+  {
+    result[i] = traceHelper.addressLabel( (uint16_t)i );
+  }
+
+  if ( symbols )
+  {
+    for ( auto const& symbol : symbols->symbols() )
+    {
+      result[symbol.value] = symbol.name;
+    }
+  }
+
+  return result;
+}
+
+void CodeProfiler::writeReport( std::ostream & out, TraceHelper const& traceHelper, SymbolSource const* symbols ) const
+{
+  auto names = labels( traceHelper, symbols );
+
+  uint64_t total = 0;
+  std::vector<uint16_t> executed;
+  std::vector<Entry> pages( 256 );
+  for ( size_t pc = 0; pc < mPCs.size(); ++pc )
+  {
+    if ( mPCs[pc].count == 0 )
+      continue;
+
+    total += mPCs[pc].ticks;
+    executed.push_back( (uint16_t)pc );
+    pages[pc >> 8].count += mPCs[pc].count;
+    pages[pc >> 8].ticks += mPCs[pc].ticks;
+  }
+
+  std::ranges::stable_sort( executed, std::ranges::greater{}, [this]( uint16_t pc ) { return mPCs[pc].ticks; } );
+
+  auto percent = [&]( uint64_t ticks )
+  {
+    return total ? 100.0 * ticks / total : 0.0;
+  };
+
+  out << fmt::format( "{:>6} {:<20} {:>12} {:>14} {:>7}\n", "pc", "label", "count", "ticks", "%" );
+  for ( uint16_t pc : executed )
+  {
+    out << fmt::format( "{:04x}   {:<20} {:>12} {:>14} {:>6.2f}%\n", pc, names[pc], mPCs[pc].count, mPCs[pc].ticks, percent( mPCs[pc].ticks ) );
+  }
+
+  out << fmt::format( "\n{:>6} {:>12} {:>14} {:>7}\n", "page", "count", "ticks", "%" );
+  for ( size_t page = 0; page < pages.size(); ++page )
+  {
+    if ( pages[page].count )
+      out << fmt::format( "{:02x}xx   {:>12} {:>14} {:>6.2f}%\n", page, pages[page].count, pages[page].ticks, percent( pages[page].ticks ) );
+  }
+}
+
+void CodeProfiler::writeFolded( std::ostream & out, TraceHelper const& traceHelper, SymbolSource const* symbols ) const
+{
+  auto names = labels( traceHelper, symbols );
+
+  std::vector<std::string_view> path;
+  for ( size_t i = 0; i < mNodes.size(); ++i )
+  {
+    if ( mNodes[i].ticks == 0 )
+      continue;
+
+    path.clear();
+    for ( uint32_t node = (uint32_t)i; node != 0; node = mNodes[node].parent )
+    {
+      path.push_back( names[mNodes[node].address] );
+    }
+
+    out << "main";
+    for ( auto it = path.rbegin(); it != path.rend(); ++it )
+    {
+      out << ';' << *it;
+    }
+    out << ' ' << mNodes[i].ticks << '\n';
+  }
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "CPUState.hpp"
+
+class TraceHelper;
+class SymbolSource;
+
+//Executed instruction counts and ticks per PC, per 256 byte page of code and per call stack.
+//Ticks of an instruction are the time from its opcode fetch to the next one, including DMA and interrupt latency.
+//Call stacks are followed on JSR, BRK and interrupts down and on RTS and RTI up.
+class CodeProfiler
+{
+public:
+  struct Entry
+  {
+    uint64_t count;
+    uint64_t ticks;
+  };
+
+  //tick is read at the beginning of every instruction
+  explicit CodeProfiler( uint64_t const& tick );
+
+  void begin( uint16_t pc )
+  {
+    uint64_t now = mTickSource;
+    if ( mRunning )
+    {
+      uint64_t ticks = now - mTick;
+      mPCs[mPC].count += 1;
+      mPCs[mPC].ticks += ticks;
+      mNodes[mPendingNode].ticks += ticks;
+    }
+    mRunning = true;
+    mPC = pc;
+    mTick = now;
+    mPendingNode = mNode;
+  }
+
+  void end( CPUState const& state )
+  {
+    switch ( state.op )
+    {
+    case Opcode::JSA_JSR:
+    case Opcode::BRK_BRK:
+      call( state.pc );
+      break;
+    case Opcode::RTS_RTS:
+    case Opcode::RTI_RTI:
+      mNode = mNodes[mNode].parent;
+      break;
+    default:
+      break;
+    }
+  }
+
+  //next instruction starts a new measurement, e.g. after profiling was paused
+  void pause();
+  void clear();
+
+  std::span<Entry const, 65536> pcs() const;
+  //PC histogram sorted by ticks and per page totals, labels from symbols take precedence
+  void writeReport( std::ostream & out, TraceHelper const& traceHelper, SymbolSource const* symbols = nullptr ) const;
+  //one line per call stack with ticks spent directly in it, the format of flamegraph.pl and speedscope
+  void writeFolded( std::ostream & out, TraceHelper const& traceHelper, SymbolSource const* symbols = nullptr ) const;
+
+private:
+  static constexpr size_t MAX_DEPTH = 64;
+
+  struct Node
+  {
+    uint32_t parent;
+    uint16_t address;
+    uint16_t depth;
+    uint64_t ticks;
+  };
+
+  void call( uint16_t address );
+  static std::vector<std::string> labels( TraceHelper const& traceHelper, SymbolSource const* symbols );
+
+private:
+  uint64_t const& mTickSource;
+  std::vector<Entry> mPCs;
+  //call tree with the root at index 0, children are found by parent index and entry address
+  std::vector<Node> mNodes;
+  std::unordered_map<uint64_t, uint32_t> mChildren;
+  uint32_t mNode;
+  uint32_t mPendingNode;
+  uint64_t mTick;
+  uint16_t mPC;
+  bool mRunning;
+};
@@ -1,24 +1,32 @@
 #include "ComLynx.hpp"
 #include "Utility.hpp"
 #include "ComLynxWire.hpp"
+#include "ComLynxLink.hpp"
 #include "Log.hpp"
+#include "StateStream.hpp"
 
-ComLynx::ComLynx( std::shared_ptr<ComLynxWire> comLynxWire ) : mId{ comLynxWire->connect() }, mTx{ mId, comLynxWire }, mRx{ mId, comLynxWire }
+ComLynx::ComLynx( std::shared_ptr<ComLynxWire> comLynxWire ) : mWire{ comLynxWire }, mId{ comLynxWire->connect() }, mTx{ mId, comLynxWire }, mRx{ mId, comLynxWire }
 {
 }
 
 ComLynx::~ComLynx()
 {
+  mWire->disconnect();
 }
 
-bool ComLynx::pulse()
+bool ComLynx::pulse( uint64_t tick )
 {
-  mTx.process();
-  mRx.process();
+  mTx.process( tick );
+  mRx.process( tick );
 
   return mRx.interrupt() || mTx.interrupt();
 }
 
+bool ComLynx::idle() const
+{
+  return mTx.idle() && mRx.idle() && !mWire->shared() && !interrupt();
+}
+
 void ComLynx::setCtrl( uint8_t value )
 {
   mTx.setCtrl( value );
@@ -32,18 +40,6 @@ void ComLynx::setData( uint8_t data )
 
 uint8_t ComLynx::getCtrl() const
 {
-  uint8_t status = mTx.getStatus() | mRx.getStatus();
-
-  L_DEBUG << "TxRx" << mId << ": "
-    << ( ( status & SERCTL::TXRDY ) ? "TXRDY " : " " )
-    << ( ( status & SERCTL::RXRDY ) ? "RXRDY " : " " )
-    << ( ( status & SERCTL::TXEMPTY ) ? "TXEMPTY " : " " )
-    << ( ( status & SERCTL::PARERR ) ? "PARERR " : " " )
-    << ( ( status & SERCTL::OVERRUN ) ? "OVERRUN " : " " )
-    << ( ( status & SERCTL::FRAMERR ) ? "FRAMERR " : " " )
-    << ( ( status & SERCTL::RXBRK ) ? "RXBRK " : " " )
-    << ( ( status & SERCTL::PARBIT ) ? "PARBIT " : " " );
-
   return mTx.getStatus() | mRx.getStatus();
 }
 
@@ -54,20 +50,13 @@ uint8_t ComLynx::getData()
 
 bool ComLynx::interrupt() const
 {
-  bool rx = mRx.interrupt();
-  bool tx = mTx.interrupt();
-  bool res = rx || tx;
+  return mRx.interrupt() || mTx.interrupt();
+}
 
-  if ( res )
-  {
-    L_DEBUG << "TxRx" << mId << ": Int "
-      << ( rx ? "Rx " : " " ) << ( tx ? "Tx " : " " );
-    return true;
-  }
-  else
-  {
-    return false;
-  }
+void ComLynx::setLink( std::shared_ptr<ComLynxLink> link )
+{
+  mTx.setLink( link );
+  mRx.setLink( std::move( link ) );
 }
 
 bool ComLynx::present() const
@@ -75,7 +64,13 @@ bool ComLynx::present() const
   return true;
 }
 
-ComLynx::Transmitter::Transmitter( int id, std::shared_ptr<ComLynxWire> comLynxWire ) : mWire{ std::move( comLynxWire ) }, mData{}, mState{ 1 }, mCounter{}, mParity{}, mShifter{}, mParEn{}, mIntEn{}, mTxBrk{}, mParBit{}, mId{ id }
+void ComLynx::serialize( StateStream & stream )
+{
+  mTx.serialize( stream );
+  mRx.serialize( stream );
+}
+
+ComLynx::Transmitter::Transmitter( int id, std::shared_ptr<ComLynxWire> comLynxWire ) : mWire{ std::move( comLynxWire ) }, mLink{}, mLastPulse{}, mBitPeriod{}, mData{}, mState{ 1 }, mCounter{}, mParity{}, mShifter{}, mParEn{}, mIntEn{}, mTxBrk{}, mParBit{}, mId{ id }
 {
 }
 
@@ -107,8 +102,16 @@ bool ComLynx::Transmitter::interrupt() const
   return !mData.has_value() && mIntEn != 0;
 }
 
-void ComLynx::Transmitter::process()
+bool ComLynx::Transmitter::idle() const
 {
+  return mCounter == 0 && !mData.has_value() && !mTxBrk && mState == 1;
+}
+
+void ComLynx::Transmitter::process( uint64_t tick )
+{
+  mBitPeriod = mLastPulse ? tick - mLastPulse : 0;
+  mLastPulse = tick;
+
   switch ( mCounter )
   {
   case 1:
@@ -122,6 +125,8 @@ void ComLynx::Transmitter::process()
     if ( mTxBrk )
     {
       L_TRACE << "Tx" << mId << ": Brk";
+      if ( mState != 0 )
+        send( tick, ComLynxLink::BREAK );
       pull( 0 );
     }
     else if ( mData )
@@ -131,6 +136,7 @@ void ComLynx::Transmitter::process()
       mData.reset();
       mCounter = 10;
       mParity = 0;
+      send( tick, mShifter | ( mParEn ? std::popcount( mShifter ) & 1 : mParBit ) << 8 );
       L_INFO << "Tx" << mId << ": Start Data=" << std::hex << std::setw( 2 ) << std::setfill( '0' ) << mShifter;
     }
     break;
@@ -140,6 +146,22 @@ void ComLynx::Transmitter::process()
   }
 }
 
+void ComLynx::Transmitter::send( uint64_t tick, uint16_t frame )
+{
+  if ( mLink )
+  {
+    //arrives with the stop bit
+    mLink->send( tick + 10 * mBitPeriod, frame );
+  }
+}
+
+void ComLynx::Transmitter::setLink( std::shared_ptr<ComLynxLink> link )
+{
+  mLink = std::move( link );
+  //pulses might have been skipped
+  mLastPulse = 0;
+}
+
 void ComLynx::Transmitter::pull( int bit )
 {
   if ( mState != bit )
@@ -156,7 +178,18 @@ void ComLynx::Transmitter::pull( int bit )
   }
 }
 
-ComLynx::Receiver::Receiver( int id, std::shared_ptr<ComLynxWire> comLynxWire ) : mWire{ std::move( comLynxWire ) }, mData{}, mCounter{}, mParity{}, mParErr{}, mFrameErr{}, mRxBrk{}, mOverrun{}, mIntEn{}, mId{ id }
+void ComLynx::Transmitter::serialize( StateStream & stream )
+{
+  //the wire is shared with other instances, so the line level is restored through pull
+  int state = mState;
+  stream( mData, state, mCounter, mParity, mShifter, mParEn, mIntEn, mTxBrk, mParBit );
+  if ( stream.loading() )
+  {
+    pull( state );
+  }
+}
+
+ComLynx::Receiver::Receiver( int id, std::shared_ptr<ComLynxWire> comLynxWire ) : mWire{ std::move( comLynxWire ) }, mLink{}, mData{}, mCounter{}, mParity{}, mParErr{}, mFrameErr{}, mRxBrk{}, mOverrun{}, mIntEn{}, mId{ id }
 {
 }
 
@@ -207,8 +240,20 @@ bool ComLynx::Receiver::interrupt() const
   return mData.has_value() && mIntEn != 0;
 }
 
-void ComLynx::Receiver::process()
+bool ComLynx::Receiver::idle() const
+{
+  //frames from a link arrive at any pulse
+  return !mLink && mCounter == 0 && mWire->wire() == 0;
+}
+
+void ComLynx::Receiver::process( uint64_t tick )
 {
+  if ( mLink )
+  {
+    receive( tick );
+    return;
+  }
+
   if ( mCounter == 0 )
   {
     if ( mWire->wire() == -1 )
@@ -252,3 +297,33 @@ void ComLynx::Receiver::process()
     }
   }
 }
+
+void ComLynx::Receiver::receive( uint64_t tick )
+{
+  while ( auto frame = mLink->receive( tick ) )
+  {
+    if ( *frame & ComLynxLink::BREAK )
+    {
+      mRxBrk = SERCTL::RXBRK;
+      L_TRACE << "Rx" << mId << ": RxBrk";
+    }
+    else
+    {
+      bool overrun = mData.has_value();
+      mOverrun |= overrun ? SERCTL::OVERRUN : 0;
+      mData = *frame & 0xff;
+      mParity = ( *frame >> 8 ) & 1;
+      L_TRACE << "Rx" << mId << ": Data=" << std::hex << std::setw( 2 ) << std::setfill( '0' ) << *mData << ( overrun ? " overrun" : "" );
+    }
+  }
+}
+
+void ComLynx::Receiver::setLink( std::shared_ptr<ComLynxLink> link )
+{
+  mLink = std::move( link );
+}
+
+void ComLynx::Receiver::serialize( StateStream & stream )
+{
+  stream( mData, mCounter, mParity, mParErr, mFrameErr, mRxBrk, mOverrun, mIntEn );
+}
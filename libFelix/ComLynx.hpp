@@ -1,10 +1,12 @@
 #pragma once
 
 
-//It's a relic of two instance of emulation in one process that was communicating using coarse algorithm through ComLynxWire.
-//It needs to be rewritten to multiple processes
+//ComLynxWire is a relic of two instance of emulation in one process that was communicating using coarse algorithm.
+//Instances in other threads or processes are connected through ComLynxLink that carries whole bytes in lockstep.
 
 class ComLynxWire;
+class ComLynxLink;
+class StateStream;
 
 class ComLynx
 {
@@ -14,7 +16,11 @@ public:
   ~ComLynx();
 
   bool present() const;
-  bool pulse();
+  bool pulse( uint64_t tick );
+  //nothing in progress, nothing to send or receive and no interrupt, so pulses change nothing until the port is touched
+  bool idle() const;
+  //bytes go through the link instead of the wire, nullptr switches back to the wire
+  void setLink( std::shared_ptr<ComLynxLink> link );
   void setCtrl( uint8_t ctrl );
   void setData( uint8_t data );
   uint8_t getCtrl() const;
@@ -22,6 +28,8 @@ public:
 
   bool interrupt() const;
 
+  void serialize( StateStream & stream );
+
 private:
 
   struct SERCTL
@@ -46,6 +54,7 @@ private:
     static constexpr uint8_t PARBIT = 0x01; //9th bit
   };
 
+  std::shared_ptr<ComLynxWire> mWire;
   int mId;
 
   class Transmitter
@@ -57,13 +66,21 @@ private:
     void setData( int data );
     uint8_t getStatus() const;
     bool interrupt() const;
-    void process();
+    bool idle() const;
+    void process( uint64_t tick );
+    void serialize( StateStream & stream );
+    void setLink( std::shared_ptr<ComLynxLink> link );
 
   private:
 
     void pull( int bit );
+    void send( uint64_t tick, uint16_t frame );
 
     std::shared_ptr<ComLynxWire> mWire;
+    std::shared_ptr<ComLynxLink> mLink;
+    //link sends a byte when it starts, so it has to know the bit period to tell when it arrives
+    uint64_t mLastPulse;
+    uint64_t mBitPeriod;
     std::optional<int> mData;
     int mState;
     int mCounter;
@@ -85,10 +102,16 @@ private:
     int getData();
     uint8_t getStatus() const;
     bool interrupt() const;
-    void process();
+    bool idle() const;
+    void process( uint64_t tick );
+    void serialize( StateStream & stream );
+    void setLink( std::shared_ptr<ComLynxLink> link );
 
   private:
+    void receive( uint64_t tick );
+
     std::shared_ptr<ComLynxWire> mWire;
+    std::shared_ptr<ComLynxLink> mLink;
     std::optional<int> mData;
     int mCounter;
     int mParity;
@@ -0,0 +1,195 @@
+#include "ComLynxLink.hpp"
+
+ComLynxLink::ComLynxLink() : mMutex{}, mCondition{}, mInbox{}, mProposals{}, mPeers{}, mOutbox{}, mQuantumEnd{}, mLatency{}, mNode{}
+{
+}
+
+uint64_t ComLynxLink::latency() const
+{
+  return mLatency;
+}
+
+void ComLynxLink::setup( int node, int nodes, uint64_t latency )
+{
+  std::scoped_lock lock{ mMutex };
+  mNode = node;
+  mLatency = latency;
+  mProposals.resize( nodes );
+  mPeers.assign( nodes, true );
+  mPeers[node] = false;
+  mCondition.notify_all();
+}
+
+void ComLynxLink::send( uint64_t arrival, uint16_t frame )
+{
+  //peers may have run up to the end of the quantum already
+  arrival = std::max( arrival, mQuantumEnd + 1 );
+  {
+    std::scoped_lock lock{ mMutex };
+    mInbox.emplace( arrival, mNode, frame );
+  }
+  mOutbox.push_back( { Message::FRAME, (uint8_t)mNode, frame, 0, arrival } );
+}
+
+std::optional<uint16_t> ComLynxLink::receive( uint64_t tick )
+{
+  std::scoped_lock lock{ mMutex };
+  if ( mInbox.empty() || std::get<0>( mInbox.top() ) > tick )
+    return std::nullopt;
+
+  uint16_t frame = std::get<2>( mInbox.top() );
+  mInbox.pop();
+  return frame;
+}
+
+uint64_t ComLynxLink::sync( uint64_t tick, uint64_t quantum )
+{
+  std::unique_lock lock{ mMutex };
+  mCondition.wait( lock, [this] { return !mPeers.empty(); } );
+  lock.unlock();
+
+  quantum = std::clamp<uint64_t>( quantum, mLatency, std::numeric_limits<uint32_t>::max() );
+  mOutbox.push_back( { Message::SYNC, (uint8_t)mNode, 0, (uint32_t)quantum, tick } );
+  flush();
+
+  suspend();
+  lock.lock();
+  mCondition.wait( lock, [this] { return gathered(); } );
+  //a peer that is gone took part until its last proposal
+  bool alone = true;
+  for ( size_t i = 0; i < mProposals.size(); ++i )
+  {
+    if ( !mProposals[i].empty() )
+    {
+      quantum = std::min( quantum, mProposals[i].front() );
+      mProposals[i].pop();
+      alone = false;
+    }
+  }
+  lock.unlock();
+  resume();
+
+  mQuantumEnd = alone ? std::numeric_limits<uint64_t>::max() : tick + quantum;
+  return mQuantumEnd;
+}
+
+void ComLynxLink::flush()
+{
+  if ( !mOutbox.empty() )
+  {
+    post( mOutbox );
+    mOutbox.clear();
+  }
+}
+
+void ComLynxLink::suspend()
+{
+}
+
+void ComLynxLink::resume()
+{
+}
+
+void ComLynxLink::deliver( std::span<Message const> messages )
+{
+  std::scoped_lock lock{ mMutex };
+  for ( auto const& message : messages )
+  {
+    switch ( message.type )
+    {
+    case Message::FRAME:
+      mInbox.emplace( message.tick, (int)message.node, message.data );
+      break;
+    case Message::SYNC:
+      mProposals[message.node].push( message.quantum );
+      mCondition.notify_all();
+      break;
+    case Message::BYE:
+      mPeers[message.node] = false;
+      mCondition.notify_all();
+      break;
+    default:
+      break;
+    }
+  }
+}
+
+bool ComLynxLink::gathered() const
+{
+  for ( size_t i = 0; i < mPeers.size(); ++i )
+  {
+    if ( mPeers[i] && mProposals[i].empty() )
+      return false;
+  }
+  return true;
+}
+
+struct ComLynxLoopback::Hub
+{
+  std::mutex mutex;
+  std::vector<ComLynxLoopback*> nodes;
+  bool serial;
+  //held by the node that is emulating in serial mode
+  std::mutex baton;
+};
+
+std::vector<std::shared_ptr<ComLynxLink>> ComLynxLoopback::create( int nodes, uint64_t latency, bool serial )
+{
+  auto hub = std::make_shared<Hub>();
+  hub->nodes.resize( nodes );
+  hub->serial = serial;
+
+  std::vector<std::shared_ptr<ComLynxLink>> result;
+  for ( int i = 0; i < nodes; ++i )
+  {
+    auto node = std::shared_ptr<ComLynxLoopback>{ new ComLynxLoopback{ hub, i } };
+    node->setup( i, nodes, latency );
+    hub->nodes[i] = node.get();
+    result.push_back( std::move( node ) );
+  }
+  return result;
+}
+
+ComLynxLoopback::ComLynxLoopback( std::shared_ptr<Hub> hub, int node ) : mHub{ std::move( hub ) }, mNode{ node }, mRunning{}
+{
+}
+
+ComLynxLoopback::~ComLynxLoopback()
+{
+  flush();
+  {
+    std::scoped_lock lock{ mHub->mutex };
+    mHub->nodes[mNode] = nullptr;
+  }
+  Message bye{ Message::BYE, (uint8_t)mNode, 0, 0, 0 };
+  post( { &bye, 1 } );
+  suspend();
+}
+
+void ComLynxLoopback::post( std::span<Message const> messages )
+{
+  std::scoped_lock lock{ mHub->mutex };
+  for ( auto* node : mHub->nodes )
+  {
+    if ( node && node != this )
+      node->deliver( messages );
+  }
+}
+
+void ComLynxLoopback::suspend()
+{
+  if ( mRunning )
+  {
+    mHub->baton.unlock();
+    mRunning = false;
+  }
+}
+
+void ComLynxLoopback::resume()
+{
+  if ( mHub->serial )
+  {
+    mHub->baton.lock();
+    mRunning = true;
+  }
+}
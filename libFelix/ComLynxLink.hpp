@@ -0,0 +1,103 @@
+#pragma once
+
+//Byte level ComLynx connection between emulator instances running on other threads or in other processes.
+//Nodes run in parallel in quanta and meet at quantum boundaries, where they exchange frames sent during the quantum and
+//agree on the length of the next one: the shortest quantum proposed, which is a whole frame at the baud rate of each node but
+//not less than the latency. Frames sent during a quantum arrive after its end, so the outcome doesn't depend on how the nodes
+//are scheduled. The sender receives its own frames too.
+//Ticks of all nodes start together, so linked instances must start from power on and can't load states.
+class ComLynxLink
+{
+public:
+  //bits 0-7 are data, bit 8 is parity and break is sent as separate frame
+  static constexpr uint16_t BREAK = 0x8000;
+  //ten bit periods at the highest baud rate of 62500
+  static constexpr uint64_t DEFAULT_LATENCY = 10 * 256;
+
+  virtual ~ComLynxLink() = default;
+
+  uint64_t latency() const;
+
+  //frame arriving at given tick, postponed past the end of current quantum if earlier
+  void send( uint64_t arrival, uint16_t frame );
+  //earliest frame that has arrived by given tick
+  std::optional<uint16_t> receive( uint64_t tick );
+  //Quantum boundary. Sends pending frames, proposes max( quantum, latency ) as the next quantum and waits for all peers to get here.
+  //Returns the end of the next quantum, max if there are no peers left.
+  uint64_t sync( uint64_t tick, uint64_t quantum );
+
+  //what nodes exchange
+  struct Message
+  {
+    enum Type : uint8_t
+    {
+      HELLO,
+      FRAME,
+      SYNC,
+      BYE
+    };
+
+    Type type;
+    uint8_t node;
+    uint16_t data;
+    //proposed quantum of SYNC
+    uint32_t quantum;
+    uint64_t tick;
+  };
+  static_assert( sizeof( Message ) == 16 );
+
+protected:
+  ComLynxLink();
+
+  //node id of this instance, number of nodes and latency. sync waits until they are known
+  void setup( int node, int nodes, uint64_t latency );
+  //posts frames sent since the last sync
+  void flush();
+  //sends messages to all other nodes
+  virtual void post( std::span<Message const> messages ) = 0;
+  //called around waiting for peers in sync
+  virtual void suspend();
+  virtual void resume();
+  //called by the transport with messages of other nodes
+  void deliver( std::span<Message const> messages );
+
+private:
+  bool gathered() const;
+
+private:
+  std::mutex mMutex;
+  std::condition_variable mCondition;
+  //frames ordered by arrival and sender, so that simultaneous arrivals are received in the same order on every node
+  std::priority_queue<std::tuple<uint64_t, int, uint16_t>, std::vector<std::tuple<uint64_t, int, uint16_t>>, std::greater<>> mInbox;
+  //quanta proposed by peers at boundaries this node hasn't reached yet, a peer can be at most one boundary ahead
+  std::vector<std::queue<uint64_t>> mProposals;
+  //this node and those gone don't take part, a BYE comes after the last SYNC of the node
+  std::vector<bool> mPeers;
+  //frames of this node not posted yet, only touched by the emulating thread
+  std::vector<Message> mOutbox;
+  uint64_t mQuantumEnd;
+  uint64_t mLatency;
+  int mNode;
+};
+
+//nodes linked to each other in one process
+class ComLynxLoopback : public ComLynxLink
+{
+public:
+  //serial nodes take turns instead of running in parallel, which must not change the outcome
+  static std::vector<std::shared_ptr<ComLynxLink>> create( int nodes, uint64_t latency = DEFAULT_LATENCY, bool serial = false );
+  ~ComLynxLoopback() override;
+
+private:
+  struct Hub;
+
+  ComLynxLoopback( std::shared_ptr<Hub> hub, int node );
+  void post( std::span<Message const> messages ) override;
+  void suspend() override;
+  void resume() override;
+
+private:
+  std::shared_ptr<Hub> mHub;
+  int mNode;
+  bool mRunning;
+};
@@ -0,0 +1,260 @@
+#include "ComLynxSocket.hpp"
+#ifndef _WIN32
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+ComLynxHub::ComLynxHub( std::filesystem::path path, int nodes, uint64_t latency ) : mPath{ std::move( path ) }, mNodes{ nodes }, mLatency{ latency }, mListener{ -1 }, mThread{}
+{
+  throw std::runtime_error{ "ComLynx sockets are not supported on this platform" };
+}
+
+ComLynxHub::~ComLynxHub()
+{
+}
+
+void ComLynxHub::relay()
+{
+}
+
+ComLynxSocket::ComLynxSocket( std::filesystem::path const& path ) : mSocket{ -1 }, mNodes{}, mReader{}
+{
+  throw std::runtime_error{ "ComLynx sockets are not supported on this platform" };
+}
+
+ComLynxSocket::~ComLynxSocket()
+{
+}
+
+void ComLynxSocket::post( std::span<Message const> messages )
+{
+}
+
+void ComLynxSocket::readMessages()
+{
+}
+
+#else
+
+namespace
+{
+
+#ifdef MSG_NOSIGNAL
+static constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+static constexpr int SEND_FLAGS = 0;
+#endif
+
+sockaddr_un address( std::filesystem::path const& path )
+{
+  sockaddr_un result{};
+  result.sun_family = AF_UNIX;
+  auto const& native = path.native();
+  if ( native.size() >= sizeof( result.sun_path ) )
+    throw std::runtime_error{ "ComLynx socket path too long: " + path.string() };
+  std::ranges::copy( native, result.sun_path );
+  return result;
+}
+
+bool writeAll( int fd, void const* data, size_t size )
+{
+  auto bytes = (char const*)data;
+  while ( size > 0 )
+  {
+    ssize_t written = ::send( fd, bytes, size, SEND_FLAGS );
+    if ( written < 0 && errno == EINTR )
+      continue;
+    if ( written <= 0 )
+      return false;
+    bytes += written;
+    size -= (size_t)written;
+  }
+  return true;
+}
+
+bool readAll( int fd, void* data, size_t size )
+{
+  auto bytes = (char*)data;
+  while ( size > 0 )
+  {
+    ssize_t count = ::recv( fd, bytes, size, 0 );
+    if ( count < 0 && errno == EINTR )
+      continue;
+    if ( count <= 0 )
+      return false;
+    bytes += count;
+    size -= (size_t)count;
+  }
+  return true;
+}
+
+}
+
+ComLynxHub::ComLynxHub( std::filesystem::path path, int nodes, uint64_t latency ) : mPath{ std::move( path ) }, mNodes{ nodes }, mLatency{ latency },
+  mListener{ ::socket( AF_UNIX, SOCK_STREAM, 0 ) }, mThread{}
+{
+  if ( mListener < 0 )
+    throw std::runtime_error{ "Can't create ComLynx socket" };
+
+  auto addr = address( mPath );
+  //left over from a previous run
+  ::unlink( mPath.c_str() );
+  if ( ::bind( mListener, (sockaddr const*)&addr, sizeof( addr ) ) != 0 || ::listen( mListener, nodes ) != 0 )
+  {
+    ::close( mListener );
+    throw std::runtime_error{ "Can't listen on ComLynx socket " + mPath.string() };
+  }
+
+  mThread = std::thread{ [this] { relay(); } };
+}
+
+ComLynxHub::~ComLynxHub()
+{
+  //stops waiting for nodes that never connected
+  ::shutdown( mListener, SHUT_RDWR );
+  mThread.join();
+  ::close( mListener );
+  ::unlink( mPath.c_str() );
+}
+
+void ComLynxHub::relay()
+{
+  std::vector<pollfd> clients;
+  while ( clients.size() < (size_t)mNodes )
+  {
+    int fd = ::accept( mListener, nullptr, nullptr );
+    if ( fd < 0 && errno == EINTR )
+      continue;
+    if ( fd < 0 )
+      break;
+    clients.push_back( { fd, POLLIN, 0 } );
+  }
+
+  if ( clients.size() == (size_t)mNodes )
+  {
+    for ( size_t i = 0; i < clients.size(); ++i )
+    {
+      Message hello{ Message::HELLO, (uint8_t)i, (uint16_t)mNodes, 0, mLatency };
+      writeAll( clients[i].fd, &hello, sizeof( hello ) );
+    }
+  }
+  else
+  {
+    for ( auto& client : clients )
+    {
+      ::close( client.fd );
+    }
+    clients.clear();
+  }
+
+  auto broadcast = [&]( Message const& message )
+  {
+    for ( size_t i = 0; i < clients.size(); ++i )
+    {
+      if ( i != message.node && clients[i].fd >= 0 )
+        writeAll( clients[i].fd, &message, sizeof( message ) );
+    }
+  };
+
+  size_t open = clients.size();
+  while ( open > 0 )
+  {
+    if ( ::poll( clients.data(), clients.size(), -1 ) < 0 )
+    {
+      if ( errno == EINTR )
+        continue;
+      break;
+    }
+
+    for ( size_t i = 0; i < clients.size(); ++i )
+    {
+      if ( clients[i].fd < 0 || clients[i].revents == 0 )
+        continue;
+
+      Message message;
+      if ( readAll( clients[i].fd, &message, sizeof( message ) ) )
+      {
+        message.node = (uint8_t)i;
+        broadcast( message );
+      }
+      else
+      {
+        ::close( clients[i].fd );
+        clients[i].fd = -1;
+        open -= 1;
+        broadcast( { Message::BYE, (uint8_t)i, 0, 0, 0 } );
+      }
+    }
+  }
+
+  for ( auto& client : clients )
+  {
+    if ( client.fd >= 0 )
+      ::close( client.fd );
+  }
+}
+
+ComLynxSocket::ComLynxSocket( std::filesystem::path const& path ) : mSocket{ ::socket( AF_UNIX, SOCK_STREAM, 0 ) }, mNodes{}, mReader{}
+{
+  if ( mSocket < 0 )
+    throw std::runtime_error{ "Can't create ComLynx socket" };
+
+  //the hub might be still starting up
+  auto addr = address( path );
+  for ( int retry = 0; ::connect( mSocket, (sockaddr const*)&addr, sizeof( addr ) ) != 0; ++retry )
+  {
+    if ( retry == 100 )
+    {
+      ::close( mSocket );
+      throw std::runtime_error{ "Can't connect to ComLynx hub " + path.string() };
+    }
+    std::this_thread::sleep_for( std::chrono::milliseconds{ 100 } );
+  }
+
+  Message hello;
+  if ( !readAll( mSocket, &hello, sizeof( hello ) ) || hello.type != Message::HELLO )
+  {
+    ::close( mSocket );
+    throw std::runtime_error{ "ComLynx hub " + path.string() + " didn't start" };
+  }
+
+  mNodes = hello.data;
+  setup( hello.node, hello.data, hello.tick );
+  mReader = std::thread{ [this] { readMessages(); } };
+}
+
+ComLynxSocket::~ComLynxSocket()
+{
+  flush();
+  //hub tells the others this node is gone
+  ::shutdown( mSocket, SHUT_RDWR );
+  mReader.join();
+  ::close( mSocket );
+}
+
+void ComLynxSocket::post( std::span<Message const> messages )
+{
+  writeAll( mSocket, messages.data(), messages.size_bytes() );
+}
+
+void ComLynxSocket::readMessages()
+{
+  Message message;
+  while ( readAll( mSocket, &message, sizeof( message ) ) )
+  {
+    deliver( { &message, 1 } );
+  }
+
+  //hub is gone, nothing will arrive any more
+  for ( int i = 0; i < mNodes; ++i )
+  {
+    Message bye{ Message::BYE, (uint8_t)i, 0, 0, 0 };
+    deliver( { &bye, 1 } );
+  }
+}
+
+#endif
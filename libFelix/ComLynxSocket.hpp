@@ -0,0 +1,43 @@
+#pragma once
+
+#include "ComLynxLink.hpp"
+
+//Relays messages between emulator processes connected to a Unix domain socket.
+//Runs on its own thread until all nodes that connected have disconnected.
+class ComLynxHub
+{
+public:
+  //nodes are started when all of them are connected
+  ComLynxHub( std::filesystem::path path, int nodes, uint64_t latency = ComLynxLink::DEFAULT_LATENCY );
+  ~ComLynxHub();
+
+private:
+  using Message = ComLynxLink::Message;
+
+  void relay();
+
+private:
+  std::filesystem::path mPath;
+  int mNodes;
+  uint64_t mLatency;
+  int mListener;
+  std::thread mThread;
+};
+
+//node connected to ComLynxHub, latency is set by the hub
+class ComLynxSocket : public ComLynxLink
+{
+public:
+  //waits until the hub has started all nodes
+  ComLynxSocket( std::filesystem::path const& path );
+  ~ComLynxSocket() override;
+
+private:
+  void post( std::span<Message const> messages ) override;
+  void readMessages();
+
+private:
+  int mSocket;
+  int mNodes;
+  std::thread mReader;
+};
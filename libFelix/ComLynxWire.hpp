@@ -3,7 +3,7 @@
 class ComLynxWire
 {
 public:
-  ComLynxWire() : mValue{ 0 }, mClients{ 0 }, mCoarseValue{}, mParBit{} {}
+  ComLynxWire() : mValue{ 0 }, mClients{ 0 }, mConnected{ 0 }, mCoarseValue{}, mParBit{} {}
 
   void pullUp()
   {
@@ -27,9 +27,21 @@ public:
 
   int connect()
   {
+    mConnected += 1;
     return mClients++;
   }
 
+  void disconnect()
+  {
+    mConnected -= 1;
+  }
+
+  //other instance can start talking any time
+  bool shared() const
+  {
+    return mConnected > 1;
+  }
+
   void setCoarse( int value, int parbit )
   {
     mCoarseValue = value;
@@ -46,6 +58,7 @@ private:
   //value is pulled up in idle (0) state.
   int mValue;
   int mClients;
+  int mConnected;
   int mCoarseValue;
   int mParBit;
 };
@@ -1,8 +1,9 @@
 #include "Core.hpp"
-#include "CPU.hpp"
+#include "CPUInterpreter.hpp"
 #include "Cartridge.hpp"
 #include "ComLynx.hpp"
 #include "ComLynxWire.hpp"
+#include "ComLynxLink.hpp"
 #include "Mikey.hpp"
 #include "InputFile.hpp"
 #include "ImageBS93.hpp"
@@ -11,26 +12,34 @@
 #include "Log.hpp"
 #include "BootROMTraps.hpp"
 #include "TraceHelper.hpp"
-#include "DebugRAM.hpp"
 #include "ScriptDebuggerEscapes.hpp"
 #include "VGMWriter.hpp"
-
-uint8_t* gDebugRAM;
+#include "StateStream.hpp"
+#include "RewindBuffer.hpp"
+#include "TraceRecorder.hpp"
+#include "CodeProfiler.hpp"
 
 static constexpr uint64_t RESET_DURATION = 5 * 10;  //asserting RESET for 10 cycles to make sure none will miss it
 
-static constexpr bool ENABLE_TRAPS = true;
+struct StateHeader
+{
+  std::array<char, 4> magic;
+  uint32_t version;
+  uint64_t size;
+};
+
+static constexpr std::array<char, 4> STATE_MAGIC = { 'F', 'L', 'X', 'S' };
+//bump on any change of serialized layout
+static constexpr uint32_t STATE_VERSION = 6;
 
 Core::Core( ImageProperties const& imageProperties, std::shared_ptr<ComLynxWire> comLynxWire, std::shared_ptr<IVideoSink> videoSink,
   std::shared_ptr<IInputSource> inputSource, InputFile inputFile, std::shared_ptr<ImageROM const> bootROM,
-  std::shared_ptr<ScriptDebuggerEscapes> scriptDebuggerEscapes ) :
-  mRAM{}, mROM{}, mPageTypes{}, mScriptDebugger{ std::make_shared<ScriptDebugger>() }, mCurrentTick{}, mSamplesRemainder{}, mActionQueue{}, mTraceHelper{ std::make_shared<TraceHelper>() }, mCpu{ std::make_shared<CPU>( mTraceHelper ) },
-  mCartridge{ std::make_shared<Cartridge>( imageProperties, std::shared_ptr<ImageCart>{}, mTraceHelper ) }, mComLynx{ std::make_shared<ComLynx>( comLynxWire ) }, mComLynxWire{ comLynxWire },
+  std::shared_ptr<ScriptDebuggerEscapes> scriptDebuggerEscapes, CPUBackend cpuBackend, SuzyBackend suzyBackend ) :
+  mRAM{}, mROM{}, mPageTypes{}, mScriptDebugger{ std::make_shared<ScriptDebugger>() }, mCurrentTick{}, mSampleTick{}, mSamplePhase{}, mBandLimitedAudio{}, mActionQueue{}, mTraceHelper{ std::make_shared<TraceHelper>() }, mCpu{ std::make_shared<CPU>( mTraceHelper ) }, mCPUBackend{ cpuBackend },
+  mCartridge{ std::make_shared<Cartridge>( imageProperties, std::shared_ptr<ImageCart>{}, mTraceHelper ) }, mComLynx{ std::make_shared<ComLynx>( comLynxWire ) }, mComLynxWire{ comLynxWire }, mComLynxLink{},
   mMikey{ std::make_shared<Mikey>( *this, *mComLynx, videoSink ) }, mSuzy{ std::make_shared<Suzy>( *this, inputSource ) }, mMapCtl{},
-  mDMAAddress{}, mFastCycleTick{ 4 }, mResetRequestDuringSpriteRendering{}, mSuzyRunning{}, mHaltSuzy{}
+  mDMAAddress{}, mFastCycleTick{ 4 }, mSuzyBackend{ suzyBackend }, mSuzyProcess{}, mSuzyProcessRequest{}, mResetRequestDuringSpriteRendering{}, mSuzyRunning{}, mHaltSuzy{}, mRunProfile{}, mCodeProfiler{}, mRewind{}, mFrameEnded{}, mCPUDeadline{}, mExecutedTick{}
 {
-  gDebugRAM = &mRAM[0];
-
   for ( size_t i = 0; i < mPageTypes.size(); ++i )
   {
     switch ( i )
@@ -106,6 +115,11 @@ void Core::setLog( std::filesystem::path const & path )
   mCpu->setLog( path );
 }
 
+void Core::recordTrace( std::filesystem::path const & path )
+{
+  mCpu->setTraceRecorder( path.empty() ? nullptr : std::make_shared<TraceRecorder>( path, mCurrentTick ) );
+}
+
 void Core::setVGMWriter( std::filesystem::path const& path )
 {
   auto writer = std::unique_ptr<VGMWriter>( path.empty() ? nullptr : new VGMWriter{ path } );
@@ -161,20 +175,31 @@ void Core::pulseReset( std::optional<uint16_t> resetAddress )
 
 Core::~Core()
 {
-  gDebugRAM = nullptr;
 }
 
 void Core::requestDisplayDMA( uint64_t tick, uint16_t address )
 {
   mDMAAddress = address;
-  mActionQueue.push( { Action::DISPLAY_DMA, tick } );
+  schedule( { Action::DISPLAY_DMA, tick } );
+}
+
+void Core::schedule( SequencedAction action )
+{
+  mActionQueue.push( action );
+  mCPUDeadline = std::min( mCPUDeadline, action.getTick() );
+}
+
+uint64_t Core::executedTick() const
+{
+  return mExecutedTick;
 }
 
 void Core::runSuzy()
 {
   mSuzyRunning = true;
+  mCPUDeadline = 0;
   if ( !mSuzyProcess )
-    mSuzyProcess = mSuzy->suzyProcess();
+    mSuzyProcess = mSuzy->suzyProcess( mSuzyBackend == SuzyBackend::BATCHED );
 }
 
 void Core::assertInterrupt( int mask, std::optional<uint64_t> tick )
@@ -183,12 +208,12 @@ void Core::assertInterrupt( int mask, std::optional<uint64_t> tick )
   {
     if ( ( mCpu->interruptedMask() & CPUState::I_IRQ ) == 0 )
     {
-      mActionQueue.push( { Action::ASSERT_IRQ, tick.value_or( mCurrentTick ) } );
+      schedule( { Action::ASSERT_IRQ, tick.value_or( mCurrentTick ) } );
     }
   }
   else if ( ( mask & CPUState::I_RESET ) != 0 )
   {
-    mActionQueue.push( { Action::ASSERT_RESET, tick.value_or( mCurrentTick ) } );
+    schedule( { Action::ASSERT_RESET, tick.value_or( mCurrentTick ) } );
   }
   else
   {
@@ -200,12 +225,12 @@ void Core::desertInterrupt( int mask, std::optional<uint64_t> tick )
 {
   if ( ( mask & CPUState::I_IRQ ) != 0 )
   {
-    mActionQueue.push( { Action::DESERT_IRQ, tick.value_or( mCurrentTick ) } );
+    schedule( { Action::DESERT_IRQ, tick.value_or( mCurrentTick ) } );
     return;
   }
   else if ( ( mask & CPUState::I_RESET ) != 0 )
   {
-    mActionQueue.push( { Action::DESERT_RESET, tick.value_or( mCurrentTick ) } );
+    schedule( { Action::DESERT_RESET, tick.value_or( mCurrentTick ) } );
     return;
   }
   else
@@ -239,7 +264,7 @@ void Core::executeSequencedAction( SequencedAction seqAction )
   case Action::FIRE_TIMERC:
     if ( auto newAction = mMikey->fireTimer( seqAction.getTick(), (int)action - (int)Action::FIRE_TIMER0 ) )
     {
-      mActionQueue.push( newAction );
+      schedule( newAction );
     }
     break;
   case Action::ASSERT_IRQ:
@@ -254,22 +279,19 @@ void Core::executeSequencedAction( SequencedAction seqAction )
   case Action::DESERT_RESET:
     mCpu->desertInterrupt( CPUState::I_RESET );
     break;
-  case Action::SAMPLE_AUDIO:
-    mOutputSamples[mSamplesEmitted++] = mMikey->sampleAudio( mCurrentTick );
-    if ( mSamplesEmitted >= mOutputSamples.size() )
-    {
-      mCpu->breakNext();
-      mHaltSuzy = true;
-    }
-    else
-    {
-      enqueueSampling();
-    }
-    break;
   case Action::BATCH_END:
     mCpu->breakNext();
     mHaltSuzy = true;
     break;
+  case Action::COMLYNX_SYNC:
+    if ( mComLynxLink )
+    {
+      //proposes one frame at the current baud rate as the next quantum
+      uint64_t quantumEnd = mComLynxLink->sync( seqAction.getTick(), 10 * mMikey->serialBitPeriod() );
+      if ( quantumEnd != std::numeric_limits<uint64_t>::max() )
+        schedule( { Action::COMLYNX_SYNC, quantumEnd } );
+    }
+    break;
   case Action::NONE:
     //removed element
     break;
@@ -281,7 +303,11 @@ void Core::executeSequencedAction( SequencedAction seqAction )
 
 bool Core::executeSuzyAction()
 {
-  if ( !mSuzyRunning || mHaltSuzy )
+  if ( !mSuzyRunning )
+    return false;
+
+  //at the end of a batch the sprite engine stops between SCBs, where the state can be saved
+  if ( mHaltSuzy && mSuzyProcess->betweenSCBs() )
     return false;
 
   assert( mSuzyProcess );
@@ -307,170 +333,140 @@ bool Core::executeSuzyAction()
       pulseReset();
     }
     break;
-  case ISuzyProcess::Request::READ:
-  case ISuzyProcess::Request::FETCHSCB:
-    mSuzyProcess->respond( mRAM[mSuzyProcessRequest->addr] );
-    mCurrentTick += 5ull; //read byte
-    break;
-  case ISuzyProcess::Request::READ4:
-  case ISuzyProcess::Request::READPAL:
-    if ( mSuzyProcessRequest->addr <= 0xfffc )
-      mSuzyProcess->respond( *( (uint32_t const *)( mRAM.data() + mSuzyProcessRequest->addr ) ) );
-    mCurrentTick += 5ull + 3 * mFastCycleTick;  //read 4 bytes
-    break;
-  case ISuzyProcess::Request::WRITE:
-  case ISuzyProcess::Request::WRITEFRED:
-    mRAM[mSuzyProcessRequest->addr] = (uint8_t)mSuzyProcessRequest->value;
-    mCurrentTick += 5ull; //write byte
+  case ISuzyProcess::Request::YIELD:
+    //batched process performs the access itself when resumed
     break;
-  case ISuzyProcess::Request::COLRMW:
-    {
-      if ( mSuzyProcessRequest->addr > 0xfffc )
-        break;
-
-      const uint32_t u16 = mSuzyProcessRequest->value;
-      const uint32_t u32 = u16 | ( u16 << 16 );
-      const uint32_t maskedU32 = u32 & mSuzyProcessRequest->mask;
-
-      const uint32_t value = *( (uint32_t const*)( mRAM.data() + mSuzyProcessRequest->addr ) );
-      const uint32_t maskedValue = value & ~mSuzyProcessRequest->mask;
-      const uint32_t outValue = value & mSuzyProcessRequest->mask;
-
-      *( (uint32_t *)( mRAM.data() + mSuzyProcessRequest->addr ) ) = maskedValue | maskedU32;
-
-      mSuzyProcess->respond( outValue );
-    }
-    mCurrentTick += 5ull + 7 * mFastCycleTick;  //read 4 bytes & write 4 bytes
+  case ISuzyProcess::Request::NEXTSCB:
+    //no access, the process only stops where the state can be saved
     break;
-  case ISuzyProcess::Request::VIDRMW:
-    {
-      auto value = mRAM[mSuzyProcessRequest->addr] & mSuzyProcessRequest->mask | mSuzyProcessRequest->value;
-      mRAM[mSuzyProcessRequest->addr] = (uint8_t)value;
-  }
-    mCurrentTick += 5ull + mFastCycleTick;  //read & write byte
-    break;
-  case ISuzyProcess::Request::XOR:
-    {
-      auto ramValue = mRAM[mSuzyProcessRequest->addr];
-      auto xorValue = ramValue ^ mSuzyProcessRequest->value;
-      mRAM[mSuzyProcessRequest->addr] = (uint8_t)xorValue;
-    }
-    mCurrentTick += 5ull + mFastCycleTick; //read & write byte
+  default:
+    if ( auto value = suzyAccess( *mSuzyProcessRequest ) )
+      mSuzyProcess->respond( *value );
     break;
   }
 
   return true;
 }
 
+template<bool TRAPS>
 CpuBreakType Core::executeCPUAction()
 {
   auto const& req = mCpu->advance();
 
-  auto pageType = mPageTypes[req.address >> 8];
-
-  enum class CPUAction
-  {
-    FETCH_OPCODE_RAM = 0,
-    FETCH_OPERAND_RAM,
-    READ_RAM,
-    WRITE_RAM,
-    FETCH_OPCODE_SUZY,
-    FETCH_OPERAND_SUZY,
-    READ_SUZY,
-    WRITE_SUZY,
-    FETCH_OPCODE_MIKEY,
-    FETCH_OPERAND_MIKEY,
-    READ_MIKEY,
-    WRITE_MIKEY,
-    FETCH_OPCODE_KENREL,
-    FETCH_OPERAND_KENREL,
-    READ_KENREL,
-    WRITE_KENREL
-  };
-
-  CPUAction action = (CPUAction)( (int)req.type + (int)pageType );
-
-  switch ( action )
+  switch ( req.type )
   {
-  case CPUAction::FETCH_OPCODE_RAM:
-    mCurrentTick += fetchRAMTiming( req.address );
-    return mCpu->respondFetchOpcode( fetchRAM( req.address ) );
-  case CPUAction::FETCH_OPERAND_RAM:
-    mCpu->respond( readRAM( req.address ) );
-    mCurrentTick += fetchRAMTiming( req.address );
-    break;
-  case CPUAction::READ_RAM:
-    mCpu->respond( readRAM( req.address ) );
-    mCurrentTick += readTiming( req.address );
-    break;
-  case CPUAction::WRITE_RAM:
-    writeRAM( req.address, req.value );
-    mCurrentTick += writeTiming( req.address );
-    break;
-  case CPUAction::FETCH_OPCODE_KENREL:
-    mCurrentTick += fetchROMTiming( req.address );
-    return mCpu->respondFetchOpcode( readROM( req.address & 0x1ff, true ) );
-  case CPUAction::FETCH_OPERAND_KENREL:
-    mCpu->respond( readROM( req.address & 0x1ff, false ) );
-    mCurrentTick += fetchROMTiming( req.address );
+  case CPU::Request::Type::FETCH_OPCODE:
+    return mCpu->respondFetchOpcode( cpuFetchOpcode<TRAPS>( req.address ) );
+  case CPU::Request::Type::FETCH_OPERAND:
+    mCpu->respond( cpuFetchOperand<TRAPS>( req.address ) );
     break;
-  case CPUAction::READ_KENREL:
-    mCpu->respond( readROM( req.address & 0x1ff, false ) );
-    mCurrentTick += readTiming( req.address );
+  case CPU::Request::Type::READ:
+    mCpu->respond( cpuRead<TRAPS>( req.address ) );
     break;
-  case CPUAction::WRITE_KENREL:
-    writeROM( req.address & 0x1ff, req.value );
-    mCurrentTick += writeTiming( req.address );
-    break;
-  case CPUAction::FETCH_OPCODE_SUZY:
-    //no code in Suzy napespace. Should trigger emulation break
-    mCurrentTick = mSuzy->requestRead( mCurrentTick, req.address );
-    return mCpu->respondFetchOpcode( readSuzy( req.address ) );
-  case CPUAction::FETCH_OPERAND_SUZY:
-    [[fallthrough]];
-  case CPUAction::READ_SUZY:
-    mCurrentTick = mSuzy->requestRead( mCurrentTick, req.address );
-    mCpu->respond( readSuzy( req.address ) );
-    break;
-  case CPUAction::WRITE_SUZY:
-    mCurrentTick = mSuzy->requestWrite( mCurrentTick, req.address );
-    writeSuzy( req.address, req.value );
-    break;
-  case CPUAction::FETCH_OPCODE_MIKEY:
-    //no code in Suzy napespace. Should trigger emulation break
-    mCurrentTick = mMikey->requestAccess( mCurrentTick, req.address );
-    return mCpu->respondFetchOpcode( readMikey( req.address ) );
-  case CPUAction::FETCH_OPERAND_MIKEY:
-    [[fallthrough]];
-  case CPUAction::READ_MIKEY:
-    mCurrentTick = mMikey->requestAccess( mCurrentTick, req.address );
-    mCpu->respond( readMikey( req.address ) );
-    break;
-  case CPUAction::WRITE_MIKEY:
-    mCurrentTick = mMikey->requestAccess( mCurrentTick, req.address );
-    writeMikey( req.address, req.value );
+  case CPU::Request::Type::WRITE:
+    cpuWrite<TRAPS>( req.address, req.value );
     break;
   }
 
   return CpuBreakType::NONE;
 }
 
-void Core::enqueueSampling()
+template<bool TRAPS>
+uint8_t Core::cpuFetchOpcode( uint16_t address )
 {
-  int ticks = 16000000 / mSPS;
-  mSamplesRemainder += 16000000 % mSPS;
-  if ( mSamplesRemainder > mSPS )
+  switch ( mPageTypes[address >> 8] )
   {
-    mSamplesRemainder %= mSPS;
-    ticks += 1;
+  case PageType::RAM:
+    mCurrentTick += fetchRAMTiming( address );
+    return fetchRAM<TRAPS>( address );
+  case PageType::ROM:
+    mCurrentTick += fetchROMTiming( address );
+    return readROM( address & 0x1ff, true );
+  case PageType::SUZY:
+    //no code in Suzy namespace. Should trigger emulation break
+    mCurrentTick = mSuzy->requestRead( mCurrentTick, address );
+    return readSuzy<TRAPS>( address );
+  default:  //PageType::MIKEY
+    //no code in Mikey namespace. Should trigger emulation break
+    mCurrentTick = mMikey->requestAccess( mCurrentTick, address );
+    return readMikey<TRAPS>( address );
   }
+}
 
-  mActionQueue.push( { Action::SAMPLE_AUDIO, mCurrentTick + ticks } );
+template<bool TRAPS>
+uint8_t Core::cpuFetchOperand( uint16_t address )
+{
+  uint8_t value;
+  switch ( mPageTypes[address >> 8] )
+  {
+  case PageType::RAM:
+    value = readRAM<TRAPS>( address );
+    mCurrentTick += fetchRAMTiming( address );
+    return value;
+  case PageType::ROM:
+    value = readROM( address & 0x1ff, false );
+    mCurrentTick += fetchROMTiming( address );
+    return value;
+  case PageType::SUZY:
+    mCurrentTick = mSuzy->requestRead( mCurrentTick, address );
+    return readSuzy<TRAPS>( address );
+  default:  //PageType::MIKEY
+    mCurrentTick = mMikey->requestAccess( mCurrentTick, address );
+    return readMikey<TRAPS>( address );
+  }
+}
+
+template<bool TRAPS>
+uint8_t Core::cpuRead( uint16_t address )
+{
+  uint8_t value;
+  switch ( mPageTypes[address >> 8] )
+  {
+  case PageType::RAM:
+    value = readRAM<TRAPS>( address );
+    mCurrentTick += readTiming( address );
+    return value;
+  case PageType::ROM:
+    value = readROM( address & 0x1ff, false );
+    mCurrentTick += readTiming( address );
+    return value;
+  case PageType::SUZY:
+    mCurrentTick = mSuzy->requestRead( mCurrentTick, address );
+    return readSuzy<TRAPS>( address );
+  default:  //PageType::MIKEY
+    mCurrentTick = mMikey->requestAccess( mCurrentTick, address );
+    return readMikey<TRAPS>( address );
+  }
+}
+
+template<bool TRAPS>
+void Core::cpuWrite( uint16_t address, uint8_t value )
+{
+  switch ( mPageTypes[address >> 8] )
+  {
+  case PageType::RAM:
+    writeRAM<TRAPS>( address, value );
+    mCurrentTick += writeTiming( address );
+    break;
+  case PageType::ROM:
+    writeROM( address & 0x1ff, value );
+    mCurrentTick += writeTiming( address );
+    break;
+  case PageType::SUZY:
+    mCurrentTick = mSuzy->requestWrite( mCurrentTick, address );
+    writeSuzy<TRAPS>( address, value );
+    break;
+  default:  //PageType::MIKEY
+    mCurrentTick = mMikey->requestAccess( mCurrentTick, address );
+    writeMikey<TRAPS>( address, value );
+    break;
+  }
 }
 
 CpuBreakType Core::run( RunMode runMode )
 {
   mHaltSuzy = false;
+  mCPUDeadline = 0;
 
   switch ( runMode )
   {
@@ -488,45 +484,227 @@ CpuBreakType Core::run( RunMode runMode )
     break;
   }
 
-  for ( ;; )
+  //trap-free memory path unless a trap is installed on RAM, Mikey or Suzy. Traps can only change between runs
+  if ( mScriptDebugger->hasMemoryTraps() )
+    return mRunProfile ? runLoop<true, true>() : runLoop<false, true>();
+  else
+    return mRunProfile ? runLoop<true, false>() : runLoop<false, false>();
+}
+
+//Bus of CPU::interpret. After each access it drains whatever the run loop would execute before advancing the coroutine,
+//so both backends see the same machine state at every access.
+template<bool TRAPS, typename Drain>
+class Core::DirectBus
+{
+public:
+  DirectBus( Core & core, Drain & drain ) : mCore{ core }, mCpu{ *core.mCpu }, mDrain{ drain }
+  {
+  }
+
+  CpuBreakType fetchOpcode( uint16_t address )
+  {
+    auto cpuBreakType = mCpu.respondFetchOpcode( mCore.template cpuFetchOpcode<TRAPS>( address ) );
+    if ( cpuBreakType == CpuBreakType::NONE )
+      mDrain();
+    return cpuBreakType;
+  }
+
+  uint8_t fetchOperand( uint16_t address )
+  {
+    uint8_t value = mCore.template cpuFetchOperand<TRAPS>( address );
+    mDrain();
+    return value;
+  }
+
+  uint8_t read( uint16_t address )
+  {
+    uint8_t value = mCore.template cpuRead<TRAPS>( address );
+    mDrain();
+    return value;
+  }
+
+  void write( uint16_t address, uint8_t value )
   {
-    if ( !mActionQueue.empty() && mActionQueue.headTick() <= mCurrentTick )
+    mCore.template cpuWrite<TRAPS>( address, value );
+    mDrain();
+  }
+
+private:
+  Core & mCore;
+  CPU & mCpu;
+  Drain & mDrain;
+};
+
+template<bool PROFILE, bool TRAPS>
+CpuBreakType Core::runLoop()
+{
+  using clock = std::chrono::steady_clock;
+
+  //time since previous step is attributed to the step that has just finished
+  auto last = PROFILE ? clock::now() : clock::time_point{};
+  auto account = [&]( std::chrono::nanoseconds RunProfile::* bucket )
+  {
+    if constexpr ( PROFILE )
     {
-      executeSequencedAction( mActionQueue.pop() );
+      auto now = clock::now();
+      ( *mRunProfile ).*bucket += now - last;
+      last = now;
     }
-    else if ( !executeSuzyAction() )
+  };
+
+  //everything that is due before the CPU may proceed
+  auto drain = [&]
+  {
+    if ( mCurrentTick < mCPUDeadline )
+    {
+      mExecutedTick = mCurrentTick;
+      return;
+    }
+
+    for ( ;; )
     {
-      auto cpuBreakType = executeCPUAction();
-      if ( cpuBreakType != CpuBreakType::NONE )
-        return cpuBreakType;
+      if ( !mActionQueue.empty() && mActionQueue.headTick() <= mCurrentTick )
+      {
+        executeSequencedAction( mActionQueue.pop() );
+        account( &RunProfile::sequenced );
+      }
+      else if ( executeSuzyAction() )
+      {
+        account( &RunProfile::suzy );
+      }
+      else
+      {
+        break;
+      }
     }
+
+    //nothing is due until the head of the queue unless something gets scheduled or Suzy started
+    mCPUDeadline = mActionQueue.empty() ? std::numeric_limits<uint64_t>::max() : mActionQueue.headTick();
+    mExecutedTick = mCurrentTick;
+  };
+
+  if ( mCPUBackend == CPUBackend::INTERPRETER )
+  {
+    auto drainAfterAccess = [&]
+    {
+      account( &RunProfile::cpu );
+      drain();
+    };
+
+    drain();
+    DirectBus<TRAPS, decltype( drainAfterAccess )> bus{ *this, drainAfterAccess };
+    return mCpu->interpret( bus );
+  }
+
+  for ( ;; )
+  {
+    drain();
+    auto cpuBreakType = executeCPUAction<TRAPS>();
+    account( &RunProfile::cpu );
+    if ( cpuBreakType != CpuBreakType::NONE )
+      return cpuBreakType;
+  }
+}
+
+void Core::enableRunProfile( bool enable )
+{
+  if ( !enable )
+    mRunProfile.reset();
+  else if ( !mRunProfile )
+    mRunProfile = std::make_unique<RunProfile>();
+}
+
+Core::RunProfile Core::runProfile() const
+{
+  return mRunProfile ? *mRunProfile : RunProfile{};
+}
+
+void Core::enableCodeProfile( bool enable )
+{
+  if ( enable && !mCodeProfiler )
+    mCodeProfiler = std::make_shared<CodeProfiler>( mCurrentTick );
+
+  //time while disabled is not attributed to the instruction before
+  if ( mCodeProfiler )
+    mCodeProfiler->pause();
+
+  mCpu->setProfiler( enable ? mCodeProfiler : nullptr );
+}
+
+std::shared_ptr<CodeProfiler> Core::codeProfile() const
+{
+  return mCodeProfiler;
+}
+
+void Core::enableBandLimitedAudio( bool enable )
+{
+  mBandLimitedAudio = enable;
+}
+
+void Core::enableTurbo( uint32_t drawInterval )
+{
+  mMikey->setTurbo( drawInterval );
+}
+
+void Core::enableLazyAudio( bool enable )
+{
+  mMikey->setLazyAudio( enable );
+}
+
+void Core::linkComLynx( std::shared_ptr<ComLynxLink> link )
+{
+  mComLynx->setLink( link );
+  mMikey->wakeComLynx();
+  mActionQueue.erase( Action::COMLYNX_SYNC );
+  mComLynxLink = std::move( link );
+  if ( mComLynxLink )
+  {
+    schedule( { Action::COMLYNX_SYNC, mCurrentTick } );
   }
 }
 
 CpuBreakType Core::advanceAudio( int sps, std::span<AudioSample> outputBuffer, RunMode runMode )
 {
-  mSPS = sps;
-  mOutputSamples = outputBuffer;
-  mSamplesEmitted = 0;
+  static constexpr uint64_t PERIOD = 16000000;
+
+  //samples continue the grid of the previous batch unless the machine has been moved elsewhere
+  if ( mSampleTick > mCurrentTick || mCurrentTick - mSampleTick > PERIOD / 50 )
+  {
+    mMikey->skipAudio( mCurrentTick );
+    mSampleTick = mCurrentTick;
+    mSamplePhase = 0;
+  }
+
+  //sample positions are kept in ticks multiplied by sps
+  uint64_t const base = mSampleTick * sps + ( ( (uint64_t)mSamplePhase * sps ) >> 32 );
   CpuBreakType cpuBreakType = CpuBreakType::NONE;
+  mMikey->startAudio( base, sps );
 
   if ( runMode != RunMode::PAUSE )
   {
-    enqueueSampling();
+    uint64_t const last = base + outputBuffer.size() * PERIOD;
+    schedule( { Action::BATCH_END, ( last + sps - 1 ) / sps } );
     cpuBreakType = run( runMode );
+    mActionQueue.erase( Action::BATCH_END );
   }
   else
   {
     mCpu->clearBreak();
   }
 
-  if ( mSamplesEmitted < mOutputSamples.size() )
+  //the whole batch is rendered from the recorded output changes, samples after a break are silent
+  uint64_t const now = mCurrentTick * sps;
+  size_t const rendered = (size_t)std::min<uint64_t>( outputBuffer.size(), now > base ? ( now - base ) / PERIOD : 0 );
+  mMikey->renderAudio( outputBuffer.first( rendered ), base, sps, mBandLimitedAudio );
+  std::fill( outputBuffer.begin() + rendered, outputBuffer.end(), AudioSample{} );
+
+  uint64_t const pos = base + rendered * PERIOD;
+  mSampleTick = pos / sps;
+  mSamplePhase = (uint32_t)( ( ( pos % sps << 32 ) + sps - 1 ) / sps );
+
+  if ( mRewind && mFrameEnded && canSaveState() )
   {
-    mActionQueue.erase( Action::SAMPLE_AUDIO );
-    for ( size_t i = mSamplesEmitted; i < mOutputSamples.size(); ++i )
-    {
-      mOutputSamples[mSamplesEmitted++] = {};
-    }
+    captureRewind();
   }
 
   return cpuBreakType;
@@ -546,6 +724,11 @@ void Core::newLine( int rowNr )
 {
 }
 
+void Core::newFrame()
+{
+  mFrameEnded = true;
+}
+
 std::shared_ptr<TraceHelper> Core::getTraceHelper() const
 {
   return mTraceHelper;
@@ -577,10 +760,11 @@ uint64_t Core::writeTiming( uint16_t address )
   return 5;
 }
 
+template<bool TRAPS>
 uint8_t Core::fetchRAM( uint16_t address )
 {
   uint8_t sourceByte = mRAM[address];
-  if constexpr ( ENABLE_TRAPS )
+  if constexpr ( TRAPS )
   {
     uint8_t filteredByte = mScriptDebugger->executeRAM( *this, address, sourceByte );
     return filteredByte;
@@ -594,21 +778,14 @@ uint8_t Core::fetchRAM( uint16_t address )
 uint8_t Core::fetchROM( uint16_t address )
 {
   uint8_t sourceByte = mROM[address];
-  if constexpr ( ENABLE_TRAPS )
-  {
-    uint8_t filteredByte = mScriptDebugger->executeROM( *this, address, sourceByte );
-    return filteredByte;
-  }
-  else
-  {
-    return sourceByte;
-  }
+  return mScriptDebugger->executeROM( *this, address, sourceByte );
 }
 
+template<bool TRAPS>
 uint8_t Core::readRAM( uint16_t address )
 {
   uint8_t sourceByte = mRAM[address];
-  if constexpr ( ENABLE_TRAPS )
+  if constexpr ( TRAPS )
   {
     uint8_t filteredByte = mScriptDebugger->readRAM( *this, address, sourceByte );
     return filteredByte;
@@ -622,20 +799,13 @@ uint8_t Core::readRAM( uint16_t address )
 uint8_t Core::readROM( uint16_t address )
 {
   uint8_t sourceByte = mROM[address];
-  if constexpr ( ENABLE_TRAPS )
-  {
-    uint8_t filteredByte = mScriptDebugger->readROM( *this, address, sourceByte );
-    return filteredByte;
-  }
-  else
-  {
-    return sourceByte;
-  }
+  return mScriptDebugger->readROM( *this, address, sourceByte );
 }
 
+template<bool TRAPS>
 void Core::writeRAM( uint16_t address, uint8_t value )
 {
-  if constexpr ( ENABLE_TRAPS )
+  if constexpr ( TRAPS )
   {
     uint8_t filteredByte = mScriptDebugger->writeRAM( *this, address, value );
     mRAM[address] = filteredByte;
@@ -646,11 +816,12 @@ void Core::writeRAM( uint16_t address, uint8_t value )
   }
 }
 
+template<bool TRAPS>
 uint8_t Core::readMikey( uint16_t address )
 {
   mCurrentTick = mMikey->requestAccess( mCurrentTick, address );
   uint8_t sourceByte = mMikey->read( address );
-  if constexpr ( ENABLE_TRAPS )
+  if constexpr ( TRAPS )
   {
     uint8_t filteredByte = mScriptDebugger->readMikey( *this, address, sourceByte );
     return filteredByte;
@@ -661,29 +832,31 @@ uint8_t Core::readMikey( uint16_t address )
   }
 }
 
+template<bool TRAPS>
 void Core::writeMikey( uint16_t address, uint8_t value )
 {
-  if constexpr ( ENABLE_TRAPS )
+  if constexpr ( TRAPS )
   {
     uint8_t filteredByte = mScriptDebugger->writeMikey( *this, address, value );
     if ( auto mikeyAction = mMikey->write( address, filteredByte ) )
     {
-      mActionQueue.push( mikeyAction );
+      schedule( mikeyAction );
     }
   }
   else
   {
     if ( auto mikeyAction = mMikey->write( address, value ) )
     {
-      mActionQueue.push( mikeyAction );
+      schedule( mikeyAction );
     }
   }
 }
 
+template<bool TRAPS>
 uint8_t Core::readSuzy( uint16_t address )
 {
   uint8_t sourceByte = mSuzy->read( address );
-  if constexpr ( ENABLE_TRAPS )
+  if constexpr ( TRAPS )
   {
     uint8_t filteredByte = mScriptDebugger->readSuzy( *this, address, sourceByte );
     return filteredByte;
@@ -694,9 +867,10 @@ uint8_t Core::readSuzy( uint16_t address )
   }
 }
 
+template<bool TRAPS>
 void Core::writeSuzy( uint16_t address, uint8_t value )
 {
-  if constexpr ( ENABLE_TRAPS )
+  if constexpr ( TRAPS )
   {
     uint8_t filteredByte = mScriptDebugger->writeSuzy( *this, address, value );
     mSuzy->write( address, filteredByte );
@@ -713,7 +887,7 @@ uint8_t Core::readROM( uint16_t address, bool isFetch )
   {
     if ( mMapCtl.vectorSpaceDisable )
     {
-      return isFetch ? fetchRAM( address + 0xfe00 ) : readRAM( address + 0xfe00 );
+      return isFetch ? fetchRAM<true>( address + 0xfe00 ) : readRAM<true>( address + 0xfe00 );
     }
     else
     {
@@ -724,7 +898,7 @@ uint8_t Core::readROM( uint16_t address, bool isFetch )
   {
     if ( mMapCtl.romDisable )
     {
-      return isFetch ? fetchRAM( address + 0xfe00 ) : readRAM( address + 0xfe00 );
+      return isFetch ? fetchRAM<true>( address + 0xfe00 ) : readRAM<true>( address + 0xfe00 );
     }
     else
     {
@@ -744,7 +918,7 @@ uint8_t Core::readROM( uint16_t address, bool isFetch )
   else
   {
     //there is always RAM at 0xfff8
-    return isFetch ? fetchRAM( address + 0xfe00 ) : readRAM( address + 0xfe00 );
+    return isFetch ? fetchRAM<true>( address + 0xfe00 ) : readRAM<true>( address + 0xfe00 );
   }
 }
 
@@ -752,7 +926,7 @@ void Core::writeROM( uint16_t address, uint8_t value )
 {
   if ( address >= 0x1fa && mMapCtl.vectorSpaceDisable || address < 0x1f8 && mMapCtl.romDisable || address == 0x1f8 )
   {
-    writeRAM( 0xfe00 + address, value );
+    writeRAM<true>( 0xfe00 + address, value );
   }
   else if ( address == 0x1f9 )
   {
@@ -787,6 +961,104 @@ uint64_t Core::tick() const
   return mCurrentTick;
 }
 
+bool Core::canSaveState() const
+{
+  return ( !mSuzyProcess || mSuzyProcess->betweenSCBs() ) && mCpu->instructionBoundary() && mCartridge->serializable() && !mComLynxLink;
+}
+
+size_t Core::stateSize()
+{
+  if ( !canSaveState() )
+    return 0;
+
+  StateStream stream{};
+  StateHeader header{};
+  stream( header );
+  serialize( stream );
+  return stream.offset();
+}
+
+bool Core::saveState( std::span<uint8_t> out )
+{
+  if ( !canSaveState() )
+    return false;
+
+  StateHeader header{ STATE_MAGIC, STATE_VERSION, stateSize() };
+  StateStream stream{ out };
+  stream( header );
+  serialize( stream );
+  return stream.good();
+}
+
+bool Core::loadState( std::span<uint8_t const> in )
+{
+  if ( mComLynxLink || !mCartridge->serializable() || in.size() < sizeof( StateHeader ) )
+    return false;
+
+  StateHeader header;
+  std::memcpy( &header, in.data(), sizeof( StateHeader ) );
+  if ( header.magic != STATE_MAGIC || header.version != STATE_VERSION || header.size != in.size() )
+    return false;
+
+  StateStream stream{ in };
+  stream( header );
+  serialize( stream );
+  return stream.good();
+}
+
+void Core::enableRewind( size_t budget )
+{
+  if ( budget > 0 )
+    mRewind = std::make_unique<RewindBuffer>( budget );
+  else
+    mRewind.reset();
+  mFrameEnded = false;
+}
+
+bool Core::rewind()
+{
+  //captured states are kept for when the link is gone
+  if ( !mRewind || mComLynxLink )
+    return false;
+
+  if ( mRewind->size() > 1 )
+    mRewind->pop();
+
+  auto state = mRewind->pop();
+  mFrameEnded = false;
+  return !state.empty() && loadState( state );
+}
+
+size_t Core::rewindDepth() const
+{
+  return mRewind ? mRewind->size() : 0;
+}
+
+void Core::captureRewind()
+{
+  auto state = mRewind->stage( stateSize() );
+  saveState( state );
+  mRewind->push();
+  mFrameEnded = false;
+}
+
+void Core::serialize( StateStream & stream )
+{
+  //sprite process is saved between SCBs, where its whole state is in Suzy registers, and is restarted from the next SCB on load
+  bool suzyProcess = mSuzyProcess != nullptr;
+  stream( mRAM, mROM, mPageTypes, mMapCtl, mCurrentTick, mExecutedTick, mSampleTick, mSamplePhase, mFastCycleTick, mDMAAddress, mResetRequestDuringSpriteRendering,
+    mSuzyRunning, mHaltSuzy, suzyProcess );
+  if ( stream.loading() )
+    mSuzyProcess = suzyProcess ? mSuzy->suzyProcess( mSuzyBackend == SuzyBackend::BATCHED ) : nullptr;
+
+  mActionQueue.serialize( stream );
+  mCpu->serialize( stream );
+  mMikey->serialize( stream );
+  mSuzy->serialize( stream );
+  mComLynx->serialize( stream );
+  mCartridge->serialize( stream );
+}
+
 uint8_t Core::debugReadRAM( uint16_t address ) const
 {
   return mRAM[address];
@@ -813,7 +1085,7 @@ void Core::debugWriteMikey( uint16_t address, uint8_t value )
   mMikey->requestAccess( mCurrentTick, address );
   if ( auto mikeyAction = mMikey->write( address, value ) )
   {
-    mActionQueue.push( mikeyAction );
+    schedule( mikeyAction );
   }
 }
 
@@ -16,24 +16,30 @@ class ImageROM;
 class ImageProperties;
 class IEscape;
 class ComLynxWire;
+class ComLynxLink;
 class TraceHelper;
 class ScriptDebuggerEscapes;
 class ScriptDebugger;
 class VGMWriter;
 struct CPUState;
+class StateStream;
+class RewindBuffer;
+class CodeProfiler;
 
 class Core
 {
 public:
   Core( ImageProperties const& imageProperties, std::shared_ptr<ComLynxWire> comLynxWire, std::shared_ptr<IVideoSink> videoSink,
     std::shared_ptr<IInputSource> inputSource, InputFile inputFile, std::shared_ptr<ImageROM const> bios,
-    std::shared_ptr<ScriptDebuggerEscapes> scriptDebuggerEscapes );
+    std::shared_ptr<ScriptDebuggerEscapes> scriptDebuggerEscapes, CPUBackend cpuBackend = CPUBackend::INTERPRETER, SuzyBackend suzyBackend = SuzyBackend::BATCHED );
   ~Core();
 
   CpuBreakType advanceAudio( int sps, std::span<AudioSample> outputBuffer, RunMode runMode );
   CpuBreakType run( RunMode runMode );
 
   void setLog( std::filesystem::path const & path );
+  //binary trace of executed instructions for felix-trace, empty path stops recording
+  void recordTrace( std::filesystem::path const & path );
   void setVGMWriter( std::filesystem::path const& path );
   bool isVGMWriter() const;
   void dumpMemory( std::filesystem::path const & path );
@@ -44,6 +50,51 @@ public:
 
   uint64_t tick() const;
 
+  //Machine state snapshot for a Core created from the same image and boot ROM.
+  //It can be taken between run calls while the sprite engine is idle or between SCBs and unless a custom cart is used.
+  bool canSaveState() const;
+  size_t stateSize();
+  bool saveState( std::span<uint8_t> out );
+  //fails while ComLynx is linked, as the tick would leave the lockstep of the peers
+  bool loadState( std::span<uint8_t const> in );
+
+  //Keeps states captured at frame boundaries in a delta ring of given size in bytes, 0 disables it.
+  //A state is captured at the end of advanceAudio following a frame boundary.
+  void enableRewind( size_t budget );
+  //Goes back one captured state. The most recent state is dropped and the previous one restored and dropped too,
+  //as it's captured again on the following frame boundary
+  bool rewind();
+  size_t rewindDepth() const;
+
+  //wall time spent in each kind of run loop step
+  struct RunProfile
+  {
+    std::chrono::nanoseconds sequenced;
+    std::chrono::nanoseconds suzy;
+    std::chrono::nanoseconds cpu;
+  };
+
+  //profiling adds a clock read per run loop step, so it is off by default
+  void enableRunProfile( bool enable );
+  RunProfile runProfile() const;
+
+  //per PC and per call stack instruction profile, collected data is kept while disabled
+  void enableCodeProfile( bool enable );
+  std::shared_ptr<CodeProfiler> codeProfile() const;
+
+  //smooths steps of the audio output to reduce aliasing at the cost of one sample of latency
+  void enableBandLimitedAudio( bool enable );
+  //Fast forward that produces silent audio and converts only every drawInterval-th frame to pixels, 0 disables it.
+  //Emulation itself is unaffected, so turbo can be switched at any batch boundary
+  void enableTurbo( uint32_t drawInterval );
+  //Audio channels nothing observes are run only when something can tell the difference instead of through the action queue.
+  //On by default, disabling it is for checking that the output stays the same
+  void enableLazyAudio( bool enable );
+
+  //Connects ComLynx to instances in other threads or processes, nullptr goes back to the wire.
+  //Emulation waits for the slowest of them to keep the lockstep, and the machine state can't be saved while linked.
+  void linkComLynx( std::shared_ptr<ComLynxLink> link );
+
   //Not thread safe. Used only for script escapes
   uint8_t debugReadROM( uint16_t address ) const;
   uint8_t debugReadRAM( uint16_t address ) const;
@@ -82,17 +133,42 @@ private:
     bool suzyDisable;
   };
 
+  template<bool TRAPS, typename Drain>
+  class DirectBus;
+
+  template<bool PROFILE, bool TRAPS>
+  CpuBreakType runLoop();
   void executeSequencedAction( SequencedAction );
   bool executeSuzyAction();
+  inline bool suzyMayRunAhead() const;
+  inline std::optional<uint32_t> suzyAccess( ISuzyProcess::Request const& req );
+  template<bool TRAPS>
   CpuBreakType executeCPUAction();
+  template<bool TRAPS>
+  inline uint8_t cpuFetchOpcode( uint16_t address );
+  template<bool TRAPS>
+  inline uint8_t cpuFetchOperand( uint16_t address );
+  template<bool TRAPS>
+  inline uint8_t cpuRead( uint16_t address );
+  template<bool TRAPS>
+  inline void cpuWrite( uint16_t address, uint8_t value );
+  void serialize( StateStream & stream );
   void setROM( std::shared_ptr<ImageROM const> bootROM );
 
-  uint8_t fetchRAM( uint16_t address );
-  uint8_t readRAM( uint16_t address );
-  void writeRAM( uint16_t address, uint8_t value );
+  //TRAPS selects the path passing accesses through ScriptDebugger
+  template<bool TRAPS>
+  inline uint8_t fetchRAM( uint16_t address );
+  template<bool TRAPS>
+  inline uint8_t readRAM( uint16_t address );
+  template<bool TRAPS>
+  inline void writeRAM( uint16_t address, uint8_t value );
+  template<bool TRAPS>
   uint8_t readMikey( uint16_t address );
+  template<bool TRAPS>
   void writeMikey( uint16_t address, uint8_t value );
+  template<bool TRAPS>
   uint8_t readSuzy( uint16_t address );
+  template<bool TRAPS>
   void writeSuzy( uint16_t address, uint8_t value );
   uint8_t readROM( uint16_t address, bool isFetch );
   uint8_t readROM( uint16_t address );
@@ -101,13 +177,16 @@ private:
 
   void pulseReset( std::optional<uint16_t> resetAddress = std::nullopt );
   void writeMAPCTL( uint8_t value );
-  void enqueueSampling();
   void assertInterrupt( int mask, std::optional<uint64_t> tick = std::nullopt );
   void desertInterrupt( int mask, std::optional<uint64_t> tick = std::nullopt );
   void requestDisplayDMA( uint64_t tick, uint16_t address );
   void runSuzy();
+  void schedule( SequencedAction action );
+  uint64_t executedTick() const;
   Cartridge & getCartridge();
   void newLine( int rowNr );  
+  void newFrame();
+  void captureRewind();
   inline uint64_t fetchRAMTiming( uint16_t address );
   inline uint64_t fetchROMTiming( uint16_t address );
   inline uint64_t readTiming( uint16_t address );
@@ -116,6 +195,8 @@ private:
   friend class Mikey;
   friend class Suzy;
   friend class ParallelPort;
+  template<typename SPRITEDUMPER>
+  friend class SuzyProcess;
 
 private:
   std::array<uint8_t, 65536> mRAM;
@@ -123,24 +204,101 @@ private:
   std::array<PageType, 256> mPageTypes;
   std::shared_ptr<ScriptDebugger> mScriptDebugger;
   uint64_t mCurrentTick;
-  int mSamplesRemainder;
-  int mSPS;
-  std::span<AudioSample> mOutputSamples;
-  uint32_t mSamplesEmitted;
+  //last rendered audio sample, phase is a fraction of a tick in 1/2^32 units
+  uint64_t mSampleTick;
+  uint32_t mSamplePhase;
+  bool mBandLimitedAudio;
   ActionQueue mActionQueue;
   std::shared_ptr<TraceHelper> mTraceHelper;
   std::shared_ptr<CPU> mCpu;
+  CPUBackend mCPUBackend;
   std::shared_ptr<Cartridge> mCartridge;
   std::shared_ptr<ComLynx> mComLynx;
   std::shared_ptr<ComLynxWire> mComLynxWire;
+  std::shared_ptr<ComLynxLink> mComLynxLink;
   std::shared_ptr<Mikey> mMikey;
   std::shared_ptr<Suzy> mSuzy;
   MAPCTL mMapCtl;
   uint64_t mFastCycleTick;
   uint16_t mDMAAddress;
+  SuzyBackend mSuzyBackend;
   std::shared_ptr<ISuzyProcess> mSuzyProcess;
   ISuzyProcess::Request const* mSuzyProcessRequest;
   bool mResetRequestDuringSpriteRendering;
   bool mSuzyRunning;
   bool mHaltSuzy;
+  std::unique_ptr<RunProfile> mRunProfile;
+  std::shared_ptr<CodeProfiler> mCodeProfiler;
+  std::unique_ptr<RewindBuffer> mRewind;
+  bool mFrameEnded;
+  //CPU runs without the run loop checks until this tick, lowered by anything scheduled or Suzy start
+  uint64_t mCPUDeadline;
+  //actions due up to this tick have been executed by the last drain of the run loop
+  uint64_t mExecutedTick;
 };
+
+//the same check the run loop does before each Suzy step
+bool Core::suzyMayRunAhead() const
+{
+  return mActionQueue.empty() || mActionQueue.headTick() > mCurrentTick;
+}
+
+//performs sprite engine memory access and returns the response if there is any
+std::optional<uint32_t> Core::suzyAccess( ISuzyProcess::Request const& req )
+{
+  switch ( req.type )
+  {
+  case ISuzyProcess::Request::READ:
+  case ISuzyProcess::Request::FETCHSCB:
+    mCurrentTick += 5ull; //read byte
+    return mRAM[req.addr];
+  case ISuzyProcess::Request::READ4:
+  case ISuzyProcess::Request::READPAL:
+    mCurrentTick += 5ull + 3 * mFastCycleTick;  //read 4 bytes
+    if ( req.addr <= 0xfffc )
+      return *( (uint32_t const *)( mRAM.data() + req.addr ) );
+    break;
+  case ISuzyProcess::Request::WRITE:
+  case ISuzyProcess::Request::WRITEFRED:
+    mRAM[req.addr] = (uint8_t)req.value;
+    mCurrentTick += 5ull; //write byte
+    break;
+  case ISuzyProcess::Request::COLRMW:
+    {
+      if ( req.addr > 0xfffc )
+        break;
+
+      const uint32_t u16 = req.value;
+      const uint32_t u32 = u16 | ( u16 << 16 );
+      const uint32_t maskedU32 = u32 & req.mask;
+
+      const uint32_t value = *( (uint32_t const*)( mRAM.data() + req.addr ) );
+      const uint32_t maskedValue = value & ~req.mask;
+      const uint32_t outValue = value & req.mask;
+
+      *( (uint32_t *)( mRAM.data() + req.addr ) ) = maskedValue | maskedU32;
+
+      mCurrentTick += 5ull + 7 * mFastCycleTick;  //read 4 bytes & write 4 bytes
+      return outValue;
+    }
+  case ISuzyProcess::Request::VIDRMW:
+    {
+      auto value = mRAM[req.addr] & req.mask | req.value;
+      mRAM[req.addr] = (uint8_t)value;
+    }
+    mCurrentTick += 5ull + mFastCycleTick;  //read & write byte
+    break;
+  case ISuzyProcess::Request::XOR:
+    {
+      auto ramValue = mRAM[req.addr];
+      auto xorValue = ramValue ^ req.value;
+      mRAM[req.addr] = (uint8_t)xorValue;
+    }
+    mCurrentTick += 5ull + mFastCycleTick; //read & write byte
+    break;
+  default:
+    break;
+  }
+
+  return std::nullopt;
+}
@@ -1,7 +0,0 @@
-#pragma once
-
-#include <cstdint>
-
-//used only for internal debugging purposes;
-
-extern uint8_t* gDebugRAM;
@@ -1,16 +1,111 @@
 #include "DisplayGenerator.hpp"
 #include "IVideoSink.hpp"
 #include "Log.hpp"
+#include "StateStream.hpp"
+
+#if defined( __x86_64__ ) || defined( _M_X64 )
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define SSSE3_TARGET
+#else
+#define SSSE3_TARGET __attribute__( ( target( "ssse3" ) ) )
+#endif
+
+namespace
+{
+
+bool hasSSSE3()
+{
+#ifdef _MSC_VER
+  int info[4];
+  __cpuid( info, 1 );
+  return ( info[2] & ( 1 << 9 ) ) != 0;
+#else
+  return __builtin_cpu_supports( "ssse3" );
+#endif
+}
+
+//Expands whole 8 byte chunks of display data to doublets and returns number of bytes processed.
+//Pen numbers index colour channel tables with a byte shuffle, 16 pixels at a time
+SSSE3_TARGET size_t expandChunks( uint8_t const* src, size_t count, Doublet* dst, uint8_t const* blue, uint8_t const* green, uint8_t const* red )
+{
+  static bool const enabled = hasSSSE3();
+  if ( !enabled )
+    return 0;
+
+  __m128i const b = _mm_loadu_si128( (__m128i const*)blue );
+  __m128i const g = _mm_loadu_si128( (__m128i const*)green );
+  __m128i const r = _mm_loadu_si128( (__m128i const*)red );
+  __m128i const nibble = _mm_set1_epi8( 0x0f );
+  __m128i const zero = _mm_setzero_si128();
+
+  size_t done = 0;
+  for ( ; done + 8 <= count; done += 8 )
+  {
+    __m128i bytes = _mm_loadl_epi64( (__m128i const*)( src + done ) );
+    //left pixel is in the high nibble
+    __m128i pens = _mm_unpacklo_epi8( _mm_and_si128( _mm_srli_epi16( bytes, 4 ), nibble ), _mm_and_si128( bytes, nibble ) );
+    __m128i bv = _mm_shuffle_epi8( b, pens );
+    __m128i gv = _mm_shuffle_epi8( g, pens );
+    __m128i rv = _mm_shuffle_epi8( r, pens );
+    __m128i bgLo = _mm_unpacklo_epi8( bv, gv );
+    __m128i bgHi = _mm_unpackhi_epi8( bv, gv );
+    __m128i rxLo = _mm_unpacklo_epi8( rv, zero );
+    __m128i rxHi = _mm_unpackhi_epi8( rv, zero );
+    __m128i* out = (__m128i*)( dst + done );
+    _mm_storeu_si128( out + 0, _mm_unpacklo_epi16( bgLo, rxLo ) );
+    _mm_storeu_si128( out + 1, _mm_unpackhi_epi16( bgLo, rxLo ) );
+    _mm_storeu_si128( out + 2, _mm_unpacklo_epi16( bgHi, rxHi ) );
+    _mm_storeu_si128( out + 3, _mm_unpackhi_epi16( bgHi, rxHi ) );
+  }
+
+  return done;
+}
+
+}
+
+#else
+
+namespace
+{
+
+size_t expandChunks( uint8_t const* src, size_t count, Doublet* dst, uint8_t const* blue, uint8_t const* green, uint8_t const* red )
+{
+  return 0;
+}
+
+}
+
+#endif
 
 DisplayGenerator::DisplayGenerator( std::shared_ptr<IVideoSink> videoSink ) :
   mDMAData{}, mVideoSink{ std::move( videoSink ) }, mRowStartTick{ std::numeric_limits<uint64_t>::max() }, mDMAIteration{}, mDisplayRow{}, mEmittedRowDoublets{},
-  mDispAdr{}, mDispColor{}, mDispFlip{}, mDMAEnable{}, mDMAOffset{ -1 }, mRowPtr{}
+  mDispAdr{}, mDispColor{}, mDispFlip{}, mDMAEnable{}, mDMAOffset{ -1 }, mRowPtr{}, mPackedRowPtr{}, mPaletteChanged{ true }, mRowActive{},
+  mDrawInterval{ 1 }, mFrameCount{}
 {
   assert( mVideoSink );
   std::ranges::fill( mPalette, 0 );
   std::ranges::fill( mDoublets, Doublet{} );
+  updateChannels();
 }
 
+void DisplayGenerator::serialize( StateStream & stream )
+{
+  stream( mDoublets, mPalette, mDMAData, mRowStartTick, mDMAIteration, mDisplayRow, mEmittedRowDoublets, mDispAdr, mDispColor, mDispFlip, mDMAEnable,
+    mDMAOffset, mRowActive );
+
+  if ( stream.loading() )
+  {
+    //pixels already emitted to the current frame are not part of the state
+    bool rowPending = mRowActive && mDisplayRow >= 0 && drawFrame();
+    mRowPtr = rowPending ? mVideoSink->getRow( mDisplayRow ) : nullptr;
+    mPackedRowPtr = rowPending ? mVideoSink->getPackedRow( mDisplayRow ) : nullptr;
+    updateChannels();
+    mPaletteChanged = true;
+  }
+}
+
 void DisplayGenerator::dispCtl( bool dispColor, bool dispFlip, bool dmaEnable )
 {
   mDMAEnable = dmaEnable;
@@ -25,13 +120,27 @@ void DisplayGenerator::setPBKUP( uint8_t value )
   mDMAOffset = h * 16 - ROW_TICKS;
 }
 
+void DisplayGenerator::setDrawInterval( uint32_t interval )
+{
+  mDrawInterval = std::max( 1u, interval );
+}
+
+bool DisplayGenerator::drawFrame() const
+{
+  return mFrameCount % mDrawInterval == 0;
+}
+
 void DisplayGenerator::vblank( uint64_t tick )
 {
   if ( mDMAEnable )
   {
     flushDisplay( tick );
   }
-  mVideoSink->newFrame();
+  if ( drawFrame() )
+    mVideoSink->newFrame();
+  else
+    mVideoSink->skipFrame();
+  mFrameCount += 1;
   mRowStartTick = std::numeric_limits<uint64_t>::max();
 }
 
@@ -46,7 +155,23 @@ DisplayGenerator::DMARequest DisplayGenerator::hblank( uint64_t tick, int row )
   mDisplayRow = 101 - row;
   if ( mDisplayRow >= 0 && mDMAOffset >= 0 )
   {
-    mRowPtr = mVideoSink->getRow( mDisplayRow );
+    mRowActive = true;
+    if ( drawFrame() )
+    {
+      if ( mPaletteChanged )
+      {
+        mVideoSink->newPalette( mPalette );
+        mPaletteChanged = false;
+      }
+      mRowPtr = mVideoSink->getRow( mDisplayRow );
+      mPackedRowPtr = mVideoSink->getPackedRow( mDisplayRow );
+    }
+    else
+    {
+      //DMA goes on as usual, fetched data is just not converted
+      mRowPtr = nullptr;
+      mPackedRowPtr = nullptr;
+    }
     mRowStartTick = tick + mDMAOffset;
     if ( mDMAEnable )
     {
@@ -81,6 +206,9 @@ void DisplayGenerator::setColorReg( uint64_t tick, uint8_t reg, uint8_t value )
 {
   flushDisplay( tick );
 
+  uint8_t registerValue = reg < 16 ? value & 0x0f : value;
+  mPaletteChanged |= mPalette[reg] != registerValue;
+
   if ( reg < 16 )
   {
     mPalette[reg] = value & 0x0f;
@@ -98,6 +226,7 @@ void DisplayGenerator::setColorReg( uint64_t tick, uint8_t reg, uint8_t value )
     {
       mDoublets[i].right.g = g;
     }
+    mGreen[regLo] = g;
   }
   else
   {
@@ -120,6 +249,8 @@ void DisplayGenerator::setColorReg( uint64_t tick, uint8_t reg, uint8_t value )
       mDoublets[i].right.b = b;
       mDoublets[i].right.r = r;
     }
+    mBlue[regLo] = b;
+    mRed[regLo] = r;
   }
 }
 
@@ -133,16 +264,47 @@ std::span<uint8_t const, 32> DisplayGenerator::debugPalette() const
   return std::span<uint8_t const, 32>( mPalette.data(), mPalette.size() );
 }
 
+void DisplayGenerator::updateChannels()
+{
+  for ( size_t i = 0; i < 16; ++i )
+  {
+    mBlue[i] = mDoublets[i << 4].left.b;
+    mGreen[i] = mDoublets[i << 4].left.g;
+    mRed[i] = mDoublets[i << 4].left.r;
+  }
+}
+
 void DisplayGenerator::flushDisplay( uint64_t tick )
 {
-  if ( tick > mRowStartTick )
+  if ( tick <= mRowStartTick )
+    return;
+
+  uint32_t limit = ( std::min )( ROW_BYTES, ( uint32_t )( tick - mRowStartTick ) / ( ( uint32_t )TICKS_PER_BYTE ) );
+  if ( mEmittedRowDoublets >= limit )
+    return;
+
+  //palette writes flush the display first, so the whole range is drawn with the current palette
+  //NOTICE - pixels are processed in byte pairs, so in this implementation it is not possible to alter color register between nibbles of a screen byte
+  uint8_t const* src = std::bit_cast< uint8_t const* >( mDMAData.data() ) + mEmittedRowDoublets;
+  size_t count = limit - mEmittedRowDoublets;
+
+  if ( mRowPtr )
   {
-    for ( uint32_t limit = ( std::min )( ROW_BYTES, ( uint32_t )( tick - mRowStartTick ) / ( ( uint32_t )TICKS_PER_BYTE ) ); mEmittedRowDoublets < limit; ++mEmittedRowDoublets )
+    size_t done = expandChunks( src, count, mRowPtr, mBlue.data(), mGreen.data(), mRed.data() );
+    for ( size_t i = done; i < count; ++i )
     {
-      //NOTICE - pixels are processed in byte pairs, so in this implementation it is not possible to alter color register between nibbles of a screen byte
-      *mRowPtr++ = mDoublets[std::bit_cast< uint8_t const* >( mDMAData.data() )[mEmittedRowDoublets]];
+      mRowPtr[i] = mDoublets[src[i]];
     }
+    mRowPtr += count;
+  }
+
+  if ( mPackedRowPtr )
+  {
+    std::copy_n( src, count, mPackedRowPtr );
+    mPackedRowPtr += count;
   }
+
+  mEmittedRowDoublets = limit;
 }
 
 bool DisplayGenerator::rest() const
@@ -4,6 +4,7 @@
 #include "Utility.hpp"
 
 struct IVideoSink;
+class StateStream;
 
 class DisplayGenerator : public RestProvider
 {
@@ -27,6 +28,8 @@ public:
   ~DisplayGenerator() override = default;
   void dispCtl( bool dispColor, bool dispFlip, bool dmaEnable );
   void setPBKUP( uint8_t value );
+  //only every interval-th frame is drawn, DMA timing is not affected
+  void setDrawInterval( uint32_t interval );
 
   void vblank( uint64_t tick );
   DMARequest hblank( uint64_t tick, int row );
@@ -39,12 +42,20 @@ public:
 
   bool rest() const override;
 
+  void serialize( StateStream & stream );
+
 private:
   void flushDisplay( uint64_t tick );
+  bool drawFrame() const;
+  void updateChannels();
 
 private:
 
   std::array<Doublet, 256> mDoublets;
+  //colour of each pen by channel for the vector row expansion
+  std::array<uint8_t, 16> mBlue;
+  std::array<uint8_t, 16> mGreen;
+  std::array<uint8_t, 16> mRed;
   std::array<uint8_t, 32> mPalette;
   std::array<uint64_t,10> mDMAData;
   std::shared_ptr<IVideoSink> mVideoSink;
@@ -58,6 +69,11 @@ private:
   bool mDMAEnable;
   int mDMAOffset;
   Doublet* mRowPtr;
+  uint8_t* mPackedRowPtr;
+  bool mPaletteChanged;
+  bool mRowActive;
+  uint32_t mDrawInterval;
+  uint32_t mFrameCount;
 
   static constexpr uint64_t DMA_FETCH_SIZE = 8;
   static constexpr uint64_t TICKS_PER_PIXEL = 12;
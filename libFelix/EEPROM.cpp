@@ -1,9 +1,10 @@
 #include "EEPROM.hpp"
 #include "ImageProperties.hpp"
 #include "TraceHelper.hpp"
+#include "StateStream.hpp"
 
-EEPROM::EEPROM( std::filesystem::path imagePath, int eeType, bool is16Bit, std::shared_ptr<TraceHelper> traceHelper ) : mEECoroutine{}, mImagePath{ std::move( imagePath ) },
-  mTraceHelper{ std::move( traceHelper ) }, mData{}, mOpcodeBits{}, mAddressMask{}, mDataBits{}, mWriteEnable{}, mChanged{ true }
+EEPROM::EEPROM( std::filesystem::path imagePath, int eeType, bool is16Bit, std::shared_ptr<TraceHelper> traceHelper ) : io{}, mImagePath{ std::move( imagePath ) },
+  mTraceHelper{ std::move( traceHelper ) }, mData{}, mOpcodeBits{}, mAddressMask{}, mDataBits{}, mWriteEnable{}, mChanged{ true }, mPhase{ Phase::IDLE }, mBit{}, mOpcode{}, mWord{}
 {
   assert( eeType > 0 && eeType < 6 );
 
@@ -99,15 +100,15 @@ void EEPROM::tick( uint64_t tick, bool cs, bool audin )
         io.currentTick = tick;
         io.input = audin;
 
-        mEECoroutine();
+        clock();
       }
     }
     else
     {
-      if ( (bool)mEECoroutine )
+      if ( mPhase != Phase::IDLE )
       {
         mTraceHelper->comment<"EEPROM: /CS.">( );
-        mEECoroutine.reset();
+        mPhase = Phase::IDLE;
       }
       io.cs = false;
     }
@@ -117,7 +118,9 @@ void EEPROM::tick( uint64_t tick, bool cs, bool audin )
     if ( io.busyUntil < tick )
     {
       mTraceHelper->comment<"EEPROM: begin.">();
-      mEECoroutine = process();
+      mPhase = Phase::OPCODE;
+      mBit = 0;
+      mOpcode = 0;
       io.output = {};
     }
     io.cs = true;
@@ -137,21 +140,62 @@ std::optional<bool> EEPROM::output( uint64_t tick ) const
   }
 }
 
-EEPROM::EECoroutine EEPROM::process()
+void EEPROM::serialize( StateStream & stream )
 {
-  int opcode = 0;
-  for ( int i = 0; i < mOpcodeBits; ++i )
+  stream( io.currentTick, io.busyUntil, io.cs, io.input, io.output, mData, mWriteEnable, mChanged, mPhase, mBit, mOpcode, mWord );
+}
+
+void EEPROM::clock()
+{
+  int const bit = io.input ? 1 : 0;
+
+  switch ( mPhase )
   {
-    opcode <<= 1;
-    int bit = co_await io;
-    opcode |= bit;
-    mTraceHelper->comment<"EEPROM: fetch opcode bit {}={}.">( mOpcodeBits - i - 1, bit );
+  case Phase::OPCODE:
+    mOpcode = ( mOpcode << 1 ) | bit;
+    mTraceHelper->comment<"EEPROM: fetch opcode bit {}={}.">( mOpcodeBits - mBit - 1, bit );
+    if ( ++mBit == mOpcodeBits )
+      execute();
+    break;
+  case Phase::DATA:
+    mWord = ( mWord << 1 ) | bit;
+    mTraceHelper->comment<"EEPROM: fetch data bit {}={}.">( mDataBits - mBit - 1, bit );
+    if ( ++mBit == mDataBits )
+    {
+      if ( ( mOpcode >> ( mOpcodeBits - 2 ) ) == 0b01 )
+        write( mOpcode & mAddressMask, mWord );
+      else
+        wral( mWord );
+      finish( true );
+    }
+    break;
+  case Phase::READ:
+    if ( mBit == mDataBits )
+    {
+      finish( std::nullopt );
+    }
+    else
+    {
+      if ( mBit == 0 )
+        mWord = read( mOpcode & mAddressMask );
+      int out = ( mWord >> ( mDataBits - mBit - 1 ) ) & 1;
+      mTraceHelper->comment<"EEPROM: emit data bit {}={}.">( mDataBits - mBit - 1, out );
+      io.output = out != 0;
+      ++mBit;
+    }
+    break;
+  default:
+    break;
   }
+}
 
-  int cmd = opcode >> ( mOpcodeBits - 2 );
-  int address = opcode & mAddressMask;
-  int data = 0;
-  int dataBits = mDataBits;
+//decodes the opcode once all its bits are in and either executes it or starts the data phase
+void EEPROM::execute()
+{
+  int cmd = mOpcode >> ( mOpcodeBits - 2 );
+  int address = mOpcode & mAddressMask;
+  mBit = 0;
+  mWord = 0;
 
   switch ( cmd )
   {
@@ -162,14 +206,8 @@ EEPROM::EECoroutine EEPROM::process()
       ewds();
       break;
     case 0b01:  //WRAL
-      for ( int i = 0; i < dataBits; ++i )
-      {
-        data <<= 1;
-        int bit = co_await io;
-        data |= bit;
-      }
-      wral( data );
-      co_return true; 
+      mPhase = Phase::DATA;
+      return;
     case 0b10: //ERAL
       eral();
       break;
@@ -179,31 +217,27 @@ EEPROM::EECoroutine EEPROM::process()
     }
     break;
   case 0b01: //WRITE
-    for ( int i = 0; i < dataBits; ++i )
-    {
-      data <<= 1;
-      int bit = co_await io;
-      data |= bit;
-      mTraceHelper->comment<"EEPROM: fetch data bit {}={}.">( dataBits - i - 1, bit );
-    }
-    write( address, data );
-    co_return true;
+    mPhase = Phase::DATA;
+    return;
   case 0b10: //READ
-    co_yield 0;
-    data = read( address );
-    for ( int i = 0; i < dataBits; ++i )
-    {
-      int bit = ( data >> ( dataBits - i - 1 ) ) & 1;
-      mTraceHelper->comment<"EEPROM: emit data bit {}={}.">( dataBits - i - 1, bit );
-      co_yield bit;
-    }
-    break;
+    //dummy zero bit before the data
+    io.output = false;
+    mPhase = Phase::READ;
+    return;
   case 0b11: //ERASE
     erase( address );
-    co_return true;
+    finish( true );
+    return;
   }
 
-  co_return std::nullopt;
+  finish( std::nullopt );
+}
+
+void EEPROM::finish( std::optional<bool> output )
+{
+  mTraceHelper->comment< "EEPROM: end." >();
+  io.output = output;
+  mPhase = Phase::IDLE;
 }
 
 int EEPROM::read( int address ) const
@@ -361,8 +395,3 @@ void EEPROM::startProgram( uint64_t duration )
   io.busyUntil = io.currentTick + WRITE_TICKS;
   io.output = true;
 }
-void EEPROM::EECoroutine::promise_type::return_value( std::optional<bool> opt )
-{
-  mEE.mTraceHelper->comment< "EEPROM: end." >();
-  mEE.io.output = opt;
-}
@@ -4,6 +4,7 @@
 class ImageCart;
 class TraceHelper;
 class ImageProperties;
+class StateStream;
 
 class EEPROM
 {
@@ -17,18 +18,21 @@ public:
   void tick( uint64_t tick, bool cs, bool audin );
   std::optional<bool> output( uint64_t tick ) const;
 
+  void serialize( StateStream & stream );
+
 private:
 
-  struct NoCS {};
+  //serial command decoder advanced by one bit on every clock, it is plain state so that it is saved in the middle of a command
+  enum class Phase : uint8_t
+  {
+    IDLE,
+    OPCODE,
+    DATA,
+    READ
+  };
 
   struct IO
   {
-    bool await_ready() { return false; }
-    void await_suspend( std::coroutine_handle<> c ) {}
-    int await_resume()
-    {
-      return input ? 1 : 0;
-    }
     uint64_t currentTick;
     uint64_t busyUntil;
     bool cs;
@@ -45,90 +49,11 @@ private:
   void ewds();
 
   void startProgram( uint64_t duration );
-
-  struct EECoroutine : private NonCopyable
-  {
-  public:
-    struct promise_type;
-    using handle = std::coroutine_handle<promise_type>;
-
-    struct promise_type
-    {
-      promise_type( EEPROM& ee ) : mEE{ ee }
-      {
-      }
-      auto get_return_object()
-      {
-        return EECoroutine{ std::coroutine_handle<promise_type>::from_promise( *this ) };
-      }
-      auto initial_suspend()
-      {
-        return std::suspend_never{};
-      }
-      void return_value( std::optional<bool> opt );
-      void unhandled_exception()
-      {
-        std::terminate();
-      }
-      auto final_suspend() noexcept
-      {
-        return std::suspend_always{};
-      }
-      auto& yield_value( int value )
-      {
-        mEE.io.output = value;
-        return mEE.io;
-      }
-
-    private:
-      EEPROM& mEE;
-    };
-
-    EECoroutine() : mCoro{} {}
-    EECoroutine( handle c ) : mCoro{ c } {}
-    EECoroutine & operator=( EECoroutine&& other )
-    {
-      std::swap( mCoro, other.mCoro );
-      return *this;
-    }
-
-    ~EECoroutine()
-    {
-      reset();
-    }
-
-    void operator()()
-    {
-      if ( mCoro )
-      {
-        mCoro();
-        if ( mCoro.done() )
-        {
-          mCoro.destroy();
-          mCoro = nullptr;
-        }
-      }
-    }
-
-    explicit operator bool() const
-    {
-      return (bool)mCoro;
-    }
-
-    void reset()
-    {
-      if ( mCoro )
-        mCoro.destroy();
-      mCoro = nullptr;
-    }
-
-  private:
-    handle mCoro;
-  } mEECoroutine;
-
+  void clock();
+  void execute();
+  void finish( std::optional<bool> output );
 
   private:
-    EECoroutine process();
     std::filesystem::path mImagePath;
     std::shared_ptr<TraceHelper> mTraceHelper;
     std::vector<uint8_t> mData;
@@ -137,6 +62,10 @@ private:
     int mDataBits;
     bool mWriteEnable;
     bool mChanged;
+    Phase mPhase;
+    int mBit;       //bits received or emitted in the current phase
+    int mOpcode;
+    int mWord;      //data word being shifted in or out
 
     static constexpr uint64_t WRITE_TICKS = 10 * 16;
     static constexpr uint64_t ERAL_TICKS = 15 * 16;
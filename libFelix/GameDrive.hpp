@@ -53,44 +53,45 @@ private:
 
   struct Buffer
   {
-    bool await_ready() { return false; }
-    void await_suspend( std::coroutine_handle<> c ) {}
-    void await_resume() {}
     uint8_t value;
     bool ready;
   } mBuffer;
 
-  auto& getByte()
+  //awaiters only refer to the buffer so they can be freely copied by the compiler (gcc https://gcc.gnu.org/bugzilla/show_bug.cgi?id=99575)
+  struct BufferAwaiter
+  {
+    Buffer & buffer;
+
+    bool await_ready() { return false; }
+    void await_suspend( std::coroutine_handle<> c ) {}
+    void await_resume() {}
+  };
+
+  auto getByte()
   {
-    struct GetByte : public Buffer
+    struct GetByte : public BufferAwaiter
     {
-      uint8_t await_resume() { return value; }
+      uint8_t await_resume() { return buffer.value; }
     };
     mReadTick = std::nullopt;
     mBuffer.ready = true;
-    return static_cast<GetByte&>( mBuffer );
+    return GetByte{ mBuffer };
   }
 
-  auto& putResult( FRESULT value, uint64_t latency = 0 )
+  auto putResult( FRESULT value, uint64_t latency = 0 )
   {
-    struct PutResult : public Buffer
-    {
-    };
     mLastTick += latency;
     mReadTick = mLastTick;
     mBuffer.value = (uint8_t)value;
-    return static_cast<PutResult&>( mBuffer );
+    return BufferAwaiter{ mBuffer };
   }
 
-  auto& putByte( uint8_t value, uint64_t latency = 0 )
+  auto putByte( uint8_t value, uint64_t latency = 0 )
   {
-    struct PutByte : public Buffer
-    {
-    };
     mLastTick += latency;
     mReadTick = mLastTick;
     mBuffer.value = value;
-    return static_cast<PutByte&>( mBuffer );
+    return BufferAwaiter{ mBuffer };
   }
 
   struct GDCoroutine : private NonCopyable
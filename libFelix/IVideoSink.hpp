@@ -7,7 +7,22 @@ struct IVideoSink
   virtual ~IVideoSink() = default;
 
   virtual void newFrame() = 0;
+  //Called instead of newFrame for frames not drawn in turbo mode, no rows were requested for them
+  virtual void skipFrame()
+  {
+  }
   //row counts from 0 to 101
   virtual Doublet* getRow( int row ) = 0;
+  //Optional row of raw display bytes, two 4 bit pen numbers per byte with the left pixel in the high nibble.
+  //Sinks doing their own palette lookup may return nullptr from getRow to skip the expansion to pixels
+  virtual uint8_t* getPackedRow( int /*row*/ )
+  {
+    return nullptr;
+  }
+  //Colour registers (16 green, 16 blue-red) for packed rows requested from now on, sent before a row only if they changed since the previous call.
+  //Changes in the middle of a row show up from the next row
+  virtual void newPalette( std::span<uint8_t const, 32> /*palette*/ )
+  {
+  }
 };
 
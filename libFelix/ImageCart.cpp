@@ -1,16 +1,33 @@
 #include "ImageCart.hpp"
 #include "ImageProperties.hpp"
 #include "Encryption.hpp"
-
+#include "MappedFile.hpp"
+
 std::shared_ptr<ImageCart const> ImageCart::create( std::vector<uint8_t>& data )
 {
-  if ( auto pLnx = createLnx( data ) )
+  if ( isLnx( data ) )
+  {
+    return std::make_shared<ImageCart const>( std::move( data ), nullptr, TagLnx{} );
+  }
+  else if ( isLyx( data ) )
+  {
+    return std::make_shared<ImageCart const>( std::move( data ), nullptr, TagLyx{} );
+  }
+  else
+  {
+    return {};
+  }
+}
+
+std::shared_ptr<ImageCart const> ImageCart::create( std::shared_ptr<MappedFile const> const& file )
+{
+  if ( isLnx( file->data() ) )
   {
-    return pLnx;
+    return std::make_shared<ImageCart const>( std::vector<uint8_t>{}, file, TagLnx{} );
   }
-  else if ( auto pLyx = createLyx( data ) )
+  else if ( isLyx( file->data() ) )
   {
-    return pLyx;
+    return std::make_shared<ImageCart const>( std::vector<uint8_t>{}, file, TagLyx{} );
   }
   else
   {
@@ -18,8 +35,8 @@ std::shared_ptr<ImageCart const> ImageCart::create( std::vector<uint8_t>& data )
   }
 }
 
-ImageCart::ImageCart( std::vector<uint8_t> data, TagLnx lnx ) : mData{ std::move( data ) },
-  mBank0{}, mBank0A{}, mBank1{}, mBank1A{}, mHeader{ (Header const*)mData.data() }
+ImageCart::ImageCart( std::vector<uint8_t> data, std::shared_ptr<MappedFile const> file, TagLnx lnx ) : mOwnedData{ std::move( data ) }, mFile{ std::move( file ) },
+  mData{ mFile ? mFile->data() : std::span<uint8_t const>{ mOwnedData } }, mBank0{}, mBank0A{}, mBank1{}, mBank1A{}, mHeader{ (Header const*)mData.data() }
 {
   auto const* pImageData = mData.data() + sizeof( Header );
   size_t imageDataSize = mData.size() - sizeof( Header );
@@ -43,8 +60,8 @@ ImageCart::ImageCart( std::vector<uint8_t> data, TagLnx lnx ) : mData{ std::move
     mBank1A = { std::span<uint8_t const>{ pImageData + bank1AOffset, bank1ASize }, (uint32_t)mHeader->pageSizeBank1 * 256 };
 }
 
-ImageCart::ImageCart( std::vector<uint8_t> data, TagLyx lyx ) : mData{ std::move( data ) },
-  mBank0{ std::span<uint8_t const>( mData.data(), mData.size() ) }, mBank0A{}, mBank1{}, mBank1A{}, mHeader{}
+ImageCart::ImageCart( std::vector<uint8_t> data, std::shared_ptr<MappedFile const> file, TagLyx lyx ) : mOwnedData{ std::move( data ) }, mFile{ std::move( file ) },
+  mData{ mFile ? mFile->data() : std::span<uint8_t const>{ mOwnedData } }, mBank0{ mData }, mBank0A{}, mBank1{}, mBank1A{}, mHeader{}
 {
 }
 
@@ -68,46 +85,42 @@ CartBank ImageCart::getBank1A() const
   return mBank1A;
 }
 
-std::shared_ptr<ImageCart const> ImageCart::createLyx( std::vector<uint8_t>& data )
+bool ImageCart::isLyx( std::span<uint8_t const> data )
 {
+  switch ( data.size() )
+  {
+  case 64 * 1024:
+  case 128 * 1024:
+  case 256 * 1024:
+  case 512 * 1024:
+    break;
+  default:
+    return false;
+  }
+
   // First byte of loader has two's complement of number of blocks in first frame. 
   size_t blockcount = 0x100 - data[0];
 
   // If value is greater than 5 it is not a correct header
   if ( blockcount > 5 )
   {
-    return {};
+    return false;
   }
 
-  auto plain = decrypt( blockcount, std::span<uint8_t const>{ data.data() + 1, 51 * blockcount } );
+  auto plain = decrypt( blockcount, data.subspan( 1, 51 * blockcount ) );
 
-  if ( plain.empty() )
-    return {}; //not a valid cartridge image if decryption failed
-
-  switch ( data.size() )
-  {
-  case 64 * 1024:
-  case 128 * 1024:
-  case 256 * 1024:
-  case 512 * 1024:
-    return std::make_shared<ImageCart const>( std::move( data ), TagLyx{} );
-  default:
-    return {};
-  }
+  //not a valid cartridge image if decryption failed
+  return !plain.empty();
 }
 
-std::shared_ptr<ImageCart const> ImageCart::createLnx( std::vector<uint8_t>& data )
+bool ImageCart::isLnx( std::span<uint8_t const> data )
 {
+  if ( data.size() < sizeof( Header ) )
+    return false;
+
   auto const* pHeader = (Header const*)data.data();
 
-  if ( pHeader->magic[0] == 'L' && pHeader->magic[1] == 'Y' && pHeader->magic[2] == 'N' && pHeader->magic[3] == 'X' && pHeader->version == 1 )
-  {
-    return std::make_shared<ImageCart const>( std::move( data ), TagLnx{} );
-  }
-  else
-  {
-    return {};
-  }
+  return pHeader->magic[0] == 'L' && pHeader->magic[1] == 'Y' && pHeader->magic[2] == 'N' && pHeader->magic[3] == 'X' && pHeader->version == 1;
 }
 
 void ImageCart::populate( ImageProperties & imageProperties ) const
@@ -3,6 +3,7 @@
 #include "CartBank.hpp"
 
 class ImageProperties;
+class MappedFile;
 
 class ImageCart
 {
@@ -27,9 +28,12 @@ public:
   };
 
   static std::shared_ptr<ImageCart const> create( std::vector<uint8_t> & data );
+  //image is used in place from the mapped file
+  static std::shared_ptr<ImageCart const> create( std::shared_ptr<MappedFile const> const& file );
 
-  ImageCart( std::vector<uint8_t> data, TagLnx lnx );
-  ImageCart( std::vector<uint8_t> data, TagLyx lyx );
+  //either data or file holds the image
+  ImageCart( std::vector<uint8_t> data, std::shared_ptr<MappedFile const> file, TagLnx lnx );
+  ImageCart( std::vector<uint8_t> data, std::shared_ptr<MappedFile const> file, TagLyx lyx );
 
   CartBank getBank0() const;
   CartBank getBank0A() const;
@@ -40,12 +44,14 @@ public:
 
 private:
 
-  static std::shared_ptr<ImageCart const> createLyx( std::vector<uint8_t> & data );
-  static std::shared_ptr<ImageCart const> createLnx( std::vector<uint8_t> & data );
+  static bool isLyx( std::span<uint8_t const> data );
+  static bool isLnx( std::span<uint8_t const> data );
 
 protected:
 
-  std::vector<uint8_t> const mData;
+  std::vector<uint8_t> const mOwnedData;
+  std::shared_ptr<MappedFile const> const mFile;
+  std::span<uint8_t const> const mData;
   CartBank mBank0;
   CartBank mBank0A;
   CartBank mBank1;
@@ -4,36 +4,38 @@
 #include "Utility.hpp"
 #include "ImageProperties.hpp"
 #include "Log.hpp"
+#include "MappedFile.hpp"
 
 InputFile::InputFile( std::filesystem::path const & path, std::shared_ptr<ImageProperties> & imageProperties ) : mType{}, mBS93{}, mCart{}
 {
-  auto data = readFile( path );
+  if ( auto file = MappedFile::open( path ) )
+  {
+    if ( auto pCart = ImageCart::create( file ) )
+    {
+      bool propsReset = resetProperties( path, imageProperties );
+      setCart( std::move( pCart ), *imageProperties, propsReset );
+      return;
+    }
+  }
 
-  if ( data.empty() )
-    return;
+  load( path, readFile( path ), imageProperties );
+}
 
-  bool propsReset = false;
+InputFile::InputFile( std::filesystem::path const& path, std::vector<uint8_t> data, std::shared_ptr<ImageProperties>& imageProperties ) : mType{}, mBS93{}, mCart{}
+{
+  load( path, std::move( data ), imageProperties );
+}
 
-  if ( imageProperties && imageProperties->getPath() != path )
-  {
-    imageProperties.reset();
-  }
+void InputFile::load( std::filesystem::path const& path, std::vector<uint8_t> data, std::shared_ptr<ImageProperties>& imageProperties )
+{
+  if ( data.empty() )
+    return;
 
-  if ( !imageProperties )
-  {
-    imageProperties = std::make_shared<ImageProperties>( path );
-    propsReset = true;
-  }
+  bool propsReset = resetProperties( path, imageProperties );
 
   if ( auto pCart = ImageCart::create( data ) )
   {
-    if ( propsReset )
-    {
-      pCart->populate( *imageProperties );
-    }
-
-    mType = FileType::CART;
-    mCart = std::move( pCart );
+    setCart( std::move( pCart ), *imageProperties, propsReset );
     return;
   }
   else if ( auto pBS93 = ImageBS93::create( data ) )
@@ -44,6 +46,33 @@ InputFile::InputFile( std::filesystem::path const & path, std::shared_ptr<ImageP
   }
 }
 
+void InputFile::setCart( std::shared_ptr<ImageCart const> cart, ImageProperties & imageProperties, bool propsReset )
+{
+  if ( propsReset )
+  {
+    cart->populate( imageProperties );
+  }
+
+  mType = FileType::CART;
+  mCart = std::move( cart );
+}
+
+bool InputFile::resetProperties( std::filesystem::path const& path, std::shared_ptr<ImageProperties>& imageProperties )
+{
+  if ( imageProperties && imageProperties->getPath() != path )
+  {
+    imageProperties.reset();
+  }
+
+  if ( !imageProperties )
+  {
+    imageProperties = std::make_shared<ImageProperties>( path );
+    return true;
+  }
+
+  return false;
+}
+
 bool InputFile::valid() const
 {
   return mType != FileType::UNKNOWN;
@@ -14,7 +14,12 @@ public:
     CART,
   };
 
+  //Cartridge images are used in place from the memory mapped file, other files are read into memory.
+  //The file must not be truncated or rewritten in place while the image is in use, rebuilding it has to replace the file (write and rename)
+  //or the emulator crashes with SIGBUS on POSIX. A replaced file is mapped anew when opened again.
   InputFile( std::filesystem::path const& path, std::shared_ptr<ImageProperties> & imageProperties );
+  //image already in memory. path is used only to identify image properties
+  InputFile( std::filesystem::path const& path, std::vector<uint8_t> data, std::shared_ptr<ImageProperties>& imageProperties );
 
   bool valid() const;
   FileType getType() const;
@@ -22,6 +27,11 @@ public:
   std::shared_ptr<ImageBS93 const> getBS93() const;
   std::shared_ptr<ImageCart const> getCart() const;
 
+private:
+  void load( std::filesystem::path const& path, std::vector<uint8_t> data, std::shared_ptr<ImageProperties>& imageProperties );
+  void setCart( std::shared_ptr<ImageCart const> cart, ImageProperties & imageProperties, bool propsReset );
+  static bool resetProperties( std::filesystem::path const& path, std::shared_ptr<ImageProperties>& imageProperties );
+
 private:
   FileType mType;
   std::shared_ptr<ImageBS93 const> mBS93;
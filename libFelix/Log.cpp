@@ -1,4 +1,14 @@
 #include "Log.hpp"
+#include <cstdio>
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#endif
+
+namespace
+{
+thread_local Log::ThreadSink* tSink = nullptr;
+}
 
 Log::Log() : mLogLevel{ LL_INFO }
 {
@@ -6,12 +16,12 @@ Log::Log() : mLogLevel{ LL_INFO }
 
 void Log::setLogLevel( LogLevel ll )
 {
-  mLogLevel = ll;
+  mLogLevel.store( ll, std::memory_order_relaxed );
 }
 
 void Log::log( LogLevel ll, std::string const & message )
 {
-  if ( ll >= mLogLevel )
+  if ( ll >= mLogLevel.load( std::memory_order_relaxed ) )
   {
     //static bool err = false;
     //if ( ll >= LL_ERROR )
@@ -32,8 +42,15 @@ void Log::log( LogLevel ll, std::string const & message )
     //  std::cout << message;
     //  err = false;
     //}
+    if ( tSink )
+    {
+      tSink->mSink( ll, message );
+      return;
+    }
 #ifdef _WIN32
     OutputDebugStringA( message.c_str() );
+#else
+    std::fputs( message.c_str(), stderr );
 #endif
   }
 }
@@ -44,6 +61,16 @@ Log & Log::instance()
   return instance;
 }
 
+Log::ThreadSink::ThreadSink( std::function<void( LogLevel, std::string const& )> sink ) : mSink{ std::move( sink ) }, mPrevious{ tSink }
+{
+  tSink = this;
+}
+
+Log::ThreadSink::~ThreadSink()
+{
+  tSink = mPrevious;
+}
+
 Formatter::Formatter( Log::LogLevel ll ) : mLl{ ll }, mSS{}
 {
 }
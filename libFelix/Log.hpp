@@ -20,10 +20,28 @@ public:
 
   static Log & instance();
 
+  //while alive, messages logged by the creating thread go to the sink instead of the debug output
+  class ThreadSink
+  {
+  public:
+    ThreadSink( std::function<void( LogLevel, std::string const& )> sink );
+    ~ThreadSink();
+
+    ThreadSink( ThreadSink const& ) = delete;
+    ThreadSink& operator=( ThreadSink const& ) = delete;
+
+  private:
+    friend class Log;
+
+    std::function<void( LogLevel, std::string const& )> mSink;
+    ThreadSink* mPrevious;
+  };
+
 private:
   Log();
 
-  LogLevel mLogLevel;
+  //set by the UI thread while emulation threads log
+  std::atomic<LogLevel> mLogLevel;
 };
 
 class Formatter
@@ -0,0 +1,186 @@
+#include "MappedFile.hpp"
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+
+//tells a rebuilt file from the one mapped before under the same path
+struct Identity
+{
+  uint64_t device;
+  uint64_t index;
+  uint64_t size;
+  int64_t modified;
+
+  bool operator==( Identity const& ) const = default;
+};
+
+#ifdef _WIN32
+
+Identity identify( HANDLE file )
+{
+  BY_HANDLE_FILE_INFORMATION info{};
+  if ( !GetFileInformationByHandle( file, &info ) )
+    return {};
+
+  return {
+    info.dwVolumeSerialNumber,
+    ( (uint64_t)info.nFileIndexHigh << 32 ) | info.nFileIndexLow,
+    ( (uint64_t)info.nFileSizeHigh << 32 ) | info.nFileSizeLow,
+    (int64_t)( ( (uint64_t)info.ftLastWriteTime.dwHighDateTime << 32 ) | info.ftLastWriteTime.dwLowDateTime ) };
+}
+
+bool identify( std::filesystem::path const& path, Identity & identity )
+{
+  HANDLE file = CreateFileW( path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+  if ( file == INVALID_HANDLE_VALUE )
+    return false;
+
+  identity = identify( file );
+  CloseHandle( file );
+  return identity.size > 0;
+}
+
+uint8_t const* mapFile( std::filesystem::path const& path, size_t & size, Identity & identity )
+{
+  HANDLE file = CreateFileW( path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+  if ( file == INVALID_HANDLE_VALUE )
+    return nullptr;
+
+  identity = identify( file );
+  HANDLE mapping = nullptr;
+  if ( identity.size > 0 )
+    mapping = CreateFileMappingW( file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+  CloseHandle( file );
+  if ( !mapping )
+    return nullptr;
+
+  //the view keeps the mapping alive
+  void const* view = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+  CloseHandle( mapping );
+  size = (size_t)identity.size;
+  return (uint8_t const*)view;
+}
+
+void unmapFile( uint8_t const* data, size_t )
+{
+  UnmapViewOfFile( data );
+}
+
+#else
+
+Identity identify( struct stat const& st )
+{
+#ifdef __APPLE__
+  auto const& modified = st.st_mtimespec;
+#else
+  auto const& modified = st.st_mtim;
+#endif
+  return { (uint64_t)st.st_dev, (uint64_t)st.st_ino, (uint64_t)st.st_size, (int64_t)modified.tv_sec * 1000000000 + modified.tv_nsec };
+}
+
+bool identify( std::filesystem::path const& path, Identity & identity )
+{
+  struct stat st{};
+  if ( ::stat( path.c_str(), &st ) != 0 )
+    return false;
+
+  identity = identify( st );
+  return identity.size > 0;
+}
+
+uint8_t const* mapFile( std::filesystem::path const& path, size_t & size, Identity & identity )
+{
+  int fd = ::open( path.c_str(), O_RDONLY );
+  if ( fd < 0 )
+    return nullptr;
+
+  struct stat st{};
+  void* view = MAP_FAILED;
+  if ( fstat( fd, &st ) == 0 && st.st_size > 0 )
+    view = mmap( nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+  ::close( fd );
+  if ( view == MAP_FAILED )
+    return nullptr;
+
+  identity = identify( st );
+  size = (size_t)st.st_size;
+  return (uint8_t const*)view;
+}
+
+void unmapFile( uint8_t const* data, size_t size )
+{
+  munmap( (void*)data, size );
+}
+
+#endif
+
+}
+
+std::shared_ptr<MappedFile const> MappedFile::open( std::filesystem::path const& path )
+{
+  struct Entry
+  {
+    Identity identity;
+    std::weak_ptr<MappedFile const> file;
+  };
+
+  static std::mutex mutex;
+  static std::unordered_map<std::filesystem::path::string_type, Entry> mapped;
+
+  std::error_code ec;
+  auto canonical = std::filesystem::canonical( path, ec );
+  if ( ec )
+    return {};
+
+  std::scoped_lock lock{ mutex };
+
+  //mappings nobody uses any more
+  std::erase_if( mapped, []( auto const& entry )
+  {
+    return entry.second.file.expired();
+  } );
+
+  Identity identity{};
+  if ( !identify( canonical, identity ) )
+    return {};
+
+  if ( auto it = mapped.find( canonical.native() ); it != mapped.end() && it->second.identity == identity )
+  {
+    if ( auto file = it->second.file.lock() )
+      return file;
+  }
+
+  //a rebuilt file gets a new mapping, instances still running keep the old one
+  size_t size{};
+  if ( auto data = mapFile( canonical, size, identity ) )
+  {
+    std::shared_ptr<MappedFile const> file{ new MappedFile{ data, size } };
+    mapped.insert_or_assign( canonical.native(), Entry{ identity, file } );
+    return file;
+  }
+
+  return {};
+}
+
+MappedFile::MappedFile( uint8_t const* data, size_t size ) : mData{ data }, mSize{ size }
+{
+}
+
+MappedFile::~MappedFile()
+{
+  unmapFile( mData, mSize );
+}
+
+std::span<uint8_t const> MappedFile::data() const
+{
+  return { mData, mSize };
+}
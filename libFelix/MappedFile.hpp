@@ -0,0 +1,24 @@
+#pragma once
+
+//Whole file mapped read only into memory.
+//Opening the same unchanged file again while it is mapped returns the same mapping, other processes share the pages through the OS file cache.
+//A file that has been replaced since gets a new mapping. A file truncated in place while mapped makes reading the lost pages fail with SIGBUS on POSIX.
+class MappedFile
+{
+public:
+  //nullptr if the file can't be mapped or is empty
+  static std::shared_ptr<MappedFile const> open( std::filesystem::path const& path );
+
+  MappedFile( MappedFile const& ) = delete;
+  MappedFile& operator=( MappedFile const& ) = delete;
+  ~MappedFile();
+
+  std::span<uint8_t const> data() const;
+
+private:
+  MappedFile( uint8_t const* data, size_t size );
+
+private:
+  uint8_t const* mData;
+  size_t mSize;
+};
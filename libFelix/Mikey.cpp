@@ -6,115 +6,47 @@
 #include "CPU.hpp"
 #include "ComLynx.hpp"
 #include "VGMWriter.hpp"
+#include "StateStream.hpp"
 
-Mikey::Mikey( Core & core, ComLynx & comLynx, std::shared_ptr<IVideoSink> videoSink ) : mCore{ core }, mComLynx{ comLynx }, mAccessTick{}, mTimers{}, mAudioChannels{},
-  mAttenuation{ 0x00, 0x00, 0x00, 0x00 }, mAttenuationLeft{ 0x00, 0x00, 0x00, 0x00 }, mAttenuationRight{ 0x00, 0x00, 0x00, 0x00 }, mDisplayGenerator{ std::make_unique<DisplayGenerator>( std::move( videoSink ) ) },
-  mParallelPort{ mCore, mComLynx, *mDisplayGenerator }, mDisplayRegs{}, mSuzyDone{}, mPan{ 0x00 }, mStereo{ 0x00 }, mSerDat{}, mIRQ{}, mVGMWriterMutex{}
+Mikey::Mikey( Core & core, ComLynx & comLynx, std::shared_ptr<IVideoSink> videoSink ) : mCore{ core }, mComLynx{ comLynx }, mAccessTick{},
+  mTimers{ TimerCore{ 0x0 }, TimerCore{ 0x1 }, TimerCore{ 0x2 }, TimerCore{ 0x3 }, TimerCore{ 0x4 }, TimerCore{ 0x5 }, TimerCore{ 0x6 }, TimerCore{ 0x7 },
+    TimerCore{ 0x8 }, TimerCore{ 0x9 }, TimerCore{ 0xa }, TimerCore{ 0xb } }, mAudioChannels{}, mLazyAudio{}, mLazyAudioEnabled{ true },
+  mAttenuation{ 0x00, 0x00, 0x00, 0x00 }, mAttenuationLeft{ 0x00, 0x00, 0x00, 0x00 }, mAttenuationRight{ 0x00, 0x00, 0x00, 0x00 },
+  mAudioEvents{}, mAudioLevel{}, mRenderedLevel{}, mAudioBase{}, mAudioSPS{}, mAudioSlotEnd{}, mAudioChangeTick{}, mAudioChanged{}, mTurbo{},
+  mBlepPending{}, mBlepBuffer{}, mDisplayGenerator{ std::make_unique<DisplayGenerator>( std::move( videoSink ) ) },
+  mParallelPort{ mCore, mComLynx, *mDisplayGenerator }, mDisplayRegs{}, mSuzyDone{}, mPan{ 0x00 }, mStereo{ 0x00 }, mSerDat{}, mIRQ{}, mVGMWriterMutex{}, mComLynxDormant{}
 {
-  mTimers[0x0] = std::make_unique<TimerCore>( 0x0, [this]( uint64_t tick, bool interrupt )
-  {
-    mTimers[0x2]->borrowIn( tick );
-    uint8_t cnt = mTimers[0x02]->getCount( tick );
-    if ( cnt == 101 )
-    {
-      mDisplayGenerator->updateDispAddr( tick, mDisplayRegs.dispAdr );
-    }
-    mCore.newLine( cnt );
-    if ( auto dma = mDisplayGenerator->hblank( tick, cnt ) )
-    {
-      mCore.requestDisplayDMA( dma.tick, dma.address );
-    }
-    if ( interrupt )
-    {
-      setIRQ( 0x01 );
-    }
-  } );  //timer 0 -> timer 2
-  mTimers[0x1] = std::make_unique<TimerCore>( 0x1, [this]( uint64_t tick, bool interrupt )
-  {
-    mTimers[0x3]->borrowIn( tick );
-    if ( interrupt )
-    {
-      setIRQ( 0x02 );
-    }
-  } );  //timer 1 -> timer 3
-  mTimers[0x2] = std::make_unique<TimerCore>( 0x2, [this]( uint64_t tick, bool interrupt )
-  {
-    mTimers[0x4]->borrowIn( tick );
-    mDisplayGenerator->vblank( tick );
-    if ( interrupt )
-    {
-      setIRQ( 0x04 );
-    }
-  } );  //timer 2 -> timer 4
-  mTimers[0x3] = std::make_unique<TimerCore>( 0x3, [this]( uint64_t tick, bool interrupt )
-  {
-    mTimers[0x5]->borrowIn( tick );
-    if ( interrupt )
-    {
-      setIRQ( 0x08 );
-    }
-  } );  //timer 3 -> timer 5
-  mTimers[0x4] = std::make_unique<TimerCore>( 0x4, [this]( uint64_t tick, bool interrupt )
-  {
-    if ( mComLynx.pulse() )
-    {
-      setIRQ( 0x10 );
-    }
-  } );  //timer 4
-  mTimers[0x5] = std::make_unique<TimerCore>( 0x5, [this]( uint64_t tick, bool interrupt )
-  {
-    mTimers[0x7]->borrowIn( tick );
-    if ( interrupt )
-    {
-      setIRQ( 0x20 );
-    }
-  } );  //timer 5 -> timer 7
-  mTimers[0x6] = std::make_unique<TimerCore>( 0x6, [this]( uint64_t tick, bool interrupt )
-  {
-    if ( interrupt )
-    {
-      setIRQ( 0x40 );
-    }
-  } );  //timer 6
-  mTimers[0x7] = std::make_unique<TimerCore>( 0x7, [this]( uint64_t tick, bool interrupt )
-  {
-    mTimers[0x8]->borrowIn( tick );
-    if ( interrupt )
-    {
-      setIRQ( 0x80 );
-    }
-  } );  //timer 7 -> audio 0
-  mTimers[0x8] = std::make_unique<TimerCore>( 0x8, [this]( uint64_t tick, bool unused )
-  {
-    mAudioChannels[0x0]->trigger( tick );
-    mTimers[0x9]->borrowIn( tick );
-  } );  //audio 0 -> audio 1
-  mTimers[0x9] = std::make_unique<TimerCore>( 0x9, [this]( uint64_t tick, bool unused )
-  {
-    mAudioChannels[0x1]->trigger( tick );
-    mTimers[0xa]->borrowIn( tick );
-  } );  //audio 1 -> audio 2
-  mTimers[0xa] = std::make_unique<TimerCore>( 0xa, [this]( uint64_t tick, bool unused )
-  {
-    mAudioChannels[0x2]->trigger( tick );
-    mTimers[0xb]->borrowIn( tick );
-  } );  //audio 2 -> audio 3
-  mTimers[0xb] = std::make_unique<TimerCore>( 0xb, [this]( uint64_t tick, bool unused )
-  {
-    mAudioChannels[0x3]->trigger( tick );
-    mTimers[0x0]->borrowIn( tick );
-  } );  //audio 3 -> timer 1
-
-  mAudioChannels[0x0] = std::make_unique<AudioChannel>( *mTimers[0x8] );
-  mAudioChannels[0x1] = std::make_unique<AudioChannel>( *mTimers[0x9] );
-  mAudioChannels[0x2] = std::make_unique<AudioChannel>( *mTimers[0xa] );
-  mAudioChannels[0x3] = std::make_unique<AudioChannel>( *mTimers[0xb] );
+  mAudioChannels[0x0] = std::make_unique<AudioChannel>( mTimers[0x8] );
+  mAudioChannels[0x1] = std::make_unique<AudioChannel>( mTimers[0x9] );
+  mAudioChannels[0x2] = std::make_unique<AudioChannel>( mTimers[0xa] );
+  mAudioChannels[0x3] = std::make_unique<AudioChannel>( mTimers[0xb] );
 }
 
 Mikey::~Mikey()
 {
 }
 
+void Mikey::serialize( StateStream & stream )
+{
+  stream( mAccessTick, mAttenuation, mAttenuationLeft, mAttenuationRight, mDisplayRegs, mSuzyDone, mPan, mStereo, mSerDat, mIRQ, mComLynxDormant, mLazyAudio );
+  stream( mAudioEvents, mAudioLevel, mRenderedLevel, mAudioBase, mAudioSPS, mAudioSlotEnd, mAudioChangeTick, mAudioChanged, mBlepPending );
+
+  for ( auto & timer : mTimers )
+  {
+    timer.serialize( stream );
+  }
+  for ( auto & channel : mAudioChannels )
+  {
+    channel->serialize( stream );
+  }
+  mDisplayGenerator->serialize( stream );
+  mParallelPort.serialize( stream );
+
+  //state may come from a core with lazy channels
+  if ( stream.loading() && !mLazyAudioEnabled )
+    wakeAudio();
+}
+
 uint64_t Mikey::requestAccess( uint64_t tick, uint16_t address )
 {
   mAccessTick = tick + 5;
@@ -146,20 +78,28 @@ uint8_t Mikey::read( uint16_t address )
 
   if ( address < 0x20 )
   {
+    if ( ( address >> 2 ) == 0x4 )
+      wakeComLynx();
+    //audio 3 borrows into timer 0
+    else if ( ( address >> 2 ) == 0x0 )
+      catchUpAudio();
+
     switch ( address & 0x3 )
     {
     case TIMER::BACKUP:
-      return mTimers[( address >> 2 ) & 7]->getBackup( mAccessTick );
+      return mTimers[( address >> 2 ) & 7].getBackup( mAccessTick );
     case TIMER::CONTROLA:
-      return mTimers[( address >> 2 ) & 7]->getControlA( mAccessTick );
+      return mTimers[( address >> 2 ) & 7].getControlA( mAccessTick );
     case TIMER::COUNT:
-      return mTimers[( address >> 2 ) & 7]->getCount( mAccessTick );
+      return mTimers[( address >> 2 ) & 7].getCount( mAccessTick );
     case TIMER::CONTROLB:
-      return mTimers[( address >> 2 ) & 7]->getControlB( mAccessTick );
+      return mTimers[( address >> 2 ) & 7].getControlB( mAccessTick );
     }
   }
   else if ( address < 0x40 )
   {
+    catchUpAudio();
+
     switch ( address & 0x7 )
     {
     case AUDIO::VOLCNTRL:
@@ -254,20 +194,31 @@ SequencedAction Mikey::write( uint16_t address, uint8_t value )
 
   if ( address < 0x20 )
   {
+    if ( ( address >> 2 ) == 0x4 )
+      wakeComLynx();
+    //audio 3 borrows into timer 0
+    else if ( ( address >> 2 ) == 0x0 )
+      wakeAudio();
+
     switch ( address & 0x3 )
     {
     case TIMER::BACKUP:
-      return mTimers[(address >> 2) & 7]->setBackup( mAccessTick, value );
+      return mTimers[(address >> 2) & 7].setBackup( mAccessTick, value );
     case TIMER::CONTROLA:
-      return mTimers[( address >> 2 ) & 7]->setControlA( mAccessTick, value );
+      return mTimers[( address >> 2 ) & 7].setControlA( mAccessTick, value );
     case TIMER::COUNT:
-      return mTimers[( address >> 2 ) & 7]->setCount( mAccessTick, value );
+      return mTimers[( address >> 2 ) & 7].setCount( mAccessTick, value );
     case TIMER::CONTROLB:
-      return mTimers[( address >> 2 ) & 7]->setControlB( mAccessTick, value );
+      return mTimers[( address >> 2 ) & 7].setControlB( mAccessTick, value );
     }
   }
   else if ( address < 0x40 )
   {
+    //timer registers can make the channel or the one before observable
+    if ( ( address & 0x7 ) >= AUDIO::BACKUP )
+      wakeAudio();
+    else
+      catchUpAudio();
     {
       std::unique_lock lock( mVGMWriterMutex );
       if ( mVGMWriter )
@@ -282,7 +233,10 @@ SequencedAction Mikey::write( uint16_t address, uint8_t value )
     case AUDIO::FEEDBACK:
       return mAudioChannels[( address >> 3 ) & 3]->setFeedback( value );
     case AUDIO::OUTPUT:
-      return mAudioChannels[( address >> 3 ) & 3]->setOutput( value );
+      audioChanging( mAccessTick );
+      mAudioChannels[( address >> 3 ) & 3]->setOutput( value );
+      audioChanged( mAccessTick );
+      return {};
     case AUDIO::SHIFT:
       return mAudioChannels[( address >> 3 ) & 3]->setShift( value );
     case AUDIO::BACKUP:
@@ -301,9 +255,12 @@ SequencedAction Mikey::write( uint16_t address, uint8_t value )
   case ATTENREG1:
   case ATTENREG2:
   case ATTENREG3:
+    catchUpAudio();
+    audioChanging( mAccessTick );
     mAttenuation[address & 3] = value;
     mAttenuationRight[address & 3] = ( value & 0x0f ) << 2;
     mAttenuationLeft[address & 3] = ( value & 0xf0 ) >> 2;
+    audioChanged( mAccessTick );
     {
       std::unique_lock lock( mVGMWriterMutex );
       if ( mVGMWriter )
@@ -311,7 +268,10 @@ SequencedAction Mikey::write( uint16_t address, uint8_t value )
     }
     break;
   case MPAN:
+    catchUpAudio();
+    audioChanging( mAccessTick );
     mPan = value;
+    audioChanged( mAccessTick );
     {
       std::unique_lock lock( mVGMWriterMutex );
       if ( mVGMWriter )
@@ -319,7 +279,10 @@ SequencedAction Mikey::write( uint16_t address, uint8_t value )
     }
     break;
   case MSTEREO:
+    catchUpAudio();
+    audioChanging( mAccessTick );
     mStereo = value;
+    audioChanged( mAccessTick );
     {
       std::unique_lock lock( mVGMWriterMutex );
       if ( mVGMWriter )
@@ -347,9 +310,11 @@ SequencedAction Mikey::write( uint16_t address, uint8_t value )
     break;
   case SERCTL:
     mComLynx.setCtrl( value );
+    wakeComLynx();
     break;
   case SERDAT:
     mComLynx.setData( value );
+    wakeComLynx();
     break;
   case SDONEACK:
     mSuzyDone = false;
@@ -433,7 +398,102 @@ SequencedAction Mikey::write( uint16_t address, uint8_t value )
 SequencedAction Mikey::fireTimer( uint64_t tick, uint32_t timer )
 {
   assert( timer < 12 );
-  return mTimers[timer]->fireAction( tick );
+  catchUpAudio( { (Action)( (int)Action::FIRE_TIMER0 + timer ), tick } );
+  auto action = runTimer( tick, timer );
+  //pulses of an idle serial port change nothing, timer 4 catches up when it's touched
+  if ( timer == 0x4 && action && mTimers[0x4].period() != 0 && mComLynx.idle() )
+  {
+    mComLynxDormant = true;
+    return {};
+  }
+  //high pitched channels would flood the queue with fires only they see
+  if ( timer >= 0x8 && action && mLazyAudioEnabled && audioUnobserved( timer - 0x8 ) )
+  {
+    mLazyAudio[timer - 0x8] = action;
+    return {};
+  }
+  return action;
+}
+
+SequencedAction Mikey::runTimer( uint64_t tick, int timer )
+{
+  if ( !mTimers[timer].fire( tick ) )
+    return {};
+
+  underflow( tick, timer );
+  mTimers[timer].reload( tick );
+  return mTimers[timer].computeAction();
+}
+
+void Mikey::underflow( uint64_t tick, int timer )
+{
+  //Walks the borrows down the chain. Audio channels change their output before borrowing,
+  //other timers see the rest of the chain done and each timer reloads after the ones it borrowed into.
+  std::array<int, 12> chain;
+  size_t size = 0;
+  for ( int current = timer;; )
+  {
+    chain[size++] = current;
+    if ( current >= 0x8 )
+    {
+      audioChanging( tick );
+      if ( mAudioChannels[current - 0x8]->trigger( tick ) )
+        audioChanged( tick );
+    }
+
+    current = BORROW_TARGET[current];
+    if ( current < 0 || !mTimers[current].borrowIn( tick ) )
+      break;
+  }
+
+  while ( size > 0 )
+  {
+    int const current = chain[--size];
+    if ( current < 0x8 )
+      timerUnderflow( tick, current );
+    //the first one is reloaded by the caller
+    if ( size > 0 )
+      mTimers[current].reload( tick );
+  }
+}
+
+void Mikey::timerUnderflow( uint64_t tick, int timer )
+{
+  switch ( timer )
+  {
+  case 0x0:
+  {
+    uint8_t cnt = mTimers[0x2].getCount( tick );
+    if ( cnt == 101 )
+    {
+      mDisplayGenerator->updateDispAddr( tick, mDisplayRegs.dispAdr );
+    }
+    mCore.newLine( cnt );
+    if ( auto dma = mDisplayGenerator->hblank( tick, cnt ) )
+    {
+      mCore.requestDisplayDMA( dma.tick, dma.address );
+    }
+    break;
+  }
+  case 0x2:
+    mDisplayGenerator->vblank( tick );
+    mCore.newFrame();
+    break;
+  case 0x4:
+    //serial interrupt doesn't depend on timer interrupt enable
+    if ( mComLynx.pulse( tick ) )
+    {
+      setIRQ( 0x10 );
+    }
+    return;
+  default:
+    break;
+  }
+
+  if ( mTimers[timer].interrupt() )
+  {
+    setIRQ( 1 << timer );
+  }
 }
 
 void Mikey::setDMAData( uint64_t tick, uint64_t data )
@@ -449,16 +509,16 @@ void Mikey::suzyDone()
   mSuzyDone = true;
 }
 
-AudioSample Mikey::sampleAudio( uint64_t tick ) const
+AudioSample Mikey::mixAudio() const
 {
   int16_t left{};
   int16_t right{};
   int16_t samples[4];
 
-  samples[0] = (int16_t)mAudioChannels[0]->sample( tick );
-  samples[1] = (int16_t)mAudioChannels[1]->sample( tick );
-  samples[2] = (int16_t)mAudioChannels[2]->sample( tick );
-  samples[3] = (int16_t)mAudioChannels[3]->sample( tick );
+  samples[0] = (int16_t)mAudioChannels[0]->getOutput();
+  samples[1] = (int16_t)mAudioChannels[1]->getOutput();
+  samples[2] = (int16_t)mAudioChannels[2]->getOutput();
+  samples[3] = (int16_t)mAudioChannels[3]->getOutput();
 
   for ( size_t i = 0; i < 4; ++i )
   {
@@ -478,6 +538,209 @@ AudioSample Mikey::sampleAudio( uint64_t tick ) const
   return { left, right };
 }
 
+void Mikey::startAudio( uint64_t base, int sps )
+{
+  catchUpAudio();
+  flushAudio();
+  mAudioBase = base;
+  mAudioSPS = sps;
+}
+
+void Mikey::audioChanging( uint64_t tick )
+{
+  //output is mixed only once per sample period, when a change lands after the period of the previous one
+  if ( mAudioChanged && tick > mAudioSlotEnd )
+    flushAudio();
+}
+
+void Mikey::audioChanged( uint64_t tick )
+{
+  if ( mTurbo )
+    return;
+
+  //register writes are timed at the access tick that can be past a timer fire processed afterwards
+  mAudioChangeTick = std::max( tick, mAudioChangeTick );
+  if ( mAudioChanged )
+    return;
+
+  mAudioChanged = true;
+  //last tick before the sample following the change
+  uint64_t const pos = mAudioChangeTick * mAudioSPS;
+  uint64_t const slot = pos > mAudioBase ? ( pos - mAudioBase - 1 ) / AUDIO_PERIOD : 0;
+  mAudioSlotEnd = mAudioSPS > 0 ? ( mAudioBase + ( slot + 1 ) * AUDIO_PERIOD ) / mAudioSPS : mAudioChangeTick;
+}
+
+void Mikey::flushAudio()
+{
+  if ( !mAudioChanged )
+    return;
+
+  mAudioChanged = false;
+  AudioSample level = mixAudio();
+  if ( level == mAudioLevel )
+    return;
+
+  mAudioLevel = level;
+  mAudioEvents.push_back( { mAudioChangeTick, level } );
+}
+
+void Mikey::renderAudio( std::span<AudioSample> out, uint64_t base, int sps, bool bandLimited )
+{
+  catchUpAudio();
+  if ( mTurbo )
+  {
+    std::fill( out.begin(), out.end(), AudioSample{} );
+    return;
+  }
+
+  flushAudio();
+
+  size_t const size = out.size();
+  if ( bandLimited )
+  {
+    //previous pending sample followed by this batch, steps add polyBLEP residuals to the samples next to them
+    mBlepBuffer.assign( 2 * ( size + 1 ), 0.0f );
+    mBlepBuffer[0] = mBlepPending[0];
+    mBlepBuffer[1] = mBlepPending[1];
+  }
+
+  AudioSample level = mRenderedLevel;
+  size_t begin = 0;
+  size_t consumed = 0;
+  for ( ; consumed < mAudioEvents.size(); ++consumed )
+  {
+    auto const& event = mAudioEvents[consumed];
+    uint64_t const pos = event.tick * sps;
+    //first sample taken at or after the change
+    size_t const end = pos > base ? ( pos - base - 1 ) / AUDIO_PERIOD : 0;
+    if ( end >= size )
+      break;
+
+    std::fill( out.begin() + begin, out.begin() + end, level );
+
+    if ( bandLimited && pos > base )
+    {
+      float const frac = (float)( ( end + 1 ) * AUDIO_PERIOD - ( pos - base ) ) / AUDIO_PERIOD;
+      float const before = frac * frac * 0.5f;
+      float const after = -( 1.0f - frac ) * ( 1.0f - frac ) * 0.5f;
+      float const left = (float)( event.level.left - level.left );
+      float const right = (float)( event.level.right - level.right );
+      mBlepBuffer[2 * end + 0] += before * left;
+      mBlepBuffer[2 * end + 1] += before * right;
+      mBlepBuffer[2 * end + 2] += after * left;
+      mBlepBuffer[2 * end + 3] += after * right;
+    }
+
+    begin = end;
+    level = event.level;
+  }
+  std::fill( out.begin() + begin, out.end(), level );
+  mAudioEvents.erase( mAudioEvents.begin(), mAudioEvents.begin() + consumed );
+  mRenderedLevel = level;
+
+  if ( !bandLimited )
+  {
+    if ( size > 0 )
+      mBlepPending = { (float)level.left, (float)level.right };
+    return;
+  }
+
+  //residuals were added before naive samples are known, so they are accumulated on top
+  float * buf = mBlepBuffer.data();
+  for ( size_t i = 0; i < size; ++i )
+  {
+    buf[2 * i + 2] += out[i].left;
+    buf[2 * i + 3] += out[i].right;
+  }
+  for ( size_t i = 0; i < size; ++i )
+  {
+    out[i].left = (int16_t)std::clamp( std::lrint( buf[2 * i + 0] ), -32768l, 32767l );
+    out[i].right = (int16_t)std::clamp( std::lrint( buf[2 * i + 1] ), -32768l, 32767l );
+  }
+  mBlepPending = { buf[2 * size], buf[2 * size + 1] };
+}
+
+void Mikey::skipAudio( uint64_t tick )
+{
+  catchUpAudio();
+  flushAudio();
+  auto it = std::find_if( mAudioEvents.begin(), mAudioEvents.end(), [=]( AudioEvent const& event )
+  {
+    return event.tick > tick;
+  } );
+  if ( it != mAudioEvents.begin() )
+    mRenderedLevel = std::prev( it )->level;
+  mAudioEvents.erase( mAudioEvents.begin(), it );
+  mBlepPending = { (float)mRenderedLevel.left, (float)mRenderedLevel.right };
+}
+
+void Mikey::setTurbo( uint32_t drawInterval )
+{
+  mDisplayGenerator->setDrawInterval( drawInterval );
+
+  bool turbo = drawInterval > 0;
+  if ( turbo == mTurbo )
+    return;
+
+  //no changes are recorded in turbo mode, rendering continues from the current output
+  catchUpAudio();
+  mTurbo = turbo;
+  mAudioEvents.clear();
+  mAudioChanged = false;
+  mAudioLevel = mixAudio();
+  mRenderedLevel = mAudioLevel;
+  mBlepPending = { (float)mRenderedLevel.left, (float)mRenderedLevel.right };
+}
+
+bool Mikey::audioUnobserved( int channel ) const
+{
+  return mTimers[0x8 + channel].period() != 0 && !mTimers[BORROW_TARGET[0x8 + channel]].linked();
+}
+
+void Mikey::catchUpAudio( SequencedAction limit )
+{
+  for ( ;; )
+  {
+    //earliest lazy fire, limit < fire tells that the queue would execute the fire first
+    int channel = -1;
+    for ( int i = 0; i < 4; ++i )
+    {
+      if ( mLazyAudio[i] && limit < mLazyAudio[i] && ( channel < 0 || mLazyAudio[channel] < mLazyAudio[i] ) )
+        channel = i;
+    }
+    if ( channel < 0 )
+      return;
+
+    //nothing is written meanwhile, so the channel stays lazy
+    mLazyAudio[channel] = runTimer( mLazyAudio[channel].getTick(), 0x8 + channel );
+  }
+}
+
+void Mikey::catchUpAudio()
+{
+  catchUpAudio( { Action::NONE, mCore.executedTick() + 1 } );
+}
+
+void Mikey::wakeAudio()
+{
+  catchUpAudio();
+  for ( auto & action : mLazyAudio )
+  {
+    if ( action )
+    {
+      mCore.schedule( action );
+      action = {};
+    }
+  }
+}
+
+void Mikey::setLazyAudio( bool enable )
+{
+  mLazyAudioEnabled = enable;
+  if ( !enable )
+    wakeAudio();
+}
+
 void Mikey::setVGMWriter( std::shared_ptr<VGMWriter> writer )
 {
   std::unique_lock lock( mVGMWriterMutex );
@@ -511,6 +774,22 @@ void Mikey::resetIRQ( uint8_t mask )
   }
 }
 
+uint64_t Mikey::serialBitPeriod() const
+{
+  return mTimers[0x4].period();
+}
+
+void Mikey::wakeComLynx()
+{
+  if ( mComLynxDormant )
+  {
+    mComLynxDormant = false;
+    //fires due at executed tick have been accounted for by the action queue
+    if ( auto action = mTimers[0x4].resume( mCore.executedTick() + 1 ) )
+      mCore.schedule( action );
+  }
+}
+
 uint16_t Mikey::debugDispAdr() const
 {
   return mDisplayRegs.dispAdr;
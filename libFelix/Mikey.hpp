@@ -1,15 +1,16 @@
 #pragma once
 
 #include "ActionQueue.hpp"
+#include "TimerCore.hpp"
 #include "ParallelPort.hpp"
 #include "DisplayGenerator.hpp"
 #include "Utility.hpp"
 
 class Core;
-class TimerCore;
 class AudioChannel;
 class DisplayGenerator;
 class VGMWriter;
+class StateStream;
 
 class Mikey
 {
@@ -83,26 +84,88 @@ public:
   SequencedAction fireTimer( uint64_t tick, uint32_t timer );
   void setDMAData( uint64_t tick, uint64_t data );
   void suzyDone();
-  AudioSample sampleAudio( uint64_t tick ) const;
+  //Sample grid of the following batch, output changes between two samples are merged into one
+  void startAudio( uint64_t base, int sps );
+  //Renders samples taken at ticks ( base + ( i + 1 ) * 16000000 ) / sps from the recorded output changes.
+  //Band limited rendering smooths the steps and delays the output by one sample.
+  void renderAudio( std::span<AudioSample> out, uint64_t base, int sps, bool bandLimited );
+  //drops output changes up to given tick
+  void skipAudio( uint64_t tick );
+  //Turbo mode renders silence without mixing and draws only every drawInterval-th frame, 0 disables it
+  void setTurbo( uint32_t drawInterval );
+  //unobserved channels leave the action queue unless disabled, emulation is the same either way
+  void setLazyAudio( bool enable );
   void setVGMWriter( std::shared_ptr<VGMWriter> writer );
   bool isVGMWriter() const;
 
   void setIRQ( uint8_t mask );
   void resetIRQ( uint8_t mask );
+  //timer 4 underflow shifts one serial bit, 0 if the baud rate can't be told from its settings
+  uint64_t serialBitPeriod() const;
+  //reschedules timer 4 if it was left out while the serial port was idle
+  void wakeComLynx();
+
+  void serialize( StateStream & stream );
 
   uint16_t debugDispAdr() const;
   std::span<uint8_t const, 32> debugPalette() const;
 
 private:
+  AudioSample mixAudio() const;
+  void audioChanging( uint64_t tick );
+  void audioChanged( uint64_t tick );
+  void flushAudio();
+  //fires the timer if it's due and returns its next fire
+  SequencedAction runTimer( uint64_t tick, int timer );
+  //effects of an underflow of the timer and of the timers linked after it, its own reload is left to the caller
+  void underflow( uint64_t tick, int timer );
+  //interrupt and what else an underflow of timers 0-7 does
+  void timerUnderflow( uint64_t tick, int timer );
+  //channel whose fires nothing but its own output depends on
+  bool audioUnobserved( int channel ) const;
+  //runs fires of lazy channels the action queue would have executed before limit, by default those due at executed tick
+  void catchUpAudio( SequencedAction limit );
+  void catchUpAudio();
+  //schedules lazy channels again after catching up, as register writes can change what observes them
+  void wakeAudio();
+
+private:
+  static constexpr uint64_t AUDIO_PERIOD = 16000000;
+  //timer chain 0 -> 2 -> 4, 1 -> 3 -> 5 -> 7 -> audio 0 -> 1 -> 2 -> 3 -> 0
+  static constexpr std::array<int, 12> BORROW_TARGET{ 0x2, 0x3, 0x4, 0x5, -1, 0x7, -1, 0x8, 0x9, 0xa, 0xb, 0x0 };
+
+  struct AudioEvent
+  {
+    uint64_t tick;
+    AudioSample level;
+  };
+
   Core & mCore;
   ComLynx & mComLynx;
   uint64_t mAccessTick;
 
-  std::array<std::unique_ptr<TimerCore>, 12> mTimers;
+  std::array<TimerCore, 12> mTimers;
   std::array<std::unique_ptr<AudioChannel>, 4> mAudioChannels;
+  //next fire of channels that are not scheduled, they are caught up whenever something can tell the difference
+  std::array<SequencedAction, 4> mLazyAudio;
+  bool mLazyAudioEnabled;
   std::array<uint8_t, 4> mAttenuation;
   std::array<int16_t, 4> mAttenuationLeft;
   std::array<int16_t, 4> mAttenuationRight;
+  //mixer output changes not rendered yet
+  std::vector<AudioEvent> mAudioEvents;
+  AudioSample mAudioLevel;
+  AudioSample mRenderedLevel;
+  uint64_t mAudioBase;
+  int mAudioSPS;
+  //pending change not mixed yet
+  uint64_t mAudioSlotEnd;
+  uint64_t mAudioChangeTick;
+  bool mAudioChanged;
+  bool mTurbo;
+  //sample delayed by band limited rendering and its scratch buffer
+  std::array<float, 2> mBlepPending;
+  std::vector<float> mBlepBuffer;
 
   std::unique_ptr<DisplayGenerator> mDisplayGenerator;
   std::shared_ptr<VGMWriter> mVGMWriter;
@@ -126,4 +189,6 @@ private:
   uint8_t mStereo;
   uint8_t mSerDat;
   uint8_t mIRQ;
+  //timer 4 isn't scheduled while the serial port is idle
+  bool mComLynxDormant;
 };
@@ -2,6 +2,7 @@
 #include "Cartridge.hpp"
 #include "ComLynx.hpp"
 #include "Core.hpp"
+#include "StateStream.hpp"
 
 
 ParallelPort::ParallelPort( Core & core, ComLynx & comLynx, RestProvider const & restProvider ) : mCore{ core }, mComLynx{ comLynx }, mRestProvider{ restProvider },
@@ -82,3 +83,8 @@ uint8_t ParallelPort::getData( uint64_t tick ) const
 
   return result;
 }
+
+void ParallelPort::serialize( StateStream & stream )
+{
+  stream( mOutputMask, mData );
+}
@@ -4,6 +4,7 @@
 
 class Cartridge;
 class Core;
+class StateStream;
 
 class RestProvider
 {
@@ -24,6 +25,8 @@ public:
   void setData( uint8_t value );
   uint8_t getData( uint64_t tick ) const;
 
+  void serialize( StateStream & stream );
+
   struct Mask
   {
     static constexpr uint8_t AUDIN          = 0b00010000; 
@@ -0,0 +1,223 @@
+#include "RewindBuffer.hpp"
+
+namespace
+{
+
+//shorter runs of equal bytes are kept inside literals
+static constexpr size_t MIN_ZERO_RUN = 4;
+
+void putVarint( std::vector<uint8_t> & out, size_t value )
+{
+  while ( value >= 0x80 )
+  {
+    out.push_back( (uint8_t)( value | 0x80 ) );
+    value >>= 7;
+  }
+  out.push_back( (uint8_t)value );
+}
+
+size_t getVarint( uint8_t const*& in )
+{
+  size_t value = 0;
+  for ( int shift = 0;; shift += 7 )
+  {
+    uint8_t b = *in++;
+    value |= (size_t)( b & 0x7f ) << shift;
+    if ( ( b & 0x80 ) == 0 )
+      return value;
+  }
+}
+
+size_t equalRun( uint8_t const* a, uint8_t const* b, size_t begin, size_t end )
+{
+  size_t i = begin;
+  for ( ; i + 8 <= end; i += 8 )
+  {
+    uint64_t va, vb;
+    std::memcpy( &va, a + i, 8 );
+    std::memcpy( &vb, b + i, 8 );
+    if ( va != vb )
+      break;
+  }
+  while ( i < end && a[i] == b[i] )
+    ++i;
+  return i;
+}
+
+}
+
+RewindBuffer::RewindBuffer( size_t budget ) : mRing( budget ), mEntries{}, mHead{}, mBase{}, mBaseSize{}, mHasBase{}, mLast{}, mLastSize{},
+  mNext{}, mNextSize{}, mDelta{}
+{
+}
+
+std::span<uint8_t> RewindBuffer::stage( size_t size )
+{
+  pad( mNext, size );
+  std::fill( mNext.begin() + size, mNext.end(), 0 );
+  mNextSize = (uint32_t)size;
+  return { mNext.data(), size };
+}
+
+void RewindBuffer::push()
+{
+  if ( !mHasBase )
+  {
+    mBase.assign( mNext.begin(), mNext.begin() + mNextSize );
+    mBaseSize = mNextSize;
+    mHasBase = true;
+    std::swap( mLast, mNext );
+    mLastSize = mNextSize;
+    return;
+  }
+
+  //all states are zero padded to the same size so deltas can be applied both ways
+  size_t size = std::max( { mNext.size(), mLast.size(), mBase.size() } );
+  pad( mNext, size );
+  pad( mLast, size );
+  pad( mBase, size );
+
+  encodeDelta( mNext, mLast );
+
+  if ( mDelta.size() > mRing.size() )
+  {
+    //doesn't fit at all, starting over from this state
+    clear();
+    push();
+    return;
+  }
+
+  size_t offset = allocate( mDelta.size() );
+  std::memcpy( mRing.data() + offset, mDelta.data(), mDelta.size() );
+  mEntries.push_back( { offset, (uint32_t)mDelta.size(), mNextSize } );
+  mHead = offset + mDelta.size();
+
+  std::swap( mLast, mNext );
+  mLastSize = mNextSize;
+}
+
+std::span<uint8_t const> RewindBuffer::pop()
+{
+  if ( !mHasBase )
+    return {};
+
+  pad( mNext, mLast.size() );
+  std::copy( mLast.begin(), mLast.end(), mNext.begin() );
+  mNextSize = mLastSize;
+
+  if ( mEntries.empty() )
+  {
+    mHasBase = false;
+  }
+  else
+  {
+    auto const& entry = mEntries.back();
+    applyDelta( { mRing.data() + entry.offset, entry.size }, mLast );
+    mEntries.pop_back();
+    mLastSize = mEntries.empty() ? mBaseSize : mEntries.back().stateSize;
+    mHead = mEntries.empty() ? 0 : mEntries.back().offset + mEntries.back().size;
+  }
+
+  return { mNext.data(), mNextSize };
+}
+
+size_t RewindBuffer::size() const
+{
+  return mHasBase ? mEntries.size() + 1 : 0;
+}
+
+size_t RewindBuffer::memoryUsage() const
+{
+  return mRing.size() + mBase.size() + mLast.size() + mNext.size() + mDelta.size();
+}
+
+void RewindBuffer::clear()
+{
+  mEntries.clear();
+  mHead = 0;
+  mHasBase = false;
+}
+
+size_t RewindBuffer::allocate( size_t size )
+{
+  while ( !mEntries.empty() )
+  {
+    size_t tail = mEntries.front().offset;
+    if ( mHead > tail )
+    {
+      //used space is [tail, mHead)
+      if ( mHead + size <= mRing.size() )
+        return mHead;
+      if ( size <= tail )
+        return 0;
+    }
+    else if ( mHead < tail && mHead + size <= tail )
+    {
+      //used space wraps around, free space is [mHead, tail)
+      return mHead;
+    }
+    evictOldest();
+  }
+
+  return 0;
+}
+
+void RewindBuffer::evictOldest()
+{
+  auto const& entry = mEntries.front();
+  applyDelta( { mRing.data() + entry.offset, entry.size }, mBase );
+  mBaseSize = entry.stateSize;
+  mEntries.pop_front();
+}
+
+void RewindBuffer::encodeDelta( std::span<uint8_t const> state, std::span<uint8_t const> prev )
+{
+  assert( state.size() == prev.size() );
+
+  //sequence of ( zero run length, literal length, literal xor bytes )
+  mDelta.clear();
+  size_t const n = state.size();
+  size_t i = 0;
+  while ( i < n )
+  {
+    size_t literal = equalRun( state.data(), prev.data(), i, n );
+    size_t end = literal;
+    while ( end < n )
+    {
+      size_t same = equalRun( state.data(), prev.data(), end, std::min( n, end + MIN_ZERO_RUN ) );
+      if ( same == n || same - end >= MIN_ZERO_RUN )
+        break;
+      end = same + 1;
+    }
+
+    putVarint( mDelta, literal - i );
+    putVarint( mDelta, end - literal );
+    for ( size_t j = literal; j < end; ++j )
+    {
+      mDelta.push_back( state[j] ^ prev[j] );
+    }
+    i = end;
+  }
+}
+
+void RewindBuffer::applyDelta( std::span<uint8_t const> delta, std::span<uint8_t> state )
+{
+  uint8_t const* in = delta.data();
+  uint8_t const* inEnd = in + delta.size();
+  uint8_t* out = state.data();
+  while ( in < inEnd )
+  {
+    out += getVarint( in );
+    size_t literal = getVarint( in );
+    for ( size_t j = 0; j < literal; ++j )
+    {
+      *out++ ^= *in++;
+    }
+  }
+}
+
+void RewindBuffer::pad( std::vector<uint8_t> & state, size_t size )
+{
+  if ( state.size() < size )
+    state.resize( size );
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+//Machine states captured one after another kept as XOR deltas of consecutive states, zero runs are RLE compressed.
+//Deltas live in a byte ring of fixed size, when it's full the oldest states are merged into the base state.
+class RewindBuffer
+{
+public:
+  //budget is the size of the delta ring, three full states are kept on top of it
+  RewindBuffer( size_t budget );
+
+  //buffer to save the next state into, followed by push
+  std::span<uint8_t> stage( size_t size );
+  void push();
+  //most recent state that gets removed from the buffer. Valid until next call to stage or pop
+  std::span<uint8_t const> pop();
+
+  //number of states kept
+  size_t size() const;
+  size_t memoryUsage() const;
+  void clear();
+
+private:
+  struct Entry
+  {
+    size_t offset;
+    uint32_t size;
+    uint32_t stateSize;
+  };
+
+  size_t allocate( size_t size );
+  void evictOldest();
+  void encodeDelta( std::span<uint8_t const> state, std::span<uint8_t const> prev );
+  static void applyDelta( std::span<uint8_t const> delta, std::span<uint8_t> state );
+  static void pad( std::vector<uint8_t> & state, size_t size );
+
+private:
+  std::vector<uint8_t> mRing;
+  std::deque<Entry> mEntries;
+  size_t mHead;
+  //oldest state
+  std::vector<uint8_t> mBase;
+  uint32_t mBaseSize;
+  bool mHasBase;
+  //most recent state
+  std::vector<uint8_t> mLast;
+  uint32_t mLastSize;
+  //staged state or popped state
+  std::vector<uint8_t> mNext;
+  uint32_t mNextSize;
+  std::vector<uint8_t> mDelta;
+};
@@ -51,56 +51,14 @@ public:
 
   cppcoro::generator<std::tuple<Type, uint16_t, std::shared_ptr<IMemoryAccessTrap>>> getTraps( IMemoryAccessTrap::Kind kind )
   {
-    for ( int i = 0; i < 0xffff; ++i )
+    for ( auto [type, table] : tables() )
     {
-      if ( mRamReadTraps[i] && mRamReadTraps[i]->getKind() == kind )
+      for ( auto const& [address, trap] : table->entries() )
       {
-        co_yield std::tuple<Type, uint16_t, std::shared_ptr<IMemoryAccessTrap>>( Type::RAM_READ, i, mRamReadTraps[i] );
-      }
-      if ( mRamWriteTraps[i] && mRamWriteTraps[i]->getKind() == kind )
-      {
-        co_yield std::tuple<Type, uint16_t, std::shared_ptr<IMemoryAccessTrap>>( Type::RAM_WRITE, i, mRamWriteTraps[i] );
-      }
-      if ( mRamExecuteTraps[i] && mRamExecuteTraps[i]->getKind() == kind )
-      {
-        co_yield std::tuple<Type, uint16_t, std::shared_ptr<IMemoryAccessTrap>>( Type::RAM_EXECUTE, i, mRamExecuteTraps[i] );
-      }
-    }
-
-    for ( int i = 0; i < 0x200; ++i )
-    {
-      if ( mRomReadTraps[i] && mRomReadTraps[i]->getKind() == kind )
-      {
-        co_yield std::tuple<Type, uint16_t, std::shared_ptr<IMemoryAccessTrap>>( Type::ROM_READ, i, mRomReadTraps[i] );
-      }
-      if ( mRomWriteTraps[i] && mRomWriteTraps[i]->getKind() == kind )
-      {
-        co_yield std::tuple<Type, uint16_t, std::shared_ptr<IMemoryAccessTrap>>( Type::ROM_WRITE, i, mRomWriteTraps[i] );
-      }
-      if ( mRomExecuteTraps[i] && mRomExecuteTraps[i]->getKind() == kind )
-      {
-        co_yield std::tuple<Type, uint16_t, std::shared_ptr<IMemoryAccessTrap>>( Type::ROM_EXECUTE, i, mRomExecuteTraps[i] );
-      }
-    }
-
-    for ( int i = 0; i < 0x100; ++i )
-    {
-      if ( mSuzyReadTraps[i] && mSuzyReadTraps[i]->getKind() == kind )
-      {
-        co_yield std::tuple<Type, uint16_t, std::shared_ptr<IMemoryAccessTrap>>( Type::SUZY_READ, i, mSuzyReadTraps[i] );
-      }
-      if ( mSuzyWriteTraps[i] && mSuzyWriteTraps[i]->getKind() == kind )
-      {
-        co_yield std::tuple<Type, uint16_t, std::shared_ptr<IMemoryAccessTrap>>( Type::SUZY_WRITE, i, mSuzyWriteTraps[i] );
-      }
-
-      if ( mMikeyReadTraps[i] && mMikeyReadTraps[i]->getKind() == kind )
-      {
-        co_yield std::tuple<Type, uint16_t, std::shared_ptr<IMemoryAccessTrap>>( Type::MIKEY_READ, i, mMikeyReadTraps[i] );
-      }
-      if ( mMikeyWriteTraps[i] && mMikeyWriteTraps[i]->getKind() == kind )
-      {
-        co_yield std::tuple<Type, uint16_t, std::shared_ptr<IMemoryAccessTrap>>( Type::MIKEY_WRITE, i, mMikeyWriteTraps[i] );
+        if ( trap->getKind() == kind )
+        {
+          co_yield std::tuple<Type, uint16_t, std::shared_ptr<IMemoryAccessTrap>>( type, address, trap );
+        }
       }
     }
   }
@@ -109,45 +67,14 @@ public:
   {
     switch ( type )
     {
-    case Type::RAM_READ:
-      mRamReadMask[address] = 0;
-      mRamReadTraps[address] = nullptr;
-      break;
-    case Type::RAM_WRITE:
-      mRamWriteMask[address] = 0;
-      mRamWriteTraps[address] = nullptr;
-      break;
-    case Type::RAM_EXECUTE:
-      mRamExecuteMask[address] = 0;
-      mRamExecuteTraps[address] = nullptr;
-      break;
-    case Type::ROM_READ:
-      mRomReadMask[address] = 0;
-      mRomReadTraps[address] = nullptr;
-      break;
-    case Type::ROM_WRITE:
-      mRomWriteMask[address] = 0;
-      mRomWriteTraps[address] = nullptr;
-      break;
-    case Type::ROM_EXECUTE:
-      mRomExecuteMask[address] = 0;
-      mRomExecuteTraps[address] = nullptr;
-      break;
-    case Type::MIKEY_READ:
-      mMikeyReadMask[address] = 0;
-      mMikeyReadTraps[address] = nullptr;
-      break;
-    case Type::MIKEY_WRITE:
-      mMikeyWriteMask[address] = 0;
-      mMikeyWriteTraps[address] = nullptr;
+    case Type::MAPCTL_READ:
+      mMapCtlReadTrap = nullptr;
       break;
-    case Type::SUZY_READ:
-      mSuzyReadMask[address] = 0;
-      mSuzyReadTraps[address] = nullptr;
+    case Type::MAPCTL_WRITE:
+      mMapCtlWriteTrap = nullptr;
       break;
-    case Type::SUZY_WRITE:
-      mSuzyWriteMask[address] = 0;
-      mSuzyWriteTraps[address] = nullptr;
+    default:
+      table( type ).erase( address & addressMask( type ) );
       break;
     }
   }
@@ -156,50 +83,47 @@ public:
   {
     switch ( type )
     {
-    case Type::RAM_READ:
-      helper( { mRamReadTraps.data(), mRamReadTraps.size() }, mRamReadMask[address], address, std::move( trap ) );
-      break;
-    case Type::RAM_WRITE:
-      helper( { mRamWriteTraps.data(), mRamWriteTraps.size() }, mRamWriteMask[address], address, std::move( trap ) );
-      break;
-    case Type::RAM_EXECUTE:
-      helper( { mRamExecuteTraps.data(), mRamExecuteTraps.size() }, mRamExecuteMask[address], address, std::move( trap ) );
-      break;
-    case Type::ROM_READ:
-      helper( { mRomReadTraps.data(), mRomReadTraps.size() }, mRomReadMask[address & 0x1ff], address & 0x1ff, std::move( trap ) );
-      break;
-    case Type::ROM_WRITE:
-      helper( { mRomWriteTraps.data(), mRomWriteTraps.size() }, mRomWriteMask[address & 0x1ff], address & 0x1ff, std::move( trap ) );
-      break;
-    case Type::ROM_EXECUTE:
-      helper( { mRomExecuteTraps.data(), mRomExecuteTraps.size() }, mRomExecuteMask[address & 0x1ff], address & 0x1ff, std::move( trap ) );
-      break;
-    case Type::MIKEY_READ:
-      helper( { mMikeyReadTraps.data(), mMikeyReadTraps.size() }, mMikeyReadMask[address & 0xff], address & 0xff, std::move( trap ) );
-      break;
-    case Type::MIKEY_WRITE:
-      helper( { mMikeyWriteTraps.data(), mMikeyWriteTraps.size() }, mMikeyWriteMask[address & 0xff], address & 0xff, std::move( trap ) );
+    case Type::MAPCTL_READ:
+      mMapCtlReadTrap = compose( std::move( mMapCtlReadTrap ), std::move( trap ) );
       break;
-    case Type::SUZY_READ:
-      helper( { mSuzyReadTraps.data(), mSuzyReadTraps.size() }, mSuzyReadMask[address & 0xff], address & 0xff, std::move( trap ) );
+    case Type::MAPCTL_WRITE:
+      mMapCtlWriteTrap = compose( std::move( mMapCtlWriteTrap ), std::move( trap ) );
       break;
-    case Type::SUZY_WRITE:
-      helper( { mSuzyWriteTraps.data(), mSuzyWriteTraps.size() }, mSuzyWriteMask[address & 0xff], address & 0xff, std::move( trap ) );
+    default:
+      table( type ).add( address & addressMask( type ), std::move( trap ) );
       break;
+    }
+  }
+
+  //number of addresses with a trap of given type
+  size_t trapCount( Type type ) const
+  {
+    switch ( type )
+    {
     case Type::MAPCTL_READ:
-      helper( { &mMapCtlReadTrap, 1 }, 0, std::move( trap ) );
-      break;
+      return mMapCtlReadTrap ? 1 : 0;
     case Type::MAPCTL_WRITE:
-      helper( { &mMapCtlWriteTrap, 1 }, 0, std::move( trap ) );
-      break;
+      return mMapCtlWriteTrap ? 1 : 0;
+    default:
+    {
+      auto all = tables();
+      return std::ranges::find( all, type, &std::pair<Type, TrapTable const*>::first )->second->size();
     }
+    }
+  }
+
+  //whether RAM, Mikey or Suzy accesses need to be passed through the debugger at all
+  bool hasMemoryTraps() const
+  {
+    return trapCount( Type::RAM_EXECUTE ) + trapCount( Type::RAM_READ ) + trapCount( Type::RAM_WRITE ) +
+      trapCount( Type::MIKEY_READ ) + trapCount( Type::MIKEY_WRITE ) + trapCount( Type::SUZY_READ ) + trapCount( Type::SUZY_WRITE ) != 0;
   }
 
   uint8_t readRAM( Core& core, uint16_t address, uint8_t orgValue )
   {
-    if ( mRamReadMask( address ) )
+    if ( auto trap = mRamReadTraps.find( address ) )
     {
-      return mRamReadTraps[address]->trap( core, address, orgValue );
+      return trap->trap( core, address, orgValue );
     }
     else
     {
@@ -209,9 +133,9 @@ public:
 
   uint8_t writeRAM( Core& core, uint16_t address, uint8_t orgValue )
   {
-    if ( mRamWriteMask( address ) )
+    if ( auto trap = mRamWriteTraps.find( address ) )
     {
-      return mRamWriteTraps[address]->trap( core, address, orgValue );
+      return trap->trap( core, address, orgValue );
     }
     else
     {
@@ -221,9 +145,9 @@ public:
 
   uint8_t executeRAM( Core& core, uint16_t address, uint8_t orgValue )
   {
-    if ( mRamExecuteMask( address ) )
+    if ( auto trap = mRamExecuteTraps.find( address ) )
     {
-      return mRamExecuteTraps[address]->trap( core, address, orgValue );
+      return trap->trap( core, address, orgValue );
     }
     else
     {
@@ -233,9 +157,9 @@ public:
 
   uint8_t readROM( Core& core, uint16_t address, uint8_t orgValue )
   {
-    if ( mRomReadMask( address ) )
+    if ( auto trap = mRomReadTraps.find( address ) )
     {
-      return mRomReadTraps[address]->trap( core, address + 0xfe00, orgValue );
+      return trap->trap( core, address + 0xfe00, orgValue );
     }
     else
     {
@@ -245,9 +169,9 @@ public:
 
   uint8_t writeROM( Core& core, uint16_t address, uint8_t orgValue )
   {
-    if ( mRomWriteMask( address ) )
+    if ( auto trap = mRomWriteTraps.find( address ) )
     {
-      return mRomWriteTraps[address]->trap( core, address + 0xfe00, orgValue );
+      return trap->trap( core, address + 0xfe00, orgValue );
     }
     else
     {
@@ -257,9 +181,9 @@ public:
 
   uint8_t executeROM( Core& core, uint16_t address, uint8_t orgValue )
   {
-    if ( mRomExecuteMask(address) )
+    if ( auto trap = mRomExecuteTraps.find( address ) )
     {
-      return mRomExecuteTraps[address]->trap( core, address + 0xfe00, orgValue );
+      return trap->trap( core, address + 0xfe00, orgValue );
     }
     else
     {
@@ -269,9 +193,9 @@ public:
 
   uint8_t readMikey( Core& core, uint16_t address, uint8_t orgValue )
   {
-    if ( mMikeyReadMask( address & 0xff ) )
+    if ( auto trap = mMikeyReadTraps.find( address & 0xff ) )
     {
-      return mMikeyReadTraps[address & 0xff]->trap( core, address, orgValue );
+      return trap->trap( core, address, orgValue );
     }
     else
     {
@@ -281,9 +205,9 @@ public:
 
   uint8_t writeMikey( Core& core, uint16_t address, uint8_t orgValue )
   {
-    if ( mMikeyWriteMask( address & 0xff ) )
+    if ( auto trap = mMikeyWriteTraps.find( address & 0xff ) )
     {
-      return mMikeyWriteTraps[address & 0xff]->trap( core, address, orgValue );
+      return trap->trap( core, address, orgValue );
     }
     else
     {
@@ -293,9 +217,9 @@ public:
 
   uint8_t readSuzy( Core& core, uint16_t address, uint8_t orgValue )
   {
-    if ( mSuzyReadMask( address & 0xff ) )
+    if ( auto trap = mSuzyReadTraps.find( address & 0xff ) )
     {
-      return mSuzyReadTraps[address & 0xff]->trap( core, address, orgValue );
+      return trap->trap( core, address, orgValue );
     }
     else
     {
@@ -305,9 +229,9 @@ public:
 
   uint8_t writeSuzy( Core& core, uint16_t address, uint8_t orgValue )
   {
-    if ( mSuzyWriteMask( address & 0xff ) )
+    if ( auto trap = mSuzyWriteTraps.find( address & 0xff ) )
     {
-      return mSuzyWriteTraps[address & 0xff]->trap( core, address, orgValue );
+      return trap->trap( core, address, orgValue );
     }
     else
     {
@@ -341,98 +265,152 @@ public:
 
 private:
 
-  struct Proxy
+  //Traps of one type sorted by address. A bit per 256 byte page tells whether there is any trap in the page,
+  //so accesses to untrapped pages don't search at all.
+  class TrapTable
   {
-    uint8_t& byte;
-    uint8_t mask;
+  public:
+    struct Entry
+    {
+      uint16_t address;
+      std::shared_ptr<IMemoryAccessTrap> trap;
+    };
+
+    IMemoryAccessTrap* find( uint16_t address ) const
+    {
+      if ( ( mPages[address >> 11] & ( 1 << ( ( address >> 8 ) & 7 ) ) ) == 0 )
+        return nullptr;
+
+      auto it = std::ranges::lower_bound( mEntries, address, {}, &Entry::address );
+      return it != mEntries.end() && it->address == address ? it->trap.get() : nullptr;
+    }
 
-    void operator=( bool bit )
+    void add( uint16_t address, std::shared_ptr<IMemoryAccessTrap> trap )
     {
-      if ( bit )
+      auto it = std::ranges::lower_bound( mEntries, address, {}, &Entry::address );
+      if ( it != mEntries.end() && it->address == address )
       {
-        byte |= mask;
+        it->trap = compose( std::move( it->trap ), std::move( trap ) );
       }
       else
       {
-        byte &= ~mask;
+        mEntries.insert( it, Entry{ address, std::move( trap ) } );
+        mPages[address >> 11] |= 1 << ( ( address >> 8 ) & 7 );
       }
     }
 
-    explicit operator bool() const
+    void erase( uint16_t address )
     {
-      return ( byte & mask ) != 0;
-    }
-  };
+      auto it = std::ranges::lower_bound( mEntries, address, {}, &Entry::address );
+      if ( it == mEntries.end() || it->address != address )
+        return;
 
-  template<size_t SIZE>
-  struct BitArray : public std::array<uint8_t, SIZE / 8>
-  {
+      it = mEntries.erase( it );
+      bool const nextInPage = it != mEntries.end() && ( it->address >> 8 ) == ( address >> 8 );
+      bool const prevInPage = it != mEntries.begin() && ( std::prev( it )->address >> 8 ) == ( address >> 8 );
+      if ( !nextInPage && !prevInPage )
+        mPages[address >> 11] &= ~( 1 << ( ( address >> 8 ) & 7 ) );
+    }
 
-    constexpr bool operator()( size_t pos ) const
+    size_t size() const
     {
-      return ( std::array<uint8_t, SIZE / 8>::operator[]( pos >> 3 ) & ( 1 << ( pos & 7 ) ) ) != 0;
+      return mEntries.size();
     }
 
-    constexpr Proxy operator[]( size_t pos )
+    std::span<Entry const> entries() const
     {
-      return Proxy{ std::array<uint8_t, SIZE / 8>::operator[]( pos >> 3 ), (uint8_t)( 1 << ( pos & 7 ) ) };
+      return mEntries;
     }
+
+  private:
+    std::array<uint8_t, 32> mPages{};
+    std::vector<Entry> mEntries;
   };
 
-  void helper( std::span<std::shared_ptr<IMemoryAccessTrap>> dest, uint16_t address, std::shared_ptr<IMemoryAccessTrap> src )
+  static std::shared_ptr<IMemoryAccessTrap> compose( std::shared_ptr<IMemoryAccessTrap> existing, std::shared_ptr<IMemoryAccessTrap> trap )
   {
-    if ( dest[address] )
-    {
-      auto tmp = std::move( dest[address] );
-      dest[address] = std::make_shared<CompositeTrap>( std::move( tmp ), std::move( src ) );
-    }
+    if ( existing )
+      return std::make_shared<CompositeTrap>( std::move( existing ), std::move( trap ) );
     else
-    {
-      dest[address] = std::move( src );
-    }
+      return trap;
   }
 
-  void helper( std::span<std::shared_ptr<IMemoryAccessTrap>> dest, Proxy proxy, uint16_t address, std::shared_ptr<IMemoryAccessTrap> src )
+  static uint16_t addressMask( Type type )
   {
-    if ( proxy )
+    switch ( type )
     {
-      auto tmp = std::move( dest[address] );
-      dest[address] = std::make_shared<CompositeTrap>( std::move( tmp ), std::move( src ) );
+    case Type::ROM_READ:
+    case Type::ROM_WRITE:
+    case Type::ROM_EXECUTE:
+      return 0x1ff;
+    case Type::MIKEY_READ:
+    case Type::MIKEY_WRITE:
+    case Type::SUZY_READ:
+    case Type::SUZY_WRITE:
+      return 0xff;
+    default:
+      return 0xffff;
     }
-    else
+  }
+
+  TrapTable & table( Type type )
+  {
+    switch ( type )
     {
-      dest[address] = std::move( src );
-      proxy = true;
+    case Type::RAM_EXECUTE:
+      return mRamExecuteTraps;
+    case Type::RAM_READ:
+      return mRamReadTraps;
+    case Type::RAM_WRITE:
+      return mRamWriteTraps;
+    case Type::ROM_READ:
+      return mRomReadTraps;
+    case Type::ROM_WRITE:
+      return mRomWriteTraps;
+    case Type::ROM_EXECUTE:
+      return mRomExecuteTraps;
+    case Type::MIKEY_READ:
+      return mMikeyReadTraps;
+    case Type::MIKEY_WRITE:
+      return mMikeyWriteTraps;
+    case Type::SUZY_READ:
+      return mSuzyReadTraps;
+    default:  //Type::SUZY_WRITE
+      return mSuzyWriteTraps;
     }
   }
 
+  std::array<std::pair<Type, TrapTable const*>, 10> tables() const
+  {
+    return { {
+      { Type::RAM_READ, &mRamReadTraps },
+      { Type::RAM_WRITE, &mRamWriteTraps },
+      { Type::RAM_EXECUTE, &mRamExecuteTraps },
+      { Type::ROM_READ, &mRomReadTraps },
+      { Type::ROM_WRITE, &mRomWriteTraps },
+      { Type::ROM_EXECUTE, &mRomExecuteTraps },
+      { Type::SUZY_READ, &mSuzyReadTraps },
+      { Type::SUZY_WRITE, &mSuzyWriteTraps },
+      { Type::MIKEY_READ, &mMikeyReadTraps },
+      { Type::MIKEY_WRITE, &mMikeyWriteTraps }
+    } };
+  }
 
 private:
-  BitArray<65536> mRamReadMask;
-  std::array<std::shared_ptr<IMemoryAccessTrap>, 65536> mRamReadTraps;
-  BitArray<65536> mRamWriteMask;
-  std::array<std::shared_ptr<IMemoryAccessTrap>, 65536> mRamWriteTraps;
-  BitArray<65536> mRamExecuteMask;
-  std::array<std::shared_ptr<IMemoryAccessTrap>, 65536> mRamExecuteTraps;
-
-  BitArray<512> mRomReadMask;
-  std::array<std::shared_ptr<IMemoryAccessTrap>, 512> mRomReadTraps;
-  BitArray<512> mRomWriteMask;
-  std::array<std::shared_ptr<IMemoryAccessTrap>, 512> mRomWriteTraps;
-  BitArray<512> mRomExecuteMask;
-  std::array<std::shared_ptr<IMemoryAccessTrap>, 512> mRomExecuteTraps;
-
-  BitArray<256> mMikeyReadMask;
-  std::array<std::shared_ptr<IMemoryAccessTrap>, 256> mMikeyReadTraps;
-  BitArray<256> mMikeyWriteMask;
-  std::array<std::shared_ptr<IMemoryAccessTrap>, 256> mMikeyWriteTraps;
-
-  BitArray<256> mSuzyReadMask;
-  std::array<std::shared_ptr<IMemoryAccessTrap>, 256> mSuzyReadTraps;
-  BitArray<256> mSuzyWriteMask;
-  std::array<std::shared_ptr<IMemoryAccessTrap>, 256> mSuzyWriteTraps;
+  TrapTable mRamReadTraps;
+  TrapTable mRamWriteTraps;
+  TrapTable mRamExecuteTraps;
+
+  TrapTable mRomReadTraps;
+  TrapTable mRomWriteTraps;
+  TrapTable mRomExecuteTraps;
+
+  TrapTable mMikeyReadTraps;
+  TrapTable mMikeyWriteTraps;
+
+  TrapTable mSuzyReadTraps;
+  TrapTable mSuzyWriteTraps;
 
   std::shared_ptr<IMemoryAccessTrap> mMapCtlReadTrap;
   std::shared_ptr<IMemoryAccessTrap> mMapCtlWriteTrap;
 };
-
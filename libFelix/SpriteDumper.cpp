@@ -1,7 +1,11 @@
 #include "SpriteDumper.hpp"
 #include "Utility.hpp"
 #include <bit>
+#if __has_include("stb_image_write.h")
+#define STB_IMAGE_WRITE_IMPLEMENTATION
 #include "stb_image_write.h"
+#define HAS_STB_IMAGE_WRITE
+#endif
 
 namespace
 {
@@ -171,7 +175,9 @@ void SpriteDumper::createPNG( std::filesystem::path outputPath )
     }
   }
 
+#ifdef HAS_STB_IMAGE_WRITE
   stbi_write_bmp( outputPath.string().c_str(), mCurrectDesc.width(), mCurrectDesc.height(), 4, ( void const* )data.data() );
+#endif
 }
 
 std::pair<uint8_t, uint8_t> SpriteDumper::pixelPos( uint32_t off ) const
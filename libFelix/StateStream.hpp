@@ -0,0 +1,108 @@
+#pragma once
+
+//Flat binary stream used by Core::saveState / Core::loadState.
+//Every component has a single serialize( StateStream & ) method listing its state once,
+//the stream decides whether values are measured, written or read.
+class StateStream
+{
+public:
+  enum class Mode
+  {
+    SIZE,
+    SAVE,
+    LOAD
+  };
+
+  //measures the size of the state without touching any memory
+  StateStream() : mMode{ Mode::SIZE }, mData{}, mSize{}, mOffset{}, mGood{ true }
+  {
+  }
+
+  StateStream( std::span<uint8_t> out ) : mMode{ Mode::SAVE }, mData{ out.data() }, mSize{ out.size() }, mOffset{}, mGood{ true }
+  {
+  }
+
+  StateStream( std::span<uint8_t const> in ) : mMode{ Mode::LOAD }, mData{ const_cast<uint8_t*>( in.data() ) }, mSize{ in.size() }, mOffset{}, mGood{ true }
+  {
+  }
+
+  bool loading() const
+  {
+    return mMode == Mode::LOAD;
+  }
+
+  bool good() const
+  {
+    return mGood;
+  }
+
+  size_t offset() const
+  {
+    return mOffset;
+  }
+
+  template<typename T>
+  StateStream & operator()( T & value )
+  {
+    static_assert( std::is_trivially_copyable_v<T> );
+    return bytes( &value, sizeof( T ) );
+  }
+
+  template<typename T, typename... Ts>
+  StateStream & operator()( T & value, Ts &... values )
+  {
+    ( *this )( value );
+    return ( *this )( values... );
+  }
+
+  template<typename T>
+  StateStream & operator()( std::vector<T> & values )
+  {
+    static_assert( std::is_trivially_copyable_v<T> );
+    uint32_t count = (uint32_t)values.size();
+    ( *this )( count );
+    if ( loading() )
+    {
+      if ( !mGood || count > ( mSize - mOffset ) / sizeof( T ) )
+      {
+        mGood = false;
+        return *this;
+      }
+      values.resize( count );
+    }
+    return bytes( values.data(), count * sizeof( T ) );
+  }
+
+  StateStream & bytes( void * data, size_t size )
+  {
+    if ( !mGood )
+      return *this;
+
+    switch ( mMode )
+    {
+    case Mode::SIZE:
+      break;
+    case Mode::SAVE:
+    case Mode::LOAD:
+      if ( mOffset + size > mSize )
+      {
+        mGood = false;
+        return *this;
+      }
+      if ( mMode == Mode::SAVE )
+        std::memcpy( mData + mOffset, data, size );
+      else
+        std::memcpy( data, mData + mOffset, size );
+      break;
+    }
+    mOffset += size;
+    return *this;
+  }
+
+private:
+  Mode mMode;
+  uint8_t * mData;
+  size_t mSize;
+  size_t mOffset;
+  bool mGood;
+};
@@ -3,6 +3,7 @@
 #include "SuzyProcess.hpp"
 #include "Cartridge.hpp"
 #include "Log.hpp"
+#include "StateStream.hpp"
 
 Suzy::Suzy( Core& core, std::shared_ptr<IInputSource> inputSource ) : mCore{ core }, mSCB{}, mMath{ mCore.getTraceHelper() }, mInputSource{ inputSource }, mSpriteDumper{}, mSpriteDumperPath{}, mSpriteDumperMutex{}, mAccessTick{},
   mPalette{}, mBusEnable{}, mNoCollide{}, mVStretch{}, mLeftHand{ true }, mUnsafeAccess{}, mSpriteStop{},
@@ -446,6 +447,13 @@ uint16_t Suzy::debugCollBas() const
   return mSCB.collbas;
 }
 
+void Suzy::serialize( StateStream & stream )
+{
+  stream( mSCB, mAccessTick, mPalette, mBusEnable, mNoCollide, mVStretch, mLeftHand, mUnsafeAccess, mSpriteStop, mSpriteWorking, mHFlip, mVFlip,
+    mLiteral, mAlgo3, mReusePalette, mSkipSprite, mEveron, mStartingQuadrant, mBpp, mSpriteType, mReload, mSprColl, mSprInit );
+  mMath.serialize( stream );
+}
+
 bool Suzy::isSpriteDumping() const
 {
   std::scoped_lock<std::mutex> lock{ mSpriteDumperMutex };
@@ -500,7 +508,7 @@ uint8_t Suzy::noice( uint64_t tick )
   }
 }
 
-std::shared_ptr<ISuzyProcess> Suzy::suzyProcess()
+std::shared_ptr<ISuzyProcess> Suzy::suzyProcess( bool batched )
 {
   std::scoped_lock<std::mutex> lock{ mSpriteDumperMutex };
 
@@ -516,11 +524,11 @@ std::shared_ptr<ISuzyProcess> Suzy::suzyProcess()
   if ( mSpriteDumper )
   {
     mSpriteDumper->setPalette( mCore.debugPalette() );
-    return std::make_shared<SuzyProcess<SpriteDumper>>( *this, *mSpriteDumper );
+    return std::make_shared<SuzyProcess<SpriteDumper>>( *this, *mSpriteDumper, batched ? &mCore : nullptr );
   }
   else
   {
     DummyDumper sink;
-    return std::make_shared<SuzyProcess<DummyDumper>>( *this, sink );
+    return std::make_shared<SuzyProcess<DummyDumper>>( *this, sink, batched ? &mCore : nullptr );
   }
 }
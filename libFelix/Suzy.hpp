@@ -5,6 +5,7 @@
 #include "SpriteDumper.hpp"
 
 class Core;
+class StateStream;
 
 class ISuzyProcess
 {
@@ -26,7 +27,11 @@ public:
       WRITEFRED,
       COLRMW,
       VIDRMW,
-      XOR
+      XOR,
+      //batched process gives way to the run loop, the pending access is done on next advance
+      YIELD,
+      //process is about to fetch the next SCB and keeps no state of its own
+      NEXTSCB
     } type;
 
     Request( Type type = FINISH, uint16_t addr = 0, uint16_t value = 0, uint32_t mask = 0 ) : mask{ mask }, addr{ addr }, value{ value }, type{ type } {}
@@ -38,6 +43,8 @@ public:
   virtual ~ISuzyProcess() = default;
   virtual Request const* advance() = 0;
   virtual void respond( uint32_t value ) = 0;
+  //true when a new process started from Suzy registers would continue in the same way
+  virtual bool betweenSCBs() const = 0;
 };
 
 class Suzy
@@ -54,7 +61,8 @@ public:
   bool isSpriteDumping() const;
   void dumpSprites( std::filesystem::path path );
 
-  std::shared_ptr<ISuzyProcess> suzyProcess();
+  std::shared_ptr<ISuzyProcess> suzyProcess( bool batched );
+  void serialize( StateStream & stream );
 
   template<typename DMASINK>
   friend class SuzyProcess;
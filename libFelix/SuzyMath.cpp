@@ -1,6 +1,7 @@
 #include "SuzyMath.hpp"
 #include "TraceHelper.hpp"
 #include "Utility.hpp"
+#include "StateStream.hpp"
 
 namespace
 {
@@ -39,6 +40,11 @@ SuzyMath::SuzyMath( std::shared_ptr<TraceHelper> traceHelper ) : mArea{}, mTrace
   std::ranges::fill( mArea, 0xff );
 }
 
+void SuzyMath::serialize( StateStream & stream )
+{
+  stream( mArea, mFinishTick, mSignAB, mSignCD, mUnsafeAccess, mSignMath, mAccumulate, mMathWarning, mMathCarry );
+}
+
 bool SuzyMath::poke( uint64_t tick, uint8_t offset, uint8_t value )
 {
   assert( ( offset >= 0x50 ) && ( offset < 0x70 ) );
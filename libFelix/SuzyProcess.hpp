@@ -1,5 +1,6 @@
 #pragma once
 #include "Suzy.hpp"
+#include "Core.hpp"
 #include "Utility.hpp"
 #include "SuzyProcess.hpp"
 #include "VidOperator.hpp"
@@ -30,18 +31,27 @@ struct DummyDumper
 
 struct SuzyProcessResponse
 {
-  bool await_ready() { return false; }
-  void await_suspend( std::coroutine_handle<> c ) {}
   uint32_t value;
 };
 
+//awaiters only refer to the response so they can be freely copied by the compiler (gcc https://gcc.gnu.org/bugzilla/show_bug.cgi?id=99575)
+struct SuzyProcessAwaiter
+{
+  SuzyProcessResponse & response;
+  bool ready;
+
+  bool await_ready() { return ready; }
+  void await_suspend( std::coroutine_handle<> c ) {}
+};
+
 template< typename SPRITEDUMPER>
 class SuzyProcess : public ISuzyProcess
 {
 
 public:
 
-  SuzyProcess( Suzy & suzy, SPRITEDUMPER& sink ) : mSuzy{ suzy }, mProcessCoroutine{ process() }, request{}, response{}, mSink{ sink }
+  //with core given memory accesses are performed directly on it instead of being requested one by one
+  SuzyProcess( Suzy & suzy, SPRITEDUMPER& sink, Core * core ) : mSuzy{ suzy }, mProcessCoroutine{ process() }, request{ Request::NEXTSCB }, pending{}, response{}, mSink{ sink }, mCore{ core }
   {
   }
 
@@ -50,7 +60,14 @@ public:
   Request const* advance() override
   {
     if ( mSuzy.mSpriteWorking )
+    {
+      if ( request.type == Request::YIELD )
+      {
+        request = pending;
+        perform();
+      }
       mProcessCoroutine.resume();
+    }
     else
       setFinish();
 
@@ -62,6 +79,11 @@ public:
     response.value = value;
   }
 
+  bool betweenSCBs() const override
+  {
+    return request.type == Request::NEXTSCB;
+  }
+
 private:
 
   void setFinish()
@@ -70,105 +92,151 @@ private:
     request = { Request::FINISH };
   }
 
+  void perform()
+  {
+    if ( auto value = mCore->suzyAccess( request ) )
+      response.value = *value;
+  }
+
+  //Performs the request right away when batched unless the run loop has something due, then it gives way and the access is performed on next advance.
+  //Returns whether the coroutine can go on without suspending
+  bool issue()
+  {
+    if ( !mCore )
+      return false;
+
+    if ( mCore->suzyMayRunAhead() )
+    {
+      perform();
+      return true;
+    }
+
+    pending = request;
+    request = { Request::YIELD };
+    return false;
+  }
+
+  //gives way to the run loop if it has something due so that the end of the process is seen at the same moment as with the per access requests
+  auto suzySync()
+  {
+    struct SuzySyncResponse : public SuzyProcessAwaiter
+    {
+      void await_resume() {}
+    };
+    request = { Request::FINISH };
+    return SuzySyncResponse{ response, !mCore || issue() };
+  }
+
+  //stops before fetching the next SCB unless batched process may run ahead and the batch is not ending
+  auto suzyNextSCB()
+  {
+    struct SuzyNextSCBResponse : public SuzyProcessAwaiter
+    {
+      void await_resume() {}
+    };
+    request = { Request::NEXTSCB };
+    return SuzyNextSCBResponse{ response, mCore && mCore->suzyMayRunAhead() && !mCore->mHaltSuzy };
+  }
+
   //reads one byte of sprite data
-  auto & suzyRead( uint16_t address )
+  auto suzyRead( uint16_t address )
   {
-    struct SuzyReadResponse : public SuzyProcessResponse
+    struct SuzyReadResponse : public SuzyProcessAwaiter
     {
-      uint8_t await_resume() { return (uint8_t)value; }
+      uint8_t await_resume() { return (uint8_t)response.value; }
     };
     request = { Request::READ, address };
-    return static_cast<SuzyReadResponse &>( response );
+    return SuzyReadResponse{ response, issue() };
   }
 
   //reads four bytes of sprite data
-  auto& suzyRead4( uint16_t address )
+  auto suzyRead4( uint16_t address )
   {
-    struct SuzyRead4Response : public SuzyProcessResponse
+    struct SuzyRead4Response : public SuzyProcessAwaiter
     {
-      uint32_t await_resume() { return value; }
+      uint32_t await_resume() { return response.value; }
     };
     request = { Request::READ4, address };
-    return static_cast< SuzyRead4Response& >( response );
+    return SuzyRead4Response{ response, issue() };
   }
 
   //reads SCB data
-  auto & suzyFetchSCB( uint16_t address )
+  auto suzyFetchSCB( uint16_t address )
   {
-    struct SuzyFetchSCBResponse : public SuzyProcessResponse
+    struct SuzyFetchSCBResponse : public SuzyProcessAwaiter
     {
-      uint8_t await_resume() { return (uint8_t)value; }
+      uint8_t await_resume() { return (uint8_t)response.value; }
     };
     request = { Request::FETCHSCB, address };
-    return static_cast<SuzyFetchSCBResponse &>( response );
+    return SuzyFetchSCBResponse{ response, issue() };
   }
 
   //reads pen indices data
-  auto & suzyReadPal( uint16_t address )
+  auto suzyReadPal( uint16_t address )
   {
-    struct SuzyReadPalResponse : public SuzyProcessResponse
+    struct SuzyReadPalResponse : public SuzyProcessAwaiter
     {
-      uint32_t await_resume() { return value; }
+      uint32_t await_resume() { return response.value; }
     };
     request = { Request::READPAL, address };
-    return static_cast<SuzyReadPalResponse &>( response );
+    return SuzyReadPalResponse{ response, issue() };
   }
 
   //performs color data write
-  auto & suzyWrite( uint16_t address, uint8_t value )
+  auto suzyWrite( uint16_t address, uint8_t value )
   {
     mSink.drawByte( address, value, 0 );
-    struct SuzyWriteResponse : public SuzyProcessResponse
+    struct SuzyWriteResponse : public SuzyProcessAwaiter
     {
       void await_resume() {}
     };
     request = { Request::WRITE, address, value };
-    return static_cast<SuzyWriteResponse &>( response );
+    return SuzyWriteResponse{ response, issue() };
   }
 
   //FRED write-back 
-  auto & suzyWriteFred( uint16_t address, uint8_t value )
+  auto suzyWriteFred( uint16_t address, uint8_t value )
   {
-    struct SuzyWriteResponse : public SuzyProcessResponse
+    struct SuzyWriteResponse : public SuzyProcessAwaiter
     {
       void await_resume() {}
     };
     request = { Request::WRITEFRED, address, value };
-    return static_cast<SuzyWriteResponse &>( response );
+    return SuzyWriteResponse{ response, issue() };
   }
 
   //performs collision data RMW
-  auto & suzyColRMW( uint32_t mask, uint16_t address, uint16_t value )
+  auto suzyColRMW( uint32_t mask, uint16_t address, uint16_t value )
   {
-    struct SuzyColRMWResponse : public SuzyProcessResponse
+    struct SuzyColRMWResponse : public SuzyProcessAwaiter
     {
-      uint32_t await_resume() { return value; }
+      uint32_t await_resume() { return response.value; }
     };
     request = { Request::COLRMW, address, value, mask };
-    return static_cast<SuzyColRMWResponse &>( response );
+    return SuzyColRMWResponse{ response, issue() };
   }
 
   //performs color data RMW
-  auto & suzyVidRMW( uint16_t address, uint8_t value, uint8_t mask )
+  auto suzyVidRMW( uint16_t address, uint8_t value, uint8_t mask )
   {
     mSink.drawByte( address, value, mask );
-    struct SuzyVidRMWResponse : public SuzyProcessResponse
+    struct SuzyVidRMWResponse : public SuzyProcessAwaiter
     {
       void await_resume() {}
     };
     request = { Request::VIDRMW, address, value, mask };
-    return static_cast<SuzyVidRMWResponse &>( response );
+    return SuzyVidRMWResponse{ response, issue() };
   }
 
   //performs XOR RMW
-  auto & suzyXOR( uint16_t address, uint8_t value )
+  auto suzyXOR( uint16_t address, uint8_t value )
   {
-    struct SuzyXORResponse : public SuzyProcessResponse
+    struct SuzyXORResponse : public SuzyProcessAwaiter
     {
       void await_resume() {}
     };
     request = { Request::XOR, address, value };
-    return static_cast<SuzyXORResponse &>( response );
+    return SuzyXORResponse{ response, issue() };
   }
 
   struct ProcessCoroutine : private NonCopyable
@@ -220,6 +288,8 @@ private:
 
     while ( ( scb.scbnext & 0xff00 ) != 0 )
     {
+      co_await suzyNextSCB();
+
       scb.scbadr = scb.scbnext;
       scb.tmpadr = scb.scbadr;
 
@@ -468,6 +538,8 @@ private:
       if ( suzy.mSpriteStop )
         break;
     }
+
+    co_await suzySync();
   }
 
 
@@ -475,6 +547,8 @@ private:
   Suzy & mSuzy;
 
   Request request;
+  Request pending;
   SuzyProcessResponse response;
   SPRITEDUMPER & mSink;
+  Core * mCore;
 };
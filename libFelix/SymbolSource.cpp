@@ -230,6 +230,11 @@ std::optional<uint16_t> SymbolSource::symbol( std::string const& name ) const
   return it2 != std::cend( defaultSymbols ) && it2->first == upper ? it2->second : std::optional<uint16_t>{};
 }
 
+std::span<SymbolSource::Symbol const> SymbolSource::symbols() const
+{
+  return mSymbols;
+}
+
 SymbolSource::Symbol SymbolSource::parseLine( std::string const& line )
 {
   std::istringstream is{ line };
@@ -2,6 +2,7 @@
 
 class SymbolSource
 {
+public:
   struct Symbol
   {
     std::string name;
@@ -13,11 +14,12 @@ class SymbolSource
     }
   };
 
-public:
   SymbolSource();
   SymbolSource( std::filesystem::path const& labPath );
   ~SymbolSource();
   std::optional<uint16_t> symbol( std::string const& name ) const;
+  //symbols read from the file sorted by name
+  std::span<Symbol const> symbols() const;
 
 private:
   Symbol parseLine( std::string const& line );
@@ -1,7 +1,8 @@
 #include "TimerCore.hpp"
+#include "StateStream.hpp"
 
-TimerCore::TimerCore( int number, std::function<void( uint64_t, bool )> trigger ) :
-  mBaseTick{}, mExpectedTick{}, mBorrowInTick{}, mBorrowOutTick{}, mTrigger{ std::move( trigger ) }, mNumber{ number },
+TimerCore::TimerCore( int number ) :
+  mBaseTick{}, mExpectedTick{}, mBorrowInTick{}, mBorrowOutTick{}, mNumber{ number },
   mEnableInt{}, mResetDone{}, mEnableReload{}, mEnableCount{}, mLinking{}, mAudShift{},
   mValue{},
   mBackup{},
@@ -92,53 +93,30 @@ uint8_t TimerCore::getControlB( uint64_t tick )
     ( mBorrowOut ? CONTROLB::BORROW_OUT : 0 );
 }
 
-SequencedAction TimerCore::fireAction( uint64_t tick )
+uint64_t TimerCore::period() const
 {
-  if ( tick != mExpectedTick )
-    return {};
+  if ( !mEnableCount || !mEnableReload || mLinking )
+    return 0;
 
-  mBorrowOutTick = tick;
-  mTrigger( tick, mEnableInt );
-  mBaseTick = tick;
-  if ( mEnableReload )
-  {
-    mValue = mBackup;
-  }
-  return computeAction();
+  return ( 1ull + mBackup ) * ( 1ull << mAudShift ) * 16;
 }
 
-void TimerCore::borrowIn( uint64_t tick )
+SequencedAction TimerCore::resume( uint64_t tick )
 {
-  if ( !( mEnableCount && mLinking ) )
-    return;
-
-  mBorrowInTick = tick;
-
-  if ( mValue > 0 )
+  uint64_t step = period();
+  if ( step != 0 && mExpectedTick != 0 && mExpectedTick < tick )
   {
-    mValue -= 1;
-  }
-  else
-  {
-    mBorrowOutTick = tick;
-    mTrigger( tick, mEnableInt );
-    mBaseTick = tick;
-    if ( mEnableReload )
-    {
-      mValue = mBackup;
-    }
+    //last fire before tick
+    uint64_t last = mExpectedTick + ( tick - 1 - mExpectedTick ) / step * step;
+    mBorrowOutTick = last;
+    mBaseTick = last;
+    mValue = mBackup;
   }
+  return computeAction();
 }
 
-SequencedAction TimerCore::computeAction()
+void TimerCore::serialize( StateStream & stream )
 {
-  if ( !mEnableCount || mLinking )
-  {
-    mExpectedTick = 0;
-    return {};
-  }
-
-  mExpectedTick = mBaseTick + ( 1ull + mValue ) * ( 1ull << mAudShift ) * 16;
-
-  return { (Action)( ( int )Action::FIRE_TIMER0 + mNumber ), mExpectedTick };
+  stream( mBaseTick, mExpectedTick, mBorrowInTick, mBorrowOutTick, mEnableInt, mResetDone, mEnableReload, mEnableCount, mLinking, mAudShift,
+    mValue, mBackup, mTimerDone, mLastClock, mBorrowIn, mBorrowOut );
 }
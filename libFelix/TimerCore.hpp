@@ -2,10 +2,12 @@
 
 #include "ActionQueue.hpp"
 
+class StateStream;
+
 class TimerCore
 {
 public:
-  TimerCore( int number, std::function<void( uint64_t, bool )> trigger );
+  TimerCore( int number );
 
   SequencedAction setBackup( uint64_t tick, uint8_t );
   SequencedAction setControlA( uint64_t tick, uint8_t );
@@ -16,12 +18,76 @@ public:
   uint8_t getControlA( uint64_t tick );
   uint8_t getCount( uint64_t tick );
   uint8_t getControlB( uint64_t tick );
+  //ticks between reloads when counting on its own, 0 if stopped, linked or one shot
+  uint64_t period() const;
+  //counts borrows of the previous timer instead of ticks
+  bool linked() const
+  {
+    return mEnableCount && mLinking;
+  }
+
+  bool interrupt() const
+  {
+    return mEnableInt;
+  }
+
+  //Both return true if the timer has underflowed. Its effects are up to Mikey, followed by reload.
+  bool fire( uint64_t tick )
+  {
+    if ( tick != mExpectedTick )
+      return false;
+
+    mBorrowOutTick = tick;
+    return true;
+  }
+
+  bool borrowIn( uint64_t tick )
+  {
+    if ( !linked() )
+      return false;
+
+    mBorrowInTick = tick;
 
-  SequencedAction fireAction( uint64_t tick );
-  void borrowIn( uint64_t tick );
+    if ( mValue > 0 )
+    {
+      mValue -= 1;
+      return false;
+    }
+
+    mBorrowOutTick = tick;
+    return true;
+  }
+
+  //starts the next count after an underflow
+  void reload( uint64_t tick )
+  {
+    mBaseTick = tick;
+    if ( mEnableReload )
+    {
+      mValue = mBackup;
+    }
+  }
+
+  //next fire, none if the timer doesn't count ticks
+  SequencedAction computeAction()
+  {
+    if ( !mEnableCount || mLinking )
+    {
+      mExpectedTick = 0;
+      return {};
+    }
+
+    mExpectedTick = mBaseTick + ( 1ull + mValue ) * ( 1ull << mAudShift ) * 16;
+
+    return { (Action)( (int)Action::FIRE_TIMER0 + mNumber ), mExpectedTick };
+  }
+  //Timer whose fires were not scheduled since the last one. Accounts for the fires before tick and returns the next one
+  SequencedAction resume( uint64_t tick );
+
+  void serialize( StateStream & stream );
 
 private:
-  SequencedAction computeAction();
+
   void updateValue( uint64_t tick );
 
 private:
@@ -47,7 +113,6 @@ private:
   uint64_t mExpectedTick;
   uint64_t mBorrowInTick;
   uint64_t mBorrowOutTick;
-  std::function<void( uint64_t, bool )> mTrigger;
 
   int mNumber;
 
@@ -0,0 +1,125 @@
+#include "TraceRecorder.hpp"
+
+TraceRecord TraceRecord::make( uint64_t tick, CPUState const& before, CPUState const& after )
+{
+  TraceRecord result{};
+  result.tick = tick;
+  result.pc = before.pc;
+  result.a = before.a;
+  result.x = before.x;
+  result.y = before.y;
+  result.s = before.sl;
+  result.p = before.getP();
+  result.op = after.op;
+  result.ea = after.ea;
+  result.fa = after.fa;
+  result.t = after.t;
+  result.m1 = after.m1;
+  result.m2 = after.m2;
+  result.interrupt = after.interrupt;
+  return result;
+}
+
+CPUState TraceRecord::before() const
+{
+  CPUState result{};
+  result.setP( p );
+  result.padding = ' ';
+  result.pc = pc;
+  result.a = a;
+  result.x = x;
+  result.y = y;
+  result.sh = 0x01;
+  result.sl = s;
+  return result;
+}
+
+CPUState TraceRecord::after() const
+{
+  CPUState result{};
+  result.op = op;
+  result.ea = ea;
+  result.fa = fa;
+  result.t = t;
+  result.m1 = m1;
+  result.m2 = m2;
+  result.interrupt = interrupt;
+  return result;
+}
+
+TraceRecorder::TraceRecorder( std::filesystem::path const& path, uint64_t const& tick ) : mOut{ path, std::ios::binary }, mTickSource{ tick }, mTick{}, mChunk( CHUNK_RECORDS ),
+  mFill{}, mSubmitted{}, mMutex{}, mCondition{}, mPending{}, mFree{}, mStop{}, mThread{}
+{
+  Header header{ MAGIC, VERSION, (uint32_t)sizeof( TraceRecord ), 0 };
+  mOut.write( (char const*)&header, sizeof header );
+  mThread = std::thread{ [this]
+  {
+    write();
+  } };
+}
+
+TraceRecorder::~TraceRecorder()
+{
+  if ( mFill > 0 )
+  {
+    mChunk.resize( mFill );
+    submit();
+  }
+
+  {
+    std::scoped_lock lock{ mMutex };
+    mStop = true;
+  }
+  mCondition.notify_all();
+  mThread.join();
+}
+
+bool TraceRecorder::good() const
+{
+  return mOut.good();
+}
+
+uint64_t TraceRecorder::records() const
+{
+  return mSubmitted + mFill;
+}
+
+void TraceRecorder::submit()
+{
+  std::unique_lock lock{ mMutex };
+  mCondition.wait( lock, [this] { return mPending.size() < MAX_PENDING_CHUNKS; } );
+  mSubmitted += mChunk.size();
+  mPending.push_back( std::move( mChunk ) );
+  if ( mFree.empty() )
+  {
+    mChunk = std::vector<TraceRecord>( CHUNK_RECORDS );
+  }
+  else
+  {
+    mChunk = std::move( mFree.back() );
+    mFree.pop_back();
+  }
+  mFill = 0;
+  lock.unlock();
+  mCondition.notify_all();
+}
+
+void TraceRecorder::write()
+{
+  std::unique_lock lock{ mMutex };
+  for ( ;; )
+  {
+    mCondition.wait( lock, [this] { return mStop || !mPending.empty(); } );
+    if ( mPending.empty() )
+      return;
+
+    auto chunk = std::move( mPending.front() );
+    mPending.pop_front();
+    lock.unlock();
+    mOut.write( (char const*)chunk.data(), chunk.size() * sizeof( TraceRecord ) );
+    chunk.resize( CHUNK_RECORDS );
+    lock.lock();
+    mFree.push_back( std::move( chunk ) );
+    mCondition.notify_all();
+  }
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "CPUState.hpp"
+
+//Fixed size binary record of one executed instruction, felix-trace renders it as a text trace line
+struct TraceRecord
+{
+  //tick of the opcode fetch
+  uint64_t tick;
+  //registers before the instruction
+  uint16_t pc;
+  uint8_t a;
+  uint8_t x;
+  uint8_t y;
+  uint8_t s;
+  uint8_t p;
+  Opcode op;
+  //addressing state after the instruction
+  uint16_t ea;
+  uint16_t fa;
+  uint16_t t;
+  uint8_t m1;
+  uint8_t m2;
+  uint8_t interrupt;
+  uint8_t padding[7];
+
+  static TraceRecord make( uint64_t tick, CPUState const& before, CPUState const& after );
+  //states as seen by CPU::formatTrace
+  CPUState before() const;
+  CPUState after() const;
+};
+
+static_assert( sizeof( TraceRecord ) == 32 );
+
+//Records are appended to fixed size chunks in memory, full chunks are written out by a background thread.
+//Emulation only waits when the writer falls behind by more than a few chunks.
+class TraceRecorder
+{
+public:
+  static constexpr std::array<char, 4> MAGIC = { 'F', 'X', 'T', 'R' };
+  static constexpr uint32_t VERSION = 1;
+  static constexpr size_t CHUNK_RECORDS = 1 << 16;
+  static constexpr size_t MAX_PENDING_CHUNKS = 16;
+
+  struct Header
+  {
+    std::array<char, 4> magic;
+    uint32_t version;
+    uint32_t recordSize;
+    uint32_t reserved;
+  };
+
+  //tick is read at the beginning of every instruction
+  TraceRecorder( std::filesystem::path const& path, uint64_t const& tick );
+  ~TraceRecorder();
+
+  bool good() const;
+  uint64_t records() const;
+
+  void begin()
+  {
+    mTick = mTickSource;
+  }
+
+  void record( CPUState const& before, CPUState const& after )
+  {
+    mChunk[mFill] = TraceRecord::make( mTick, before, after );
+    if ( ++mFill == CHUNK_RECORDS )
+      submit();
+  }
+
+private:
+  void submit();
+  void write();
+
+private:
+  std::ofstream mOut;
+  uint64_t const& mTickSource;
+  uint64_t mTick;
+  std::vector<TraceRecord> mChunk;
+  size_t mFill;
+  uint64_t mSubmitted;
+
+  std::mutex mMutex;
+  std::condition_variable mCondition;
+  std::deque<std::vector<TraceRecord>> mPending;
+  std::vector<std::vector<TraceRecord>> mFree;
+  bool mStop;
+  std::thread mThread;
+};
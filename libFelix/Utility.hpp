@@ -19,6 +19,8 @@ struct AudioSample
 {
   int16_t left;
   int16_t right;
+
+  friend bool operator==( AudioSample, AudioSample ) = default;
 };
 
 struct Pixel
@@ -63,6 +65,22 @@ enum class CpuBreakType
   TRAP_BREAK
 };
 
+enum class CPUBackend
+{
+  //whole instructions interpreted with direct bus calls
+  INTERPRETER,
+  //coroutine suspended on every bus access and driven by the run loop, kept for debugging
+  COROUTINE
+};
+
+enum class SuzyBackend
+{
+  //sprite engine does its memory accesses right away until something is due in the run loop
+  BATCHED,
+  //sprite engine suspended on every memory access and driven by the run loop, kept as the reference
+  PER_ACCESS
+};
+
 enum class RunMode
 {
   PAUSE,